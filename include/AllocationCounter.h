@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Count of heap allocations made by the calling thread, used to check that hot paths stay
+// allocation-free; background threads (persistence, file watching) do not disturb it.
+// Counting replaces the global operator new and is only compiled in when the build defines
+// MONKEY_TYPER_COUNT_ALLOCATIONS (CMake option of the same name); otherwise the count stays 0.
+namespace AllocationCounter {
+    bool isEnabled();
+    uint64_t getCount();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "HeadlessGame.h"
+#include "TypistBot.h"
+#include "WorkStealingPool.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Plays many bot games per settings configuration on a WorkStealingPool and summarizes their
+// score, survival time and WPM. Each game is one task with its own HeadlessGame, seeded from
+// the batch seed, the configuration and the game's number, so results do not depend on the
+// number of threads or the order games run in (for streamed word sets, only while the scanner's
+// sample stays the same).
+class BatchSimulator {
+public:
+    // Summary of one measure over the games of a configuration.
+    struct Distribution {
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double p10 = 0;
+        double p50 = 0;
+        double p90 = 0;
+        double max = 0;
+    };
+
+    struct ConfigResult {
+        GameSession::Settings settings;
+        size_t games = 0;
+        size_t capped = 0; // Games still running at the time limit (their survival is the limit)
+        Distribution score;
+        Distribution survivalSeconds;
+        Distribution wordsPerMinute;
+    };
+
+    // 'supply' must have words and outlive the simulator (see HeadlessGame::WordSupply).
+    BatchSimulator(const HeadlessGame::WordSupply& supply, const std::string& wordSetName, WorkStealingPool& pool);
+
+    // Plays 'gamesPerConfig' games of every configuration and returns one result per
+    // configuration, in order. Blocks until all games have finished.
+    std::vector<ConfigResult> run(const std::vector<GameSession::Settings>& configs, const TypistBot::Profile& profile,
+                                  size_t gamesPerConfig, uint32_t seed, float maxSeconds);
+
+    uint64_t getSimulatedSteps() const; // Summed over all games of the last run
+    // GameSession::getSteadyStateSpawnAllocations summed over all games of the last run.
+    uint64_t getSteadyStateSpawnAllocations() const;
+
+private:
+    struct GameResult {
+        float score = 0.f;
+        float survivalSeconds = 0.f;
+        float wordsPerMinute = 0.f;
+        uint64_t steps = 0;
+        uint64_t steadyStateSpawnAllocations = 0;
+        bool capped = false;
+    };
+
+    static Distribution summarize(std::vector<float>& values);
+
+    HeadlessGame::WordSupply supply;
+    std::string wordSetName;
+    WorkStealingPool& pool;
+    uint64_t simulatedSteps = 0;
+    uint64_t steadyStateSpawnAllocations = 0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+// Fixed-size fields of the binary files (run log and index, run journal, keystroke log and its
+// analytics cache).
+// Integers and floats are stored in host byte order (little-endian on every supported target).
+
+template <typename T>
+void put(std::vector<unsigned char>& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values are stored as raw bytes");
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// For files written through PersistenceWorker::saveFile, which takes the contents as a string.
+template <typename T>
+void put(std::string& out, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values are stored as raw bytes");
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Returns false if fewer than sizeof(T) bytes are left before 'end'.
+template <typename T>
+bool get(const unsigned char*& cursor, const unsigned char* end, T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only plain values are stored as raw bytes");
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
@@ -12,7 +12,103 @@ namespace GameConstants {
     constexpr float BASE_SPEED = 100.0f;
     constexpr float WORD_SPAWN_INTERVAL = 2.0f;
     constexpr int MISTAKE_PENALTY = 5;
-    constexpr int MAX_HISTORY_POINTS = 1000;
+
+    // Score history (multi-resolution timeline)
+    constexpr float SCORE_SAMPLE_INTERVAL = 0.05f;          // Base bucket width, 20 Hz
+    constexpr size_t SCORE_TIMELINE_LEVELS = 4;             // 0.05 s, 0.5 s, 5 s, then 50 s and coarser buckets
+    constexpr size_t SCORE_TIMELINE_LEVEL_CAPACITY = 1200;  // Buckets per level (one minute at the base rate)
+    constexpr size_t SCORE_TIMELINE_FACTOR = 10;            // Buckets merged when moving to the next level
+
+    // Persistence
+    constexpr int PERSISTENCE_COALESCE_MS = 250; // Saves arriving within this window are written once
+    constexpr size_t RUN_JOURNAL_RING_CAPACITY = 1024; // Checkpoints buffered between journal flushes (power of two)
+    constexpr int RUN_JOURNAL_FLUSH_MS = 100;          // Most of a run a crash can lose
+    constexpr size_t EXPORT_BUFFER_BYTES = 1 << 20;    // Export output is written in chunks of this size
+
+    // Keystroke telemetry
+    constexpr size_t KEYSTROKE_RING_CAPACITY = 4096;  // Records buffered between drains (power of two)
+    constexpr int KEYSTROKE_DRAIN_INTERVAL_MS = 200;
+    constexpr uint32_t KEYSTROKE_PAUSE_MICROS = 2000000;   // Longer gaps are pauses, not key latency
+    constexpr size_t KEYSTROKE_PARALLEL_GRAIN = 32768;      // Records per thread before analytics go parallel
+    constexpr uint32_t STATS_MIN_SAMPLES = 20;              // Fewer timed keys are too noisy to rank
+    constexpr size_t STATS_RANKED_ROWS = 10;
+    constexpr size_t STATS_TREND_RUNS = 20;                 // Runs in the latency trend
+    constexpr size_t STATS_CHART_RUNS = 100;                // Runs in the latency chart
+    constexpr size_t INPUT_LATENCY_MAX_PENDING = 64;        // Keys awaiting their frame (input latency meter)
+    constexpr size_t INPUT_LATENCY_RESERVED_SAMPLES = 16384; // Key latencies kept without reallocating mid-run
+    constexpr uint64_t INPUT_LATENCY_OVERLAY_REFRESH_MICROS = 250000; // F3 overlay percentiles, 4 Hz
+
+    // Typing speed (TypingStatsEngine)
+    constexpr int TYPING_STATS_SLOT_MS = 100;                      // Time resolution of the rolling windows
+    constexpr size_t TYPING_STATS_SLOTS = 1024;                    // Slot ring, longer than the longest window (power of two)
+    constexpr std::array<int, 3> TYPING_STATS_WINDOW_SECONDS = {2, 10, 60}; // Instant, short and long windows
+
+    // Bots and headless games
+    constexpr float HEADLESS_STEP_SECONDS = 1.0f / 60.0f; // Simulated frame of headless games
+    constexpr float SOAK_MAX_GAME_SECONDS = 600.0f;       // Soak games a bot never loses are cut here
+    constexpr float ATTRACT_IDLE_SECONDS = 30.0f;         // Menu idle time before the demo starts
+    constexpr size_t SIM_GAMES_PER_CONFIG = 1000;         // Default batch size of monkey_typer_sim
+
+    // Leaderboard
+    constexpr size_t DEFAULT_LEADERBOARD_CAPACITY = 10;
+    constexpr size_t MAX_LEADERBOARD_CAPACITY = 1000000;
+
+    // Streaming dictionaries (files too large to load into memory)
+    constexpr unsigned long long STREAMING_DICTIONARY_THRESHOLD_BYTES = 64ull * 1024 * 1024;
+    constexpr size_t STREAMING_RESERVOIR_SIZE = 4096;         // Words kept in memory per streamed file
+    constexpr unsigned long long STREAMING_PUBLISH_INTERVAL = 65536; // Words scanned between snapshots
+    constexpr size_t STREAMING_READ_CHUNK_BYTES = 1 << 20;    // Read size of the scanner
+
+    // Dictionary cleaning
+    constexpr unsigned int MAX_FONT_SIZE = 40;
+    constexpr float WIDEST_GLYPH_RATIO = 0.8f; // Glyph advance relative to character size, wide pixel fonts
+    // Longest word that still fits the playfield at the largest font size.
+    constexpr size_t MAX_WORD_LENGTH = static_cast<size_t>(WINDOW_WIDTH / (MAX_FONT_SIZE * WIDEST_GLYPH_RATIO));
+    constexpr size_t WORD_LENGTH_HISTOGRAM_BUCKETS = 16;
+    constexpr int MAX_LINKED_WORD_PARTS = 4;
+
+    // Pseudo-word generation (Markov model trained per dictionary, cached as <name>.markov)
+    constexpr size_t MARKOV_MIN_TRAINING_WORDS = 20; // Smaller sets do not get a generator
+    enum class PseudoWordMode {
+        OFF,
+        EASY,
+        MEDIUM,
+        HARD
+    };
+
+    const std::array<std::string, 4> PSEUDO_WORD_MODE_NAMES = {
+            "Off",
+            "Easy",
+            "Medium",
+            "Hard"
+    };
+
+    // Generated word length range (min, max) per mode.
+    constexpr std::array<std::array<size_t, 2>, 4> PSEUDO_WORD_LENGTHS = {{
+            {0, 0},
+            {3, 5},
+            {5, 8},
+            {8, 12}
+    }};
+
+    // Paragraph mode
+    constexpr float PARAGRAPH_MODE_DURATION = 60.0f;          // Seconds per paragraph session
+    constexpr size_t TEXT_STREAM_CHUNK_BYTES = 64 * 1024;     // Read size of the text streamer
+    constexpr size_t TEXT_STREAM_QUEUE_WORDS = 2048;          // Words buffered ahead of the layout
+    constexpr size_t PARAGRAPH_LAYOUT_BATCH = 64;             // Words taken from the stream per layout step
+    constexpr size_t PARAGRAPH_LOOKAHEAD_LINES = 4;           // Lines laid out below the current one
+    constexpr float PARAGRAPH_MARGIN_X = 150.0f;
+    constexpr float PARAGRAPH_TOP_Y = 200.0f;
+    constexpr float PARAGRAPH_SCROLL_RATE = 10.0f;            // Scroll easing speed (1/s)
+
+    // Free typing
+    constexpr size_t FREE_TYPING_HISTORY = 4 * MAX_WORD_LENGTH; // Typed tail kept for backspace and relinking
+    constexpr size_t FREE_TYPING_COMPACT_SLACK = 256;           // Dead trie nodes tolerated before compaction
+    constexpr size_t FREE_TYPING_DISPLAY_CHARS = 24;            // Typed tail shown on screen
+
+    // Weakness training
+    constexpr double TRAINING_WEIGHT_DECAY = 0.998;     // Per-keystroke decay of recorded mistakes
+    constexpr double TRAINING_DRILL_PROBABILITY = 0.75; // Share of spawns drawn from weak characters/bigrams
 
     // Animation timings
     constexpr float ANIMATION_DURATION = 2.0f;
@@ -41,10 +137,13 @@ namespace GameConstants {
 
     // Game statistics
     struct GameStats {
-        float wordsPerMinute = 0.0f;
-        float accuracy = 100.0f;
+        float wordsPerMinute = 0.0f;    // Net, from correct keys
+        float accuracy = 100.0f;        // Correct keys in percent of all typed keys
         int wordsTyped = 0;
         int charactersTyped = 0;
         int mistakesMade = 0;
+        // Shown when the game ends; not kept in the run archive.
+        float rawWordsPerMinute = 0.0f; // From all typed keys
+        float peakWordsPerMinute = 0.0f;
     };
 }
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// CRC-32 (IEEE 802.3, as used by zip and png) of a byte range.
+uint32_t crc32(const unsigned char* data, size_t size);
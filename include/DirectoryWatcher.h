@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <thread>
+#include <atomic>
+
+// Watches a single directory for files being written, added or removed and reports each
+// changed file name once things settle. Uses inotify on Linux and falls back to polling
+// modification times elsewhere. The callback runs on the watcher's own thread, so it can
+// do slow work (parsing, font loading) without touching the frame.
+class DirectoryWatcher {
+public:
+    using ChangeCallback = std::function<void(const std::string& fileName, bool removed)>;
+
+    DirectoryWatcher(const std::string& directory, ChangeCallback onChange);
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    void start();
+
+private:
+    void run();
+    bool runInotify();
+    void runPolling();
+
+    std::string directory;
+    ChangeCallback onChange;
+    std::thread worker;
+    std::atomic<bool> stopRequested;
+};
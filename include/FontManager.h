@@ -4,10 +4,16 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <vector>
+#include <utility>
+
+class DirectoryWatcher;
 
 class FontManager {
 public:
     FontManager();
+    ~FontManager();
 
     // Loads the default font and scans a directory for other fonts.
     void loadFonts(const std::string& defaultFontPath, const std::string& fallbackDefaultFontPath, const std::string& fontsDirectory);
@@ -24,7 +30,31 @@ public:
     // Returns a random font from the available fonts.
     std::shared_ptr<sf::Font> getRandomFont() const;
 
+    // Starts watching the fonts directory; new or changed fonts are loaded on the watcher thread.
+    void startWatching(const std::string& fontsDirectory);
+
+    // Swaps in fonts loaded since the last call without blocking. Returns true if anything changed.
+    bool applyPendingUpdates();
+
+    // Destroys replaced fonts nothing else holds, with their glyph metrics. Call only when no
+    // word drawn with an old font is left, e.g. right after a session restarted.
+    void releaseRetiredFonts();
+
 private:
+    // Loads a font from a private copy of the file, so rewriting the file later cannot affect it.
+    static std::shared_ptr<sf::Font> loadFontCopy(const std::string& path);
+    void onFontFileChanged(const std::string& fileName, bool removed);
+
     std::shared_ptr<sf::Font> defaultFont;
     std::unordered_map<std::string, std::shared_ptr<sf::Font>> availableFonts;
+    std::string defaultFontName;
+
+    // sf::Text keeps a raw font pointer, so replaced fonts are kept alive for anything still drawing
+    // them until releaseRetiredFonts().
+    std::vector<std::shared_ptr<sf::Font>> retiredFonts;
+
+    std::string watchedDirectory;
+    std::mutex pendingMutex;
+    std::vector<std::pair<std::string, std::shared_ptr<sf::Font>>> pendingUpdates; // null font = removed
+    std::unique_ptr<DirectoryWatcher> watcher; // Declared last so it stops before the state it feeds is destroyed
 };
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+#include "SFML/Graphics.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <cstdint>
+#include "Constants.h"
+#include "Word.h"
+#include "WordPool.h"
+#include "ScoreTimeline.h"
+#include "TypingStatsEngine.h"
+
+class ParagraphView;
+class WordMatcher;
+
+// The rules and state of one game: spawning, moving, targeting and completing words, the score
+// and the stats. It knows nothing about windows, rendering or saving, so the windowed game, the
+// attract mode demo and headless runs (HeadlessGame) all play the same code. Keys come in as the
+// characters of TextEntered events.
+// A session is reused from game to game, so its word pool stays warm. Sessions are independent:
+// several may run on different threads if their sources are thread-safe.
+class GameSession {
+public:
+    // Gameplay settings, fixed for the length of a game.
+    struct Settings {
+        float wordSpeedMultiplier = 1.0f;
+        float spawnRateMultiplier = 1.0f;
+        bool linkedWords = false;
+        bool freeTyping = false;
+        bool highlightTyping = false;
+        unsigned int fontSize = GameConstants::DEFAULT_FONT_SIZE;
+    };
+
+    // Where spawned words come from. Both are called with the session's random generator.
+    struct Sources {
+        std::function<const std::string&(std::mt19937&)> pickWord; // Valid until the next call
+        std::function<const sf::Font&(std::mt19937&)> pickFont; // Must outlive the words using it
+    };
+
+    // A key the session has applied, for telemetry and weakness training.
+    struct KeyOutcome {
+        char typed = 0;        // 8 for backspace
+        char expected = 0;     // See TypedKey
+        char previous = 0;
+        bool mistake = false;
+        uint32_t wordId = 0;   // Word the key went to (0 if none)
+        uint8_t flags = 0;     // KeystrokeRecord flags
+        const std::string* targetText = nullptr; // Text of the word before the key, if it had one
+        uint64_t micros = 0;
+    };
+    using KeyListener = std::function<void(const KeyOutcome&)>;
+
+    GameSession(Sources sources, uint32_t seed);
+    ~GameSession();
+
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    void setKeyListener(KeyListener listener);
+
+    // Starts a new game at 'startMicros' (steady clock, or any clock the keys share). With a
+    // paragraph view the player types its text instead of flying words.
+    void start(const Settings& settings, uint64_t startMicros, std::unique_ptr<ParagraphView> paragraph = nullptr);
+    // Advances by one frame that ends at 'nowMicros'. Returns false once the game is over.
+    bool update(float deltaTime, uint64_t nowMicros);
+    // A TextEntered character typed at 'micros'; other characters than printable ASCII and
+    // backspace are ignored.
+    void processText(sf::Uint32 unicode, uint64_t micros);
+    // Esc: drops the word being typed (free typing: the typed stream).
+    void cancelTyping();
+
+    bool isOver() const;
+    bool isFreeTyping() const;
+
+    const std::vector<PooledWord>& getActiveWords() const;
+    const ParagraphView* getParagraphView() const;
+    const std::string& getFreeTypingInput() const; // Recent free-typing stream
+    const Settings& getSettings() const;
+
+    int getScore() const;
+    float getGameTime() const;
+    const GameConstants::GameStats& getGameStats() const;
+    const ScoreTimeline& getScoreTimeline() const;
+    const TypingStatsEngine& getTypingStats() const;
+
+    size_t getSpawnCount() const;
+    uint64_t getSpawnAllocations() const; // Heap allocations inside spawnWord (with MONKEY_TYPER_COUNT_ALLOCATIONS)
+    // Of those, the ones in spawns served from the word pool; anything but 0 is a regression.
+    uint64_t getSteadyStateSpawnAllocations() const;
+    const WordPool& getWordPool() const;
+
+private:
+    void spawnWord();
+    void updateParagraph(float deltaTime, int completedThisFrame);
+    void syncWordMatcher();
+    void processFreeTypingKey(char typed, uint64_t micros);
+    void recordTypedKey(const Word& word, const std::string& targetText, char typed, uint64_t micros);
+    void reportKey(const KeyOutcome& outcome);
+    void finish(uint64_t nowMicros);
+    void refreshTypingStats(uint64_t nowMicros);
+
+    Sources sources;
+    std::mt19937 randomGen;
+    KeyListener keyListener;
+    Settings settings;
+
+    std::unique_ptr<ParagraphView> paragraphView; // Non-null while a paragraph-mode game runs
+    std::unique_ptr<WordMatcher> wordMatcher;     // Matcher over active word texts for free typing
+
+    // Text each active word is registered under in wordMatcher, refreshed once per frame.
+    struct MatcherEntry {
+        std::string text;
+        uint32_t seenStamp = 0;
+    };
+    std::unordered_map<const Word*, MatcherEntry> matcherEntries;
+    uint32_t matcherSyncStamp = 0;
+
+    WordPool wordPool; // Declared before activeWords so it outlives the words it recycles
+    std::vector<PooledWord> activeWords;
+    // Scratch buffers reused by every linked-word spawn. Parts a spawn does not need are parked
+    // in spareSpawnParts rather than destroyed, so every part string keeps its capacity.
+    std::vector<std::string> spawnPartTexts;
+    std::vector<std::string> spareSpawnParts;
+    std::vector<float> spawnPartYs;
+    std::vector<Word*> keyCandidates; // Words a first keystroke may start, reused per key
+    size_t spawnCount = 0;
+    uint32_t nextWordId = 0; // Ids given to spawned words this game, for keystroke telemetry
+    uint64_t spawnAllocations = 0;
+    uint64_t steadyStateSpawnAllocations = 0;
+
+    bool over = true;
+    int score = 0;
+    float gameTime = 0.f;
+    float wordSpawnTimer = 0.f;
+    ScoreTimeline scoreTimeline;
+    GameConstants::GameStats gameStats;
+    TypingStatsEngine typingStats;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string_view>
+#include <array>
+#include <vector>
+
+// Horizontal metrics of the printable ASCII range for one (font, character size) pair.
+// Widths are computed arithmetically from cached glyph advances and kerning, matching
+// what sf::Text would lay out, so measuring text never builds text geometry.
+class GlyphMetrics {
+public:
+    GlyphMetrics(const sf::Font& font, unsigned int characterSize);
+
+    // Shared table for a font and size, built on first use. Thread-safe; tables built from a
+    // loaded font need the thread to be allowed to render glyphs (the main thread).
+    static const GlyphMetrics& get(const sf::Font& font, unsigned int characterSize);
+    // Registers fixed-pitch metrics for 'font' so get() never asks it for glyphs. For the
+    // placeholder font of headless games, which have no graphics context to render glyphs in.
+    static void registerMonospace(const sf::Font& font, unsigned int characterSize);
+    // Drops every table of 'font' before it is destroyed, so a later font at the same address
+    // cannot inherit them. Nothing may still use those tables.
+    static void forget(const sf::Font& font);
+
+    // Pen advance across 'text', i.e. the x offset just after its last character.
+    float measure(std::string_view text) const;
+    float advance(char c) const;
+    float kerning(char first, char second) const;
+    float getLineSpacing() const;
+
+    // Vertical extent of text relative to its position, taken over all printable characters
+    // so every word of a font/size shares one box (what getLocalBounds reports, give or take
+    // the glyphs a particular word happens to contain).
+    float getTextTop() const;
+    float getTextHeight() const;
+
+private:
+    explicit GlyphMetrics(unsigned int characterSize); // Monospace
+
+    static constexpr int FIRST_CHAR = 32;
+    static constexpr int CHAR_COUNT = 126 - FIRST_CHAR + 1;
+    static int slot(char c);
+
+    std::array<float, CHAR_COUNT> advances{};
+    std::vector<float> kerningPairs; // CHAR_COUNT x CHAR_COUNT, row = first character
+    float lineSpacing;
+    float textTop;
+    float textHeight;
+};
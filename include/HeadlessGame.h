@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GameSession.h"
+#include "TypistBot.h"
+#include "RunLog.h"
+#include "WordDatabaseManager.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+
+// A GameSession played by a TypistBot without a window, on a simulated clock with fixed
+// HEADLESS_STEP_SECONDS frames, as fast as the CPU allows. Words use a placeholder font with
+// monospace metrics (GlyphMetrics::registerMonospace), so no glyph is ever rendered and no
+// graphics context is needed. Games are reproducible from the seed.
+// Each instance is independent and may run on its own thread.
+class HeadlessGame {
+public:
+    // Wall-clock cost of the simulated frames (event dispatch and session update).
+    struct StepTimings {
+        uint64_t steps = 0;
+        uint64_t totalNanos = 0;
+        uint64_t maxNanos = 0;
+    };
+
+    // Where words are drawn from: an in-memory word list or the sample of a streamed set. Both
+    // must outlive the games using them.
+    struct WordSupply {
+        const std::vector<std::string>* words = nullptr;
+        const StreamingWordSource* stream = nullptr;
+
+        // Resolves set 'setIndex' of 'wordDb', waiting for the first sample of a streamed set.
+        // Prints an error and returns false if the set has no words to draw.
+        static bool forWordSet(const WordDatabaseManager& wordDb, size_t setIndex, WordSupply& out);
+
+        bool draw(std::mt19937& randomGen, std::string& out) const;
+    };
+
+    // 'supply' must have words (see WordSupply::forWordSet). Streamed sets draw from the scanner's
+    // latest sample, so their games are only reproducible while that sample stays the same.
+    // 'wordSetName' is stored in the runs' configuration.
+    HeadlessGame(const WordSupply& supply, const std::string& wordSetName, uint32_t seed);
+
+    // Plays one game until it is lost or 'maxSeconds' of game time have passed, and returns it
+    // as a run (finished now, without input latency). Paragraph mode needs a text stream and is
+    // not simulated; free typing and linked words are.
+    RunRecord play(const GameSession::Settings& settings, const TypistBot::Profile& profile, float maxSeconds);
+
+    const GameSession& getSession() const;
+    const StepTimings& getStepTimings() const; // Summed over all games played
+
+private:
+    static const sf::Font& placeholderFont();
+
+    std::string wordSetName;
+    std::mt19937 seedGen; // Seeds the bot of each game
+    GameSession session;
+    StepTimings timings;
+};
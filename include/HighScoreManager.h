@@ -3,36 +3,58 @@
 #include <string>
 #include <vector>
 #include <deque> // For ScorePoint history
+#include <memory>
 #include <algorithm> // For std::sort
+#include "RunLog.h" // ScorePoint, RunRecord
+#include "LeaderboardStore.h"
+#include "Constants.h"
 
-// ScorePoint struct to store score at a specific time
-struct ScorePoint {
-    float timeStamp;
-    int score;
-};
+class PersistenceWorker;
 
 class HighScoreManager {
 public:
-    HighScoreManager();
+    // Log writes are committed on 'persistence', which must outlive this manager.
+    explicit HighScoreManager(PersistenceWorker& persistence, size_t capacity = GameConstants::DEFAULT_LEADERBOARD_CAPACITY);
+    ~HighScoreManager(); // Waits for pending log writes
+
+    // Opens the run log and builds the leaderboards from its index. If the log has no runs yet,
+    // entries from the legacy text file are imported once.
+    void loadHighScores(const std::string& logPath, const std::string& indexPath, const std::string& legacyTextPath);
 
-    // Loads high scores from a file.
-    void loadHighScores(const std::string& filePath);
+    // Appends a finished run to the log; the write happens on the persistence worker.
+    // Returns its id for addHighScore, 0 if not saved.
+    uint64_t recordRun(const RunRecord& run);
+    // True if the run log already holds a run with this start time and configuration.
+    bool isRunRecorded(int64_t startedAt, const RunConfig& config);
 
-    // Saves current high scores to a file.
-    void saveHighScores(const std::string& filePath);
+    // Names a recorded run and ranks it on its configuration's leaderboard and the overall one.
+    // Returns the rank within its configuration or Leaderboard::NOT_RANKED.
+    size_t addHighScore(uint64_t runId, const std::string& name, int score, const RunConfig& config);
 
-    // Adds a new high score, sorts, and trims the list.
-    void addHighScore(const std::string& name, int score, const std::deque<ScorePoint>& currentScoreHistory);
+    // True if a run with this score and configuration would make a leaderboard.
+    bool qualifies(const RunConfig& config, int score) const;
 
-    // Returns the list of high scores (name, score pairs).
-    const std::vector<std::pair<std::string, int>>& getHighScores() const;
+    // Partition 0 (LeaderboardStore::OVERALL) ranks all configurations together.
+    size_t getPartitionCount() const;
+    const std::string& getPartitionLabel(size_t partition) const;
+    // Partition of a configuration, LeaderboardStore::NO_PARTITION if it has no ranked runs.
+    size_t findPartition(const RunConfig& config) const;
 
-    // Returns the score history for a specific high score entry.
-    const std::vector<ScorePoint>& getScoreHistory(size_t index) const;
+    size_t getHighScoreCount(size_t partition) const;
+    // Entry at a 0-based rank; rank must be < getHighScoreCount(partition).
+    const Leaderboard::Entry& getHighScore(size_t partition, size_t rank) const;
 
+    // Returns the score history for the entry at a rank, read from the run log on first use.
+    const std::vector<ScorePoint>& getScoreHistory(size_t partition, size_t rank) const;
 
-    const size_t MAX_HIGH_SCORES = 10;
 private:
-    std::vector<std::pair<std::string, int>> highScores;
-    std::vector<std::vector<ScorePoint>> highScoreHistories; // Stores history for each high score
-};
\ No newline at end of file
+    void importLegacyHighScores(const std::string& filePath);
+    void scheduleCommit();
+
+    PersistenceWorker& persistence;
+    std::unique_ptr<RunLog> runLog;
+    LeaderboardStore leaderboards;
+    // Histories live only in the run log; the graph view reads one at a time.
+    mutable uint64_t cachedHistoryRunId = 0;
+    mutable std::vector<ScorePoint> cachedHistory;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Constants.h"
+#include "RunLog.h" // InputLatencySummary
+#include <array>
+#include <vector>
+#include <cstdint>
+
+// Measures how long a typed key takes to reach the screen: from the moment the game takes its
+// event off the window's queue to the return of window.display() for the first frame drawn
+// after it. Game thread only; all times are steady clock microseconds (nowMicros()).
+// Every latency of the run is kept, so the percentiles are exact rather than bucketed: a frame
+// is only 16.7 ms at 60 Hz, finer than the key latency histograms of KeystrokeAnalytics.
+class InputLatencyMeter {
+public:
+    static uint64_t nowMicros();
+
+    InputLatencyMeter();
+
+    void reset(); // Called when a run starts
+    // A key whose feedback will be drawn in the next frame.
+    void keyDelivered(uint64_t deliveredMicros);
+    // The frame with every key delivered since the last call is now on screen.
+    void framePresented(uint64_t presentedMicros);
+
+    // Recomputed only when keys were measured since the last call.
+    const InputLatencySummary& summarize();
+
+private:
+    float percentileMs(float fraction);
+
+    std::array<uint64_t, GameConstants::INPUT_LATENCY_MAX_PENDING> pending{};
+    size_t pendingCount = 0;
+    std::vector<uint32_t> latencies; // Microseconds, in measurement order
+    std::vector<uint32_t> scratch;   // Partially sorted copy for the percentiles
+    InputLatencySummary summary;
+};
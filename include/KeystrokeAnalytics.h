@@ -0,0 +1,117 @@
+#pragma once
+
+#include "KeystrokeTelemetry.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+class PersistenceWorker;
+
+// Latency distribution and error count of one key, bigram or trigram.
+struct LatencyStats {
+    // 1 ms wide below 8 ms, then four per doubling up to the pause limit.
+    static constexpr size_t BUCKETS = 40;
+
+    uint32_t keys = 0;    // Keys typed
+    uint32_t errors = 0;  // Keys that did not match the target
+    uint32_t samples = 0; // Keys with a latency (the first key of a run and pauses have none)
+    uint64_t latencySumMicros = 0;
+    std::array<uint32_t, BUCKETS> histogram{};
+
+    void addLatency(uint32_t micros);
+    void merge(const LatencyStats& other);
+    float meanMs() const;
+    float percentileMs(float fraction) const; // Interpolated within a histogram bucket
+    float errorRate() const;
+};
+
+// Typing summary of one archived run, for the trend over time.
+struct RunTypingSummary {
+    int64_t startedAt = 0; // Unix time in seconds
+    uint64_t runId = 0;    // Run log id (0 if the run was not saved)
+    uint32_t keys = 0;
+    uint32_t errors = 0;
+    uint32_t samples = 0;
+    uint64_t latencySumMicros = 0;
+
+    float meanMs() const;
+};
+
+// Per-character, per-bigram and per-trigram latency and error statistics over the keystroke log.
+//
+// Aggregates are materialized in a cache file together with the log offset they cover, so a
+// refresh only reads the blocks logged since the previous one. Large backlogs (the first refresh
+// after an upgrade, a deleted cache) are decoded block-parallel into flat columns, aggregated by
+// range on every core into per-thread tables and merged. Bigrams and trigrams are consecutive
+// target characters typed within one word; latencies are the time since the previous key.
+class KeystrokeAnalytics {
+public:
+    struct Ranked {
+        std::string keys;
+        LatencyStats stats;
+    };
+
+    KeystrokeAnalytics(const std::string& logPath, const std::string& cachePath);
+
+    // Folds keystrokes logged since the last refresh into the aggregates and, if anything
+    // changed, saves them through 'worker'. Returns the number of records read.
+    size_t refresh(PersistenceWorker& worker);
+
+    const LatencyStats& getOverall() const;
+    const LatencyStats& getCharacter(char c) const;
+    const LatencyStats& getBigram(char first, char second) const;
+    const std::vector<RunTypingSummary>& getRuns() const;
+    // Change of the mean latency per run over the last 'runCount' runs (least squares), in ms.
+    // Negative means getting faster.
+    float getTrendMsPerRun(size_t runCount) const;
+    // Slowest characters (length 1), bigrams (2) or trigrams (3) by median latency, among those
+    // with at least 'minSamples' latency samples.
+    void rankSlowest(size_t length, size_t count, uint32_t minSamples, std::vector<Ranked>& out) const;
+
+private:
+    static constexpr size_t CHARACTERS = 95; // Printable ASCII
+
+    struct Tables {
+        LatencyStats overall;
+        std::vector<LatencyStats> characters;
+        std::vector<LatencyStats> bigrams;
+        std::unordered_map<uint32_t, LatencyStats> trigrams; // Sparse: most never occur
+
+        Tables();
+        void merge(const Tables& other);
+    };
+
+    // New records in column form, preceded by the two records before them (for n-gram context).
+    struct Columns {
+        std::vector<uint8_t> kind;
+        std::vector<uint8_t> flags;
+        std::vector<uint8_t> expected;
+        std::vector<uint32_t> latency;
+        std::vector<uint64_t> value;
+
+        void resize(size_t size);
+    };
+
+    static constexpr size_t CONTEXT_RECORDS = 2;
+
+    bool loadCache();
+    std::string serializeCache() const;
+    void reset();
+    void aggregateRange(size_t first, size_t last, Tables& tables) const;
+    void foldRuns(size_t rowEnd);
+
+    std::string logPath;
+    std::string cachePath;
+    bool cacheLoaded = false;
+
+    Tables totals;
+    std::vector<RunTypingSummary> runs;
+    RunTypingSummary openRun; // Run started but not yet ended at the covered offset
+    bool runOpen = false;
+    uint64_t coveredOffset = 0;  // Log bytes folded into the aggregates
+    uint32_t logIdentity = 0;    // CRC-32 of the log's first block header; detects a replaced log
+    std::array<KeystrokeRecord, CONTEXT_RECORDS> context{}; // Last records folded in
+    Columns columns; // Reused between small refreshes
+};
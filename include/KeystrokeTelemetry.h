@@ -0,0 +1,120 @@
+#pragma once
+
+#include "SpscRing.h"
+#include "Constants.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+
+// One entry of the keystroke log: a typed key, or the start or end of a run.
+struct KeystrokeRecord {
+    enum Kind : uint8_t {
+        KEY,
+        RUN_START, // value: Unix time in seconds
+        RUN_END    // value: run log id of the finished run (0 if it was not saved)
+    };
+    static constexpr uint8_t CORRECT = 1;     // The key matched the character the target wanted
+    static constexpr uint8_t BACKSPACE = 2;
+    static constexpr uint8_t UNTARGETED = 4;  // No word starts with the key
+    static constexpr uint8_t FREE_TYPING = 8; // CORRECT then means the key completed a word
+
+    uint64_t timeMicros = 0;       // Steady clock; only differences are meaningful
+    uint64_t value = 0;            // KEY: id of the target word (0 if none), see Kind otherwise
+    uint32_t sincePreviousMicros = 0; // Since the previous key of the same run (0 for the first)
+    Kind kind = KEY;
+    uint8_t flags = 0;
+    char character = 0;            // Typed character (8 for backspace)
+    char expected = 0;             // Character the target wanted (0 if nothing was appended)
+};
+
+// Records every keystroke of a game for later analysis.
+// The game thread pushes records into a preallocated SpscRing, which is wait-free and never
+// allocates; a background thread drains it every KEYSTROKE_DRAIN_INTERVAL_MS and appends the
+// records to the log file. If the writer falls a whole ring behind, records are dropped and
+// counted rather than stalling input.
+//
+// File format: magic "MTKS", version, then blocks of (payload size, record count, CRC-32 of the
+// payload, base time) followed by the records. Each record is a kind/flags byte, the character,
+// the expected character and varints for the time since the previous record, the time since the
+// previous key and the value. A torn block at the end (crash mid-write) is cut off on the next start.
+class KeystrokeTelemetry {
+public:
+    explicit KeystrokeTelemetry(const std::string& logPath);
+    ~KeystrokeTelemetry(); // Drains what is left, then stops the writer
+
+    KeystrokeTelemetry(const KeystrokeTelemetry&) = delete;
+    KeystrokeTelemetry& operator=(const KeystrokeTelemetry&) = delete;
+
+    // Game thread only.
+    void beginRun();
+    void endRun(uint64_t runId);
+    void recordKey(char character, char expected, uint64_t wordId, uint8_t flags);
+
+    uint64_t getDroppedCount() const;
+
+private:
+    void push(const KeystrokeRecord& record);
+    void runWriter();
+    bool openLog();
+    void writeBlock();
+
+    std::string logPath;
+    SpscRing<KeystrokeRecord, GameConstants::KEYSTROKE_RING_CAPACITY> ring;
+    uint64_t lastKeyMicros = 0; // Game thread
+    bool runHasKeys = false;    // Game thread
+    std::atomic<uint64_t> droppedCount{0};
+
+    std::thread writer;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stopRequested = false;
+
+    // Writer thread only.
+    std::ofstream logOut;
+    std::vector<KeystrokeRecord> pending;
+    std::vector<unsigned char> block;
+};
+
+// Block-level access to the log format, for readers that split the work across blocks.
+namespace KeystrokeLog {
+    constexpr size_t HEADER_SIZE = 8;        // Magic, version
+    constexpr size_t BLOCK_HEADER_SIZE = 20; // Payload size, record count, CRC-32, base time
+
+    struct Block {
+        const unsigned char* payload = nullptr;
+        uint32_t payloadSize = 0;
+        uint32_t recordCount = 0;
+        uint32_t checksum = 0;
+        uint64_t baseMicros = 0;
+    };
+
+    // True if 'data' starts with the header of a log this build can read.
+    bool checkHeader(const unsigned char* data, size_t size);
+    // Parses the block starting at 'at'. Returns false if it does not end before 'end'.
+    bool readBlock(const unsigned char* at, const unsigned char* end, Block& block);
+    bool verifyBlock(const Block& block);
+    // Decodes the record at 'cursor' (inside a verified block). 'timeMicros' starts at the
+    // block's base time and is advanced by each record.
+    bool decodeRecord(const unsigned char*& cursor, const unsigned char* end, uint64_t& timeMicros, KeystrokeRecord& out);
+}
+
+// Reads a keystroke log front to back. Stops at the first damaged block.
+class KeystrokeLogReader {
+public:
+    bool open(const std::string& logPath);
+    bool next(KeystrokeRecord& out);
+
+private:
+    MappedFile file;
+    const unsigned char* cursor = nullptr;
+    const unsigned char* end = nullptr;
+    const unsigned char* blockEnd = nullptr;
+    uint32_t remainingInBlock = 0;
+    uint64_t timeMicros = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+// Bounded top-K ranking of runs, kept in a treap augmented with subtree sizes.
+// Insertion, eviction of the lowest entry, rank lookups and k-th entry access are all
+// O(log n), so capacities in the hundreds of thousands stay cheap. Entries are move-only;
+// score histories are not stored here at all but read from the run log on demand.
+class Leaderboard {
+public:
+    struct Entry {
+        std::string name;
+        int score = 0;
+        uint64_t runId = 0; // Run log id; older runs rank first among equal scores
+
+        Entry() = default;
+        Entry(std::string name, int score, uint64_t runId) : name(std::move(name)), score(score), runId(runId) {}
+        Entry(Entry&&) = default;
+        Entry& operator=(Entry&&) = default;
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+    };
+
+    static constexpr size_t NOT_RANKED = static_cast<size_t>(-1);
+
+    explicit Leaderboard(size_t capacity);
+
+    // Shrinking drops the lowest entries.
+    void setCapacity(size_t newCapacity);
+    size_t getCapacity() const;
+    size_t size() const;
+    void clear();
+
+    // Adds an entry and returns its rank, or NOT_RANKED if the board is full and it ranks last.
+    size_t insert(Entry&& entry);
+    // True if a run finishing now with this score would make the board.
+    bool qualifies(int score) const;
+    // Number of entries a run finishing now with this score would rank below.
+    size_t rankOf(int score) const;
+    // Entry at a 0-based rank; rank must be < size().
+    const Entry& at(size_t rank) const;
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        Entry entry;
+        uint32_t priority;
+        uint32_t left;
+        uint32_t right;
+        uint32_t size;
+    };
+
+    static bool ranksAbove(const Entry& a, const Entry& b);
+    uint32_t sizeOf(uint32_t node) const;
+    void pull(uint32_t node);
+    // Splits into entries ranking above 'key' and the rest.
+    void splitByKey(uint32_t node, const Entry& key, uint32_t& above, uint32_t& rest);
+    // Splits off the first 'count' entries.
+    void splitByCount(uint32_t node, size_t count, uint32_t& first, uint32_t& rest);
+    uint32_t merge(uint32_t a, uint32_t b);
+    void releaseSubtree(uint32_t node);
+
+    size_t capacity;
+    uint32_t root;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    std::mt19937 priorityRandom;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Leaderboard.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Leaderboards partitioned by run configuration (RunConfig::hash()), plus an overall board
+// across all configurations at partition 0. Partitions are created on first use and found
+// by hash in O(1), so switching the displayed board never touches the run log.
+class LeaderboardStore {
+public:
+    static constexpr size_t OVERALL = 0;
+    static constexpr size_t NO_PARTITION = static_cast<size_t>(-1);
+
+    explicit LeaderboardStore(size_t capacity);
+
+    void setCapacity(size_t newCapacity);
+    void clear();
+
+    // Partition for a configuration, created with the given label if new.
+    size_t partitionOf(uint32_t configHash, const std::string& label);
+    // Partition for a configuration or NO_PARTITION if no run with it was ranked yet.
+    size_t findPartition(uint32_t configHash) const;
+
+    // Ranks an entry on its configuration's partition (never OVERALL) and on the overall board.
+    // Returns the rank within the partition.
+    size_t insert(size_t partition, const std::string& name, int score, uint64_t runId);
+    // True if a score would rank on the partition of its configuration or on the overall board.
+    bool qualifies(uint32_t configHash, int score) const;
+
+    size_t getPartitionCount() const;
+    const Leaderboard& getBoard(size_t partition) const;
+    const std::string& getLabel(size_t partition) const;
+
+private:
+    struct Partition {
+        uint32_t configHash;
+        std::string label;
+        Leaderboard board;
+    };
+
+    size_t capacity;
+    std::vector<Partition> partitions;
+    std::unordered_map<uint32_t, size_t> partitionByHash;
+};
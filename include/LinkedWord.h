@@ -8,6 +8,10 @@ public:
                const sf::Vector2f& position, unsigned int fontSize = GameConstants::DEFAULT_FONT_SIZE,
                const std::vector<float>& yPositions = {});
 
+    // Reinitializes a recycled linked word; part strings and sf::Text objects are reused in place.
+    void reset(const std::vector<std::string>& parts, const sf::Font& font, float speed,
+               const sf::Vector2f& position, unsigned int fontSize, const std::vector<float>& partYPositions);
+
     bool isLinked() const override;
     const std::vector<sf::Vector2f>& getLinkPoints() const override;
     void update(float deltaTime) override;
@@ -17,10 +21,12 @@ public:
     bool isOutOfBounds() const override;
     void updateTextColor(bool highlightTyping) override;
     const std::string& getText() const override;
+    sf::FloatRect getTypingBounds() const override;
 
     const std::vector<sf::Text>& getWordTexts() const { return wordTexts; }
     void setCurrentPart(int index);
     int getCurrentPart() const { return currentPartIndex; }
+    size_t getPartCount() const { return words.size(); }
 
 private:
     void updatePositions();
@@ -28,6 +34,7 @@ private:
 
     std::vector<std::string> words;
     std::vector<sf::Text> wordTexts;
+    std::vector<float> partWidths; // Measured once at construction, parallel to words
     std::vector<sf::Vector2f> linkPoints;
     std::vector<float> yPositions;
 
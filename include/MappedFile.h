@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Read-only view of a whole file. Uses mmap where available and falls back to reading
+// the file into memory elsewhere, so callers always see one contiguous byte range.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps 'path', replacing any previous mapping. Returns false if the file cannot be read.
+    bool map(const std::string& path);
+    void unmap();
+
+    const unsigned char* data() const;
+    size_t size() const;
+
+private:
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false;               // True when 'bytes' came from mmap
+    std::vector<unsigned char> buffer; // Fallback storage
+};
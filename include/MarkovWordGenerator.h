@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+// Character n-gram model that produces pronounceable pseudo-words resembling a dictionary.
+// Contexts are the previous ORDER letters (with a boundary symbol before the word start).
+// Only contexts seen in training get a row; each row is a contiguous array of cumulative
+// transition counts, so sampling is one table lookup plus a short scan with no allocation.
+class MarkovWordGenerator {
+public:
+    static constexpr int ORDER = 3;
+    static constexpr int LETTER_COUNT = 26;
+    static constexpr int SYMBOL_COUNT = LETTER_COUNT + 1; // Letters plus the word boundary, stored last
+
+    MarkovWordGenerator();
+
+    // Builds the model from lower-case words; words with characters outside a-z are skipped.
+    // Returns false if there was nothing usable to learn from.
+    bool train(const std::vector<std::string>& words);
+
+    // Persistence. 'sourceStamp' identifies the dictionary contents the model was trained on;
+    // load() fails if the file was written for a different stamp.
+    bool save(const std::string& path, uint64_t sourceStamp) const;
+    bool load(const std::string& path, uint64_t sourceStamp);
+
+    // Writes a word of minLength..maxLength letters into 'out' (not null-terminated) and returns
+    // its length, or 0 if no such word could be produced. 'capacity' must be at least maxLength.
+    size_t generate(std::mt19937& rng, size_t minLength, size_t maxLength, char* out, size_t capacity) const;
+
+    bool isTrained() const;
+
+private:
+    static constexpr size_t STATE_COUNT = [] { size_t n = 1; for (int i = 0; i < ORDER; ++i) n *= SYMBOL_COUNT; return n; }();
+    static constexpr uint16_t NO_ROW = UINT16_MAX;
+    static constexpr int BOUNDARY = LETTER_COUNT;
+    static_assert(STATE_COUNT < NO_ROW, "row indices are stored as uint16_t");
+
+    // Context before the first letter: ORDER boundary symbols.
+    static size_t startState();
+    static size_t nextState(size_t state, int symbol);
+
+    std::vector<uint16_t> rowOfState;  // STATE_COUNT entries, NO_ROW for contexts never seen
+    std::vector<uint32_t> cumulative;  // SYMBOL_COUNT cumulative counts per row
+};
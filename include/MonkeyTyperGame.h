@@ -5,15 +5,27 @@
 #include <memory>
 #include <deque>
 #include <set>
+#include <random>
+#include <unordered_map>
+#include <cstdint>
 #include "Constants.h"
-#include "Word.h"
+#include "RunLog.h" // ScorePoint, RunConfig
+#include "ScoreTimeline.h"
+#include "InputLatencyMeter.h"
+#include "GameSession.h"
 
 class FontManager;
 class WordDatabaseManager;
 class SettingsManager;
 class HighScoreManager;
 class UIManager;
-struct ScorePoint;
+class WeaknessTrainer;
+class ParagraphView;
+class PersistenceWorker;
+class KeystrokeTelemetry;
+class KeystrokeAnalytics;
+class RunJournal;
+class TypistBot;
 
 class MonkeyTyperGame {
 public:
@@ -26,10 +38,13 @@ public:
         FONT_SELECTION,
         FONT_RANDOMIZATION,
         WORD_SET_SELECTION,
-        GRAPH_VIEW
+        GRAPH_VIEW,
+        STATS_VIEW,
+        ATTRACT // Demo game played by a bot after the menu sits idle
     };
 
-    MonkeyTyperGame();
+    // 'profile' selects a settings file (see SettingsManager::profilePath); empty uses the default one.
+    explicit MonkeyTyperGame(const std::string& profile = "");
     ~MonkeyTyperGame();
     void run();
 
@@ -48,9 +63,15 @@ public:
     const GameConstants::GameStats& getGameStats() const;
     float getGameTime() const;
     int getScore() const;
-    const std::deque<ScorePoint>& getScoreHistory() const;
+    const ScoreTimeline& getScoreTimeline() const;
 
     SettingsManager& getSettingsManager() const;
+    PersistenceWorker& getPersistenceWorker() const;
+    KeystrokeAnalytics& getKeystrokeAnalytics() const;
+    // Exports every archived run as CSV and JSON Lines in the background. Returns the output
+    // path without its extension.
+    std::string exportRuns();
+    const std::string& getSettingsPath() const;
 
     bool getHighScoreNamePromptAttemptedFlag() const;
     void setHighScoreNamePromptAttemptedFlag(bool attempted);
@@ -62,28 +83,51 @@ private:
     void render();
 
     void updateGame(float deltaTime);
-    void spawnWord();
+    void updateHud();
+    GameSession::Settings buildSessionSettings() const;
+    const std::string& pickSpawnWordText(std::mt19937& randomGen); // Valid until the next call
+    const sf::Font& pickSpawnFont(std::mt19937& randomGen);
+    void onSessionKey(const GameSession::KeyOutcome& key);
+    RunConfig buildRunConfig() const;
+    void rebuildTrainingIndex();
+    void applyHotReloads();
+    // nullptr if there is no text to stream; the game then falls back to flying words.
+    std::unique_ptr<ParagraphView> createParagraphView(std::mt19937& randomGen);
+    void recoverInterruptedRun();
     void processPlayingEvents(sf::Event& event);
     void renderGame();
+    void startAttract();
+    void updateAttract(float deltaTime);
+    void processAttractEvents(const sf::Event& event);
 
     sf::RenderWindow window;
     GameState gameState;
+    std::string settingsPath;
 
     std::shared_ptr<sf::Font> currentGlobalFont;
 
+    std::unique_ptr<PersistenceWorker> persistenceWorker; // Declared first: drains saves after the other managers are gone
+    std::unique_ptr<RunJournal> runJournal; // Outlives highScoreManager, whose destructor runs the queued journal deletions
     std::unique_ptr<FontManager> fontManager;
     std::unique_ptr<WordDatabaseManager> wordDbManager;
     std::unique_ptr<SettingsManager> settingsManager;
     std::unique_ptr<HighScoreManager> highScoreManager;
     std::unique_ptr<UIManager> uiManager;
+    std::unique_ptr<WeaknessTrainer> weaknessTrainer;
+    std::unique_ptr<KeystrokeTelemetry> keystrokeTelemetry;
+    std::unique_ptr<KeystrokeAnalytics> keystrokeAnalytics; // Folded in when the statistics screen opens
+    std::unique_ptr<GameSession> session; // The game being played (or the last one); reused for every game
+    std::unique_ptr<TypistBot> attractBot; // Plays the demo game; nothing it types is recorded
+    float menuIdleTime = 0.f;              // Time since the last input on the menu
 
-    std::vector<std::unique_ptr<Word>> activeWords;
-    int score;
-    float gameTime;
-    float lastScoreRecordTime;
-    float wordSpawnTimer;
-    std::deque<ScorePoint> scoreHistory;
-    GameConstants::GameStats gameStats;
+    InputLatencyMeter inputLatency;
+    uint64_t eventPolledMicros = 0; // When the event being processed left the window's queue
+    bool showLatencyOverlay = false; // Toggled with F3
+    uint64_t latencyOverlayDueMicros = 0; // Next refresh of the overlay's percentiles; 0 refreshes on the next HUD update
+    uint64_t lastRunId = 0; // Run log id of the last finished game, named on high-score submission
+    uint64_t journalRunId = 0; // RunJournal id of the current (or last) game
+    int64_t runStartedAt = 0;  // Unix time in seconds; journaled and archived with the run
+    RunConfig currentRunConfig; // Settings of the current (or last finished) game; selects its leaderboard
 
     bool newHighScoreEligibleFlag;
     bool highScoreNamePromptAttempted;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+
+class TextStreamSource;
+class GlyphMetrics;
+
+// Scrolling block of text for paragraph mode.
+// Words arriving from a TextStreamSource are laid out into lines as they are needed, using
+// cached glyph advances. Only the previous line and a few lines of lookahead exist at any
+// time; finished lines are dropped from the front and the view scrolls smoothly. Each line keeps
+// its typed and upcoming parts as sf::Text, rebuilt only when the line grows or the typed
+// position moves through it; drawing a frame only repositions them.
+// The word currently being typed is not drawn here: the game types it through a regular Word
+// placed at currentWordPosition().
+class ParagraphView {
+public:
+    ParagraphView(std::unique_ptr<TextStreamSource> source, const sf::Font& font, unsigned int fontSize);
+    ~ParagraphView();
+
+    // Pulls streamed words into the layout and advances the scroll animation.
+    void update(float deltaTime);
+
+    // Text of the word to type next, or nullptr while the stream has not delivered it yet.
+    const std::string* getCurrentWord() const;
+
+    // Moves on to the next word after the current one was typed.
+    void advance();
+
+    sf::Vector2f getCurrentWordPosition() const;
+    const sf::Font& getFont() const { return font; }
+
+    void draw(sf::RenderWindow& window) const;
+
+    bool hasFailed() const;
+
+private:
+    struct PlacedWord {
+        std::string text;
+        float x; // Offset from the left margin
+    };
+    struct Line {
+        std::vector<PlacedWord> words;
+        float width = 0.f;
+        // Drawn as words [0, typedEnd) and [upcomingBegin, words.size()); the word between is
+        // the one being typed. Cached by draw() for the range they were built from.
+        mutable sf::Text typedText;
+        mutable sf::Text upcomingText;
+        mutable size_t typedEnd = 0;
+        mutable size_t upcomingBegin = 0;
+        mutable size_t builtWordCount = 0;
+    };
+
+    void appendLine();
+    void layoutIncomingWords();
+    void stepLineIfFinished();
+    float lineY(size_t lineIndex) const;
+    void refreshLineText(const Line& line, size_t typedEnd, size_t upcomingBegin) const;
+    void setSegmentString(sf::Text& text, const Line& line, size_t first, size_t last) const;
+
+    std::unique_ptr<TextStreamSource> source;
+    const sf::Font& font;
+    unsigned int fontSize;
+    const GlyphMetrics& metrics;
+    float lineWidth;
+
+    std::deque<Line> lines;   // lines[0] may be the finished line kept above the current one
+    size_t currentLine;
+    size_t currentWordInLine;
+    float scrollOffset;       // Pixels still to scroll; eases towards zero
+    std::vector<std::string> incoming; // Reused buffer for words taken from the source
+    mutable std::string joined;        // Reused buffer for rebuilding a line's text
+};
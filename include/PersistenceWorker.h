@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Background thread for everything that touches the disk after startup.
+// Jobs are keyed: a job submitted while another with the same key is still pending replaces
+// it, so bursts of saves collapse into one write. The worker waits a short coalescing window
+// after the first pending job, then runs the pending jobs in submission order. Callers hand
+// over immutable snapshots (captured by value in the job), so nothing is shared with the
+// main thread while the job runs.
+class PersistenceWorker {
+public:
+    PersistenceWorker();
+    ~PersistenceWorker(); // Runs all pending jobs before returning
+
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    // Runs 'job' on the worker, replacing a pending job with the same key.
+    void post(const std::string& key, std::function<void()> job);
+    // Serializes on the worker and replaces 'path' atomically (keyed by path).
+    void saveFile(const std::string& path, std::function<std::string()> serialize);
+    // Blocks until every job submitted so far has run.
+    void flush();
+
+    // Writes to a temporary file next to 'path', syncs it and renames it over 'path', so
+    // readers (and a crash) see either the old or the new contents, never a partial file.
+    static bool writeFileAtomically(const std::string& path, const std::string& contents);
+    // Forces what was written to 'path' so far onto the disk, for files that are appended to
+    // rather than replaced.
+    static bool syncFile(const std::string& path);
+
+private:
+    struct Job {
+        std::string key;
+        std::function<void()> run;
+    };
+
+    void runWorker();
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    std::vector<Job> pending;
+    uint64_t submittedCount = 0; // Jobs accepted, including ones later replaced
+    uint64_t finishedCount = 0;  // Jobs run or replaced
+    bool flushRequested = false;
+    bool stopRequested = false;
+};
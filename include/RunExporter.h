@@ -0,0 +1,64 @@
+#pragma once
+
+#include "RunLog.h"
+#include "KeystrokeTelemetry.h"
+#include <fmt/format.h>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+// Streams every archived run to CSV or JSON Lines for external tools.
+// One row (or line) per run: score, GameStats, the settings it was played with, its name if it
+// was ranked, a typing summary from the keystroke log when one exists, its input latency when it
+// was measured, and its score history.
+// Runs are read one at a time from a read-only snapshot of the run log, and the keystroke log is
+// merged in alongside (both are in run order), so memory stays at one run plus the output buffer
+// and the run index, whatever the size of the archive.
+class RunExporter {
+public:
+    enum class Format {
+        CSV,
+        JSON_LINES
+    };
+
+    // JSON Lines for ".jsonl" and ".json", CSV otherwise.
+    static Format formatForPath(const std::string& path);
+
+    RunExporter(const std::string& logPath, const std::string& indexPath, const std::string& keystrokePath);
+
+    // Writes all runs to 'outPath', replacing it. Returns false if the archive could not be read
+    // or the file could not be written (a partial file is removed).
+    bool exportTo(const std::string& outPath, Format format);
+    size_t getExportedCount() const;
+
+private:
+    // Typing of one run, summed from its keystrokes.
+    struct TypingSummary {
+        uint64_t runId = 0;
+        uint32_t keys = 0;
+        uint32_t correctKeys = 0;
+        uint32_t backspaces = 0;
+        uint32_t intervals = 0; // Keys with a time since the previous key (pauses excluded)
+        uint64_t intervalSumMicros = 0;
+    };
+
+    bool nextTypingSummary(TypingSummary& out);
+    const TypingSummary* findTypingSummary(uint64_t runId);
+    void writeCsvHeader();
+    void writeCsvRun(uint64_t runId, const RunRecord& run, const std::string* name, const TypingSummary* typing);
+    void writeJsonRun(uint64_t runId, const RunRecord& run, const std::string* name, const TypingSummary* typing);
+    bool flushBuffer(bool force);
+
+    std::string logPath;
+    std::string indexPath;
+    std::string keystrokePath;
+    size_t exportedCount = 0;
+
+    KeystrokeLogReader keystrokes;
+    bool keystrokesLeft = false;
+    bool haveSummary = false;
+    TypingSummary summary; // Next run of the keystroke log not yet matched
+
+    std::FILE* out = nullptr;
+    fmt::memory_buffer buffer;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "SpscRing.h"
+#include "Constants.h"
+#include "RunLog.h" // RunRecord, RunConfig
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+
+// Write-ahead journal of the game in progress, so a crash does not lose the run.
+// The game thread only copies checkpoints (time, score, stats) into a preallocated SpscRing; a
+// background thread appends them to the journal file every RUN_JOURNAL_FLUSH_MS. Once the run is
+// in the run archive its journal is deleted, so a journal found at startup belongs to a run that
+// was interrupted (a crash, or the window closed mid-game) and is replayed into a RunRecord.
+//
+// File format: magic "MTRJ", version, a checksummed BEGIN frame (start time and configuration),
+// then blocks of (checkpoint count, CRC-32 of the checkpoints) followed by fixed-size checkpoints.
+// Replay stops at the first damaged block, so a torn write only loses the last flush interval.
+class RunJournal {
+public:
+    explicit RunJournal(const std::string& path);
+    ~RunJournal(); // Writes what is left and keeps the journal of an unfinished run
+
+    RunJournal(const RunJournal&) = delete;
+    RunJournal& operator=(const RunJournal&) = delete;
+
+    // Startup only, before the first begin(). Rebuilds the run an earlier process left unfinished;
+    // returns false if there is none.
+    bool recover(RunRecord& out);
+    // Deletes the journal read by recover(), once its run is archived.
+    void discardRecovered();
+
+    // Game thread only. begin() returns the id end() expects. 'startedAt' (Unix time in seconds)
+    // is journaled and returned by recover(); the archived run stores it too, so recovery can tell
+    // whether the run reached the archive before the crash.
+    uint64_t begin(const RunConfig& config, int64_t startedAt);
+    // Cheap enough for every frame: at most two samples per SCORE_SAMPLE_INTERVAL are copied
+    // into the ring, the rest are skipped.
+    void checkpoint(float gameTime, int score, const GameConstants::GameStats& stats);
+    // Deletes the journal of run 'runId' and any earlier one. Any thread; call it once the run
+    // has been committed to the archive.
+    void end(uint64_t runId);
+
+    uint64_t getDroppedCount() const;
+
+private:
+    struct Checkpoint {
+        uint64_t run = 0;
+        float gameTime = 0.f;
+        int32_t score = 0;
+        GameConstants::GameStats stats;
+    };
+
+    void push(const Checkpoint& checkpoint);
+    void runWriter();
+    void writePending();
+    bool startJournal(uint64_t run);
+    void appendBlock(size_t first, size_t last);
+    void closeJournal();
+
+    std::string path;
+    SpscRing<Checkpoint, GameConstants::RUN_JOURNAL_RING_CAPACITY> ring;
+    std::atomic<uint64_t> droppedCount{0};
+
+    // Game thread only.
+    uint64_t currentRun = 0;
+    bool runHasCheckpoint = false;
+    float bucketStartTime = 0.f; // First sample of the current score bucket
+    Checkpoint held;             // Latest sample since then, journaled when the bucket closes
+    bool holding = false;
+
+    std::mutex startMutex; // Guards the start of the newest run, read by the writer
+    uint64_t startedRun = 0;
+    int64_t startedAt = 0;
+    RunConfig startedConfig;
+    std::atomic<uint64_t> endedRun{0};
+
+    std::thread writer;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stopRequested = false;
+
+    // Writer thread only.
+    std::ofstream journalOut;
+    uint64_t fileRun = 0;   // Run the open journal belongs to
+    uint64_t failedRun = 0; // Run whose journal could not be created; not retried
+    std::vector<Checkpoint> pending;
+    std::vector<unsigned char> block;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Constants.h"
+#include "MappedFile.h"
+#include "ScoreHistoryCodec.h" // ScorePoint
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+// Settings a run was played with. Runs are only comparable within one configuration,
+// so the leaderboard is partitioned by this key.
+struct RunConfig {
+    static constexpr uint8_t LINKED_WORDS = 1;
+    static constexpr uint8_t PARAGRAPH_MODE = 2;
+    static constexpr uint8_t FREE_TYPING = 4;
+    static constexpr uint8_t WEAKNESS_TRAINING = 8;
+
+    uint16_t wordSpeedPercent = 100;
+    uint16_t spawnRatePercent = 100;
+    uint8_t flags = 0;
+    uint8_t pseudoWordMode = 0;
+    std::string wordSet; // Set name, sets joined by '+' when randomized; empty for runs logged before configs
+
+    uint32_t hash() const; // Stable across runs; stored in the index
+    std::string label() const;
+};
+
+// Keypress-to-screen latency of a run (see InputLatencyMeter). Runs logged before it was
+// measured have no samples.
+struct InputLatencySummary {
+    uint32_t samples = 0;
+    float p50Ms = 0.f;
+    float p95Ms = 0.f;
+    float p99Ms = 0.f;
+};
+
+// One finished game as stored in the run log.
+struct RunRecord {
+    int64_t finishedAt = 0; // Unix time in seconds
+    int64_t startedAt = 0;  // Unix time in seconds as journaled; 0 if unknown (older runs, simulations)
+    int32_t score = 0;
+    float gameTime = 0.f;
+    GameConstants::GameStats stats;
+    std::vector<ScorePoint> history;
+    RunConfig config;
+    InputLatencySummary inputLatency;
+};
+
+// Append-only archive of every completed run.
+//
+// runs.log holds checksummed records: RUN (stats, configuration, input latency, start time and a
+// ScoreHistoryCodec-packed score history; older logs may also hold runs without start time or
+// latency, or with raw 8-byte points) and NAME (a player name
+// claiming an earlier run). Records are never rewritten, so saving a run is a single append.
+// appendRun and nameRun only stage records in memory (ids are assigned immediately); commit()
+// writes everything staged and may run on another thread.
+// runs.idx is a compact fixed-size entry per run (log offset, name record offset, score,
+// configuration hash) used to build the leaderboards without touching the log; it is derived
+// data and is rebuilt from the log when missing, stale or from an older index version. A torn
+// record at the end of the log (crash mid-append) is detected by its checksum and cut off on
+// the next open.
+class RunLog {
+public:
+    struct IndexEntry {
+        uint64_t runOffset;  // Also the run's id
+        uint64_t nameOffset; // NAME record for this run, 0 if unnamed
+        int32_t score;
+        uint32_t configHash; // RunConfig::hash() of the run
+    };
+
+    RunLog(const std::string& logPath, const std::string& indexPath);
+
+    // Opens both files, creating them if needed and repairing the index. Returns false if the
+    // log exists but is not a run log (it is then left untouched).
+    bool open();
+    // Opens a snapshot for reading only: nothing is created, repaired or appended, and a stale
+    // index is completed in memory. Used to read the log from another thread or process.
+    bool openReadOnly();
+
+    // Stages a run and returns its id (0 if the log is not writable).
+    uint64_t appendRun(const RunRecord& run);
+    // Stages a NAME record for a run logged earlier.
+    bool nameRun(uint64_t runId, const std::string& name);
+    // Writes staged records to the log and the index and syncs the log to disk. Safe to call
+    // concurrently with staging.
+    bool commit();
+    // True if a committed run started at 'startedAt' with this configuration. Checks the most
+    // recent runs only, back to the first one that finished before that time.
+    bool containsRun(int64_t startedAt, const RunConfig& config);
+
+    // Index entries in log order.
+    const std::vector<IndexEntry>& getEntries() const;
+    // Reads a committed run; staged runs are not readable until commit() finishes.
+    bool readRun(uint64_t runId, RunRecord& out);
+    // Sets up 'decoder' to stream a committed run's history straight from the mapped log, relying
+    // on the per-block checksums instead of checking the whole record. The decoder is valid until
+    // the next read of a run committed after the last mapping (which remaps the log).
+    bool openHistory(uint64_t runId, ScoreHistoryCodec::Decoder& decoder);
+    bool readName(uint64_t nameOffset, std::string& out);
+
+private:
+    bool loadIndex();
+    uint64_t scanLog(uint64_t from);
+    bool writeIndexFile();
+    // Adds a record to the staging buffer and returns its offset.
+    uint64_t stageRecord(uint32_t type, const std::vector<unsigned char>& payload);
+    void writeCoveredBytes(uint64_t covered);
+    // Returns the payload of the record at 'offset' if it is intact, along with its type.
+    const unsigned char* recordPayload(uint64_t offset, uint32_t& type, uint32_t& payloadSize, bool verify = true);
+    IndexEntry* findEntry(uint64_t runId);
+
+    std::string logPath;
+    std::string indexPath;
+    std::vector<IndexEntry> entries;
+    uint64_t logSize;      // Including staged records
+    uint64_t coveredBytes; // Log prefix reflected in the index file
+    std::atomic<uint64_t> committedBytes; // Log prefix fully written and flushed; readers stay below it
+    std::ofstream logOut;  // Log and index streams are only used by open() and commit()
+    std::fstream indexFile;
+    std::atomic<bool> writable;
+    MappedFile logMap;
+    std::vector<unsigned char> scratch;
+
+    std::mutex stageMutex; // Guards the staged data, entries and logSize against commit()
+    std::vector<unsigned char> stagedLog;
+    std::vector<size_t> stagedIndexSlots; // Entries whose index slot must be (re)written
+    std::vector<unsigned char> commitBuffer;
+};
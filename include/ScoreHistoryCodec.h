@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// ScorePoint struct to store score at a specific time
+struct ScorePoint {
+    float timeStamp;
+    int score;
+};
+
+// Compact binary encoding of a run's score history, as stored in the run log.
+//
+// Points are grouped into blocks of up to 256. A block header holds the point count, the size
+// of the encoded points and their CRC-32. Each point is then two zigzag varints: the timestamp
+// (whole milliseconds) as a delta of the previous delta, and the score as a delta of the
+// previous score. Deltas restart at every block, so a damaged block never spoils the others.
+// Steady sampling makes most points two bytes instead of eight.
+namespace ScoreHistoryCodec {
+    // Appends the encoded blocks for 'points' to 'out'.
+    void encode(const std::vector<ScorePoint>& points, std::vector<unsigned char>& out);
+
+    // Streams points out of encoded blocks (or out of the raw 8-byte points of older records)
+    // without allocating. Reads the bytes in place; they must outlive the decoder.
+    class Decoder {
+    public:
+        Decoder() = default;
+        static Decoder packed(const unsigned char* data, size_t size);
+        static Decoder raw(const unsigned char* data, uint32_t pointCount);
+
+        // Produces the next point. Returns false at the end or on a damaged block (see failed()).
+        bool next(ScorePoint& point);
+        bool failed() const { return damaged; }
+
+    private:
+        bool startBlock();
+
+        const unsigned char* cursor = nullptr;
+        const unsigned char* end = nullptr;
+        const unsigned char* blockEnd = nullptr;
+        uint32_t remainingRaw = 0;   // Points left in a raw history
+        uint32_t remainingBlock = 0; // Points left in the current block
+        bool isRaw = false;
+        bool damaged = false;
+        int64_t timeMillis = 0;
+        int64_t timeDelta = 0;
+        int64_t score = 0;
+    };
+}
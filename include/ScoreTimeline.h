@@ -0,0 +1,68 @@
+#pragma once
+
+#include "RunLog.h" // ScorePoint
+#include "Constants.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Aggregate of the score over a time span.
+struct ScoreBucket {
+    float startTime = 0.f;
+    float endTime = 0.f;
+    int minScore = 0;
+    int maxScore = 0;
+    int lastScore = 0;
+    uint32_t count = 0;
+    double scoreSum = 0.0;
+
+    float averageScore() const { return count ? static_cast<float>(scoreSum / count) : static_cast<float>(lastScore); }
+};
+
+// Fixed-memory, multi-resolution score history of one run.
+// Samples (any rate) are folded into base buckets of SCORE_SAMPLE_INTERVAL seconds. Each level is
+// a ring of SCORE_TIMELINE_LEVEL_CAPACITY buckets; when one fills up, its oldest
+// SCORE_TIMELINE_FACTOR buckets merge into one bucket of the next, coarser level. The last level
+// halves itself by merging neighbours, so a run of any length fits and recent data stays at full
+// resolution.
+class ScoreTimeline {
+public:
+    ScoreTimeline();
+
+    void clear();
+    void record(float time, int score);
+
+    bool empty() const;
+    size_t getBucketCount() const;
+
+    // Visits all buckets oldest first. Older buckets are coarser; none overlap.
+    template <typename Visitor>
+    void forEachBucket(Visitor&& visit) const {
+        for (size_t level = levels.size(); level-- > 0;) {
+            const Level& ring = levels[level];
+            for (size_t i = 0; i < ring.count; ++i) {
+                visit(ring.buckets[(ring.head + i) % ring.buckets.size()]);
+            }
+        }
+        if (hasCurrent) visit(current);
+    }
+
+    void copyBuckets(std::vector<ScoreBucket>& out) const;
+    // One point per bucket (end time, last score), as stored in the run log.
+    void copyPoints(std::vector<ScorePoint>& out) const;
+
+private:
+    struct Level {
+        std::vector<ScoreBucket> buckets; // Ring storage, allocated once
+        size_t head = 0;                  // Oldest bucket
+        size_t count = 0;
+    };
+
+    static void merge(ScoreBucket& into, const ScoreBucket& next);
+    void push(size_t level, const ScoreBucket& bucket);
+
+    std::array<Level, GameConstants::SCORE_TIMELINE_LEVELS> levels;
+    ScoreBucket current; // Base bucket still being filled
+    bool hasCurrent = false;
+};
@@ -4,17 +4,25 @@
 #include <set>
 #include <memory>
 #include <vector> // For vector of string in load/save
+#include <string_view>
+#include <cstddef>
 #include <SFML/Graphics/Font.hpp>
 #include "../include/Constants.h"
 
 class FontManager;
+class PersistenceWorker;
 
 class SettingsManager {
 public:
     SettingsManager();
 
     void loadSettings(const std::string& filePath, FontManager& fontManager, std::shared_ptr<sf::Font>& currentFontRef);
-    void saveSettings(const std::string& filePath, const std::shared_ptr<sf::Font>& currentFont, const FontManager& fontManager);
+    // Snapshots the settings and hands them to 'persistence'; the file is written off the calling thread.
+    void saveSettings(PersistenceWorker& persistence, const std::string& filePath, const std::shared_ptr<sf::Font>& currentFont, const FontManager& fontManager) const;
+    // Settings file contents for the current values (key=value lines, see SETTING_FIELDS).
+    std::string serialize(const std::string& activeFontName) const;
+    // Settings file of a named profile; the empty name is the default settings file.
+    static std::string profilePath(const std::string& profileName);
 
     float getWordSpeedMultiplier() const;
     float getSpawnRateMultiplier() const;
@@ -26,6 +34,11 @@ public:
     const std::set<std::string>& getRandomizedFontNames() const;
     const std::set<size_t>& getRandomizedWordSetIndices() const;
     bool randomizeWordSets() const; // From randomizeWordSetsEnabled
+    bool weaknessTraining() const; // From weaknessTrainingEnabled
+    GameConstants::PseudoWordMode getPseudoWordMode() const;
+    bool paragraphMode() const; // From paragraphModeEnabled
+    bool freeTyping() const; // From freeTypingEnabled
+    size_t getLeaderboardCapacity() const;
 
 
     void setWordSpeedMultiplier(float val);
@@ -39,7 +52,14 @@ public:
     void toggleRandomizedWordSet(size_t setIndex);
     void clearRandomizedFonts();
     void clearRandomizedWordSets();
+    // Rewrites randomized word-set indices after sets were removed (-1 drops an index).
+    void remapRandomizedWordSets(const std::vector<std::ptrdiff_t>& indexRemap);
     void setRandomizeWordSets(bool val);
+    void setWeaknessTraining(bool val);
+    void setPseudoWordMode(GameConstants::PseudoWordMode val);
+    void setParagraphMode(bool val);
+    void setFreeTyping(bool val);
+    void setLeaderboardCapacity(size_t val);
 
 
     // Public for easier access by UIManager if needed, or direct modification by game logic.
@@ -56,4 +76,14 @@ public:
 
     bool randomizeWordSetsEnabled; // NEW: Flag for word set randomization strategy
     std::set<size_t> randomizedWordSetIndices;
+
+    bool weaknessTrainingEnabled; // Spawn words that drill the player's frequent mistakes
+    GameConstants::PseudoWordMode pseudoWordMode; // Spawn generated pseudo-words instead of dictionary words
+    bool paragraphModeEnabled; // Type a scrolling passage from the texts folder instead of flying words
+    bool freeTypingEnabled; // Match typed text against all words instead of locking onto one
+    size_t leaderboardCapacity; // Named runs kept on the leaderboard (edit the settings file to change)
+
+private:
+    // Applies a settings file in one pass, migrating older formats. Returns the file's format version.
+    int parseSettings(std::string_view contents, std::string& activeFontName);
 };
\ No newline at end of file
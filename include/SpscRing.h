@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer, single-consumer queue over a fixed array.
+// push() and drain() are wait-free and never allocate: each side owns one index and only reads
+// the other's. When the ring is full push() refuses the element instead of waiting.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (dropping 'value') if the consumer has fallen a full ring behind.
+    bool push(const T& value) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - cachedReadIndex == Capacity) {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (head - cachedReadIndex == Capacity) return false;
+        }
+        slots[head & (Capacity - 1)] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Passes every queued element to 'consume' in order and returns how many there were.
+    template <typename Consumer>
+    size_t drain(Consumer&& consume) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        size_t head = writeIndex.load(std::memory_order_acquire);
+        for (size_t i = tail; i != head; ++i) consume(slots[i & (Capacity - 1)]);
+        readIndex.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+private:
+    std::array<T, Capacity> slots{};
+    // Each index on its own cache line, so the two threads do not invalidate each other's.
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    size_t cachedReadIndex = 0; // Producer's last view of readIndex
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
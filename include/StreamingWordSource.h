@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <cstdint>
+
+// Word source for dictionaries too large to keep in memory.
+// A background thread scans the file sequentially and keeps a uniform reservoir sample
+// (Algorithm R) of fixed size. Snapshots of the reservoir are published atomically, so
+// drawing a word never waits on the scanner and memory stays bounded by the reservoir size.
+class StreamingWordSource {
+public:
+    StreamingWordSource(const std::string& filePath, size_t reservoirCapacity);
+    ~StreamingWordSource();
+
+    StreamingWordSource(const StreamingWordSource&) = delete;
+    StreamingWordSource& operator=(const StreamingWordSource&) = delete;
+
+    // Starts the background scanner. Safe to call once.
+    void start();
+
+    // Copies a random word from the latest snapshot into 'out'. Returns false while the
+    // scanner has not published anything yet.
+    bool drawWord(std::mt19937& randomGen, std::string& out) const;
+
+    // Returns the latest published reservoir (may be null before the first publish).
+    std::shared_ptr<const std::vector<std::string>> getSnapshot() const;
+
+    const std::string& getFilePath() const;
+    uint64_t getWordsScanned() const; // Words that passed normalization
+    bool isScanComplete() const; // The whole file has been sampled
+    bool hasFailed() const; // The scanner stopped on an unreadable or empty file
+
+private:
+    void run();
+    void publish(const std::vector<std::string>& reservoir, size_t filled);
+
+    std::string filePath;
+    size_t capacity;
+    std::thread worker;
+    std::atomic<bool> stopRequested;
+    std::atomic<uint64_t> wordsScanned;
+    std::atomic<bool> scanComplete;
+    std::atomic<bool> failed;
+
+    // Only accessed through std::atomic_load / std::atomic_store.
+    std::shared_ptr<const std::vector<std::string>> published;
+};
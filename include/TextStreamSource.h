@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// Streams the words of an arbitrarily large text file for paragraph mode.
+// A background thread reads the file in fixed-size chunks, turns it into typeable ASCII
+// words and keeps a bounded queue of them filled ahead of the reader. Memory use is
+// constant in the file size, and taking words never waits on disk.
+class TextStreamSource {
+public:
+    explicit TextStreamSource(const std::string& filePath);
+    ~TextStreamSource();
+
+    TextStreamSource(const TextStreamSource&) = delete;
+    TextStreamSource& operator=(const TextStreamSource&) = delete;
+
+    // Starts reading at a random word boundary, so every session gets a different passage.
+    // The text wraps around at the end of the file.
+    void start(uint64_t seed);
+
+    // Appends up to 'maxWords' buffered words to 'out' without blocking and returns how many.
+    size_t takeWords(std::vector<std::string>& out, size_t maxWords);
+
+    // True once the file turned out to be unreadable or to contain no typeable words.
+    bool hasFailed() const;
+
+    const std::string& getFilePath() const;
+
+private:
+    void run(uint64_t seed);
+    // Pushes finished words, waiting while the queue is full. Returns false when stopping.
+    bool enqueue(std::vector<std::string>& words);
+
+    std::string filePath;
+    std::thread worker;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> failed;
+    std::mutex queueMutex;
+    std::condition_variable spaceAvailable;
+    std::deque<std::string> queue;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Constants.h"
+#include <array>
+#include <cstdint>
+
+// Typing speed and accuracy of the run in progress, driven by keystroke timestamps rather than
+// frame time. Every character key is counted when it is typed (backspaces are not keys here), so
+// speed no longer waits for words to complete and mistakes on abandoned words count.
+//
+// Keys are binned into slots of TYPING_STATS_SLOT_MS in a ring covering the longest window. Each
+// rolling window keeps running sums that are updated as keys arrive and as slots leave it, so a
+// key and a frame cost O(windows) whatever the window lengths.
+// Net speed counts correct keys, raw speed all keys; five keys make a word.
+// Times are steady clock microseconds, as given by InputLatencyMeter::nowMicros().
+class TypingStatsEngine {
+public:
+    enum Window {
+        INSTANT, // TYPING_STATS_WINDOW_SECONDS[INSTANT]; its best full window is the peak speed
+        SHORT,
+        LONG,
+        WINDOW_COUNT
+    };
+
+    TypingStatsEngine();
+
+    void begin(uint64_t startMicros);
+    void keyTyped(uint64_t micros, bool correct);
+    // Moves the clock to 'nowMicros' (called every frame); the readings below are as of then.
+    void advance(uint64_t nowMicros);
+
+    float netWpm(Window window) const;
+    float rawWpm(Window window) const;
+    float runNetWpm() const;
+    float runRawWpm() const;
+    float peakWpm() const; // Best net speed over a full INSTANT window
+    float accuracy() const; // Correct keys in percent of all keys; 100 before the first key
+
+    uint32_t getTypedKeys() const;
+    uint32_t getCorrectKeys() const;
+
+private:
+    struct Slot {
+        uint32_t keys = 0;
+        uint32_t correctKeys = 0;
+    };
+    struct WindowSums {
+        uint64_t slots = 0; // Window length in slots
+        uint32_t keys = 0;
+        uint32_t correctKeys = 0;
+    };
+
+    float windowMinutes(const WindowSums& window) const;
+
+    std::array<Slot, GameConstants::TYPING_STATS_SLOTS> slots{};
+    std::array<WindowSums, WINDOW_COUNT> windows{};
+    uint64_t startMicros = 0;
+    uint64_t nowMicros = 0;
+    uint64_t currentSlot = 0; // Slots since the start; the last slot of every window
+    uint32_t typedKeys = 0;
+    uint32_t correctKeys = 0;
+    float peak = 0.f;
+};
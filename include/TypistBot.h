@@ -0,0 +1,65 @@
+#pragma once
+
+#include "GameSession.h"
+#include <random>
+#include <string>
+#include <cstdint>
+
+// Simulated typist that plays a GameSession through the same TextEntered events a player's
+// keyboard produces, for soak runs, difficulty tuning and the attract mode demo.
+// Key intervals and reaction times are log-normally distributed around the profile's speed and
+// reaction time, wrong keys are noticed after a reaction time and backspaced, and new words are
+// picked by the profile's targeting strategy (the session still decides which word a first key
+// selects, exactly as for a player).
+class TypistBot {
+public:
+    enum class Targeting {
+        NEAREST_ESCAPE, // Word that leaves the screen soonest
+        OLDEST,         // Earliest spawned word
+        SHORTEST,
+        RANDOM
+    };
+
+    struct Profile {
+        float wordsPerMinute = 60.f;  // Five keys per word
+        float errorRate = 0.03f;      // Chance of each key being wrong
+        float reactionTime = 0.35f;   // Mean delay before starting a word or noticing a mistake (s)
+        Targeting targeting = Targeting::NEAREST_ESCAPE;
+    };
+
+    TypistBot(const Profile& profile, uint32_t seed);
+
+    // Forgets the word in progress; call when a new game starts.
+    void reset();
+
+    // Advances the bot by one frame of 'deltaTime' seconds. Returns true with a TextEntered event
+    // if it typed a key this frame (at most one); 'lateBy' is then how long before the end of the
+    // frame the key was due, for timestamping.
+    bool update(const GameSession& session, float deltaTime, sf::Event& event, float& lateBy);
+
+    const Profile& getProfile() const;
+
+private:
+    enum class Delay {
+        NONE,    // Look again next frame
+        KEY,
+        REACTION
+    };
+
+    // The next key to type, or 0 if there is none yet. Sets 'delay' to what must pass before
+    // the bot acts again.
+    sf::Uint32 chooseKey(const GameSession& session, Delay& delay);
+    sf::Uint32 chooseFreeTypingKey(const GameSession& session, Delay& delay);
+    sf::Uint32 typeNext(char expected, Delay& delay);
+    const Word* pickTarget(const GameSession& session);
+    float sample(float mean, float sigma);
+
+    Profile profile;
+    std::mt19937 randomGen;
+    float untilNextKey = 0.f;
+    bool aimed = false; // Has spent a reaction time on the word it will start next
+
+    // Free typing has no selected word, so the bot remembers what it is typing.
+    uint32_t freeTargetId = 0;
+    std::string freeInput; // Keys typed towards the target since choosing it
+};
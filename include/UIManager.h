@@ -9,6 +9,8 @@
 #include "../include/TextAnimation.h"
 #include "../include/Constants.h"
 #include "../include/HighScoreManager.h" // For ScorePoint definition
+#include "../include/ScoreTimeline.h"
+#include "../include/KeystrokeAnalytics.h"
 
 // Forward declarations of classes UIManager interacts with
 class MonkeyTyperGame;
@@ -34,17 +36,20 @@ public:
     void processFontRandomizationEvent(sf::Event& event);
     void processWordSetSelectionEvent(sf::Event& event);
     void processGraphViewEvent(sf::Event& event);
+    void processStatsViewEvent(sf::Event& event);
 
     // Rendering methods for different game states/screens
     void renderMenu();
-    void renderGameOver(const GameConstants::GameStats& gameStats, int score, const std::deque<ScorePoint>& scoreHistory, const std::shared_ptr<sf::Font>& currentFont);
-    void renderScoreGraph(const std::deque<ScorePoint>& scoreHistory, const sf::FloatRect& graphBounds, const std::shared_ptr<sf::Font>& currentFont, const std::string& title);
+    void renderGameOver(const GameConstants::GameStats& gameStats, int score, const ScoreTimeline& scoreTimeline, const std::shared_ptr<sf::Font>& currentFont);
+    // Draws buckets oldest first; buckets covering several samples also show their min/max range.
+    void renderScoreGraph(const std::vector<ScoreBucket>& buckets, const sf::FloatRect& graphBounds, const std::shared_ptr<sf::Font>& currentFont, const std::string& title);
     void renderHighScores();
     void renderSettings();
     void renderFontSelection();
     void renderFontRandomization();
     void renderWordSetSelection();
     void renderGraphView();
+    void renderStatsView();
 
     void updateFonts(); // Called when the global game font changes
     void refreshSettingsButtons(); // Called to update settings button labels/structure
@@ -52,6 +57,8 @@ public:
     // Publicly accessible sf::Text objects for MonkeyTyperGame to update during gameplay
     sf::Text scoreTextDisplay;
     sf::Text gameTimeStatsTextDisplay; // Displays WPM, Accuracy, Time
+    sf::Text latencyOverlayDisplay;    // Input latency percentiles, shown with F3
+    sf::Text attractBannerDisplay;     // Shown over the attract mode demo
 
 private:
     // Helper methods for creating button sets
@@ -62,6 +69,7 @@ private:
     void createFontSelectionRelatedButtons(); // Back buttons for font/word set screens, graph view
 
     void initSettingsAnimations(); // Initializes example animations for the settings screen
+    void openStatsView(); // Folds in new keystrokes and ranks the slowest keys once, not per frame
 
     // References to core game components
     sf::RenderWindow& window;
@@ -81,7 +89,11 @@ private:
     std::vector<Button> menuButtons;
     std::vector<Button> gameOverButtons;
     std::vector<Button> highScoresNavigationButtons; // e.g., "Back", "View Graph" on high scores screen
+    std::vector<ScoreBucket> graphBuckets; // Reused by the graph views
     int selectedScoreIndex; // Index of the currently selected high score for viewing details/graph
+    size_t selectedPartition = 0; // Leaderboard shown on the high scores screen (0 = all configurations)
+    std::string exportMessage; // Shown on the high scores screen after "Export"
+    std::vector<KeystrokeAnalytics::Ranked> slowestKeys[3]; // Characters, bigrams, trigrams for the statistics screen
 
     std::vector<Button> settingsButtons;
     std::vector<TextAnimation> settingsAnimations; // Animations for the settings screen examples
@@ -90,4 +102,5 @@ private:
     Button fontScreenBackButton;
     Button wordSetScreenBackButton;
     Button graphViewBackButton;
+    Button statsViewBackButton;
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <cstdint>
+#include "WeightedSampler.h"
+
+// Drives the weakness training mode: tracks which characters and bigrams the player mistypes
+// and biases word selection towards dictionary words that contain them.
+//
+// Two Fenwick samplers keep every operation logarithmic regardless of dictionary size:
+//  - a feature sampler over the 26 letters and 26*26 letter bigrams, weighted by recent mistakes,
+//    whose winner is resolved to a word through a flat posting list;
+//  - a dictionary sampler holding a per-word boost for words the player actually fumbled.
+// Weights decay exponentially per keystroke. Instead of touching every weight, the increment
+// applied to new mistakes grows each keystroke and everything is renormalized once it gets large.
+class WeaknessTrainer {
+public:
+    WeaknessTrainer();
+
+    // Indexes the given word pool. Mistake statistics survive re-indexing; per-word boosts do not.
+    void rebuildIndex(const std::vector<const std::vector<std::string>*>& sources);
+
+    // Records one typed character. 'expected' is the character the word wanted at that position,
+    // 'previous' the character before it in the word (0 at the start of a word).
+    void recordKeystroke(const std::string& wordText, char expected, char previous, bool mistake);
+
+    // Returns true once enough mistakes were recorded for drilling to make a difference.
+    bool hasWeaknesses() const;
+
+    // Picks a word from the indexed pool, preferring words containing weak characters/bigrams.
+    // Returns nullptr if the pool is empty.
+    const std::string* sampleWord(std::mt19937& rng) const;
+
+    size_t getIndexedWordCount() const;
+
+private:
+    static int featureForChar(char c);
+    static int featureForBigram(char a, char b);
+    void bumpFeature(int feature);
+    void advanceDecay();
+
+    static constexpr int LETTER_COUNT = 26;
+    static constexpr int FEATURE_COUNT = LETTER_COUNT + LETTER_COUNT * LETTER_COUNT;
+
+    std::vector<std::string> words;
+    std::unordered_map<std::string_view, uint32_t> wordLookup;
+
+    // Posting lists in CSR layout: the words containing feature f are
+    // postingWords[postingOffsets[f] .. postingOffsets[f + 1]).
+    std::vector<uint32_t> postingOffsets;
+    std::vector<uint32_t> postingWords;
+
+    WeightedSampler featureSampler;
+    WeightedSampler wordSampler;
+    double decayIncrement;
+};
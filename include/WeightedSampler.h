@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Dynamic weighted sampler backed by a Fenwick (binary indexed) tree.
+// Weight updates and proportional sampling are both O(log n).
+class WeightedSampler {
+public:
+    WeightedSampler();
+
+    // Resizes the sampler to 'count' entries, all with zero weight.
+    void reset(size_t count);
+
+    // Replaces all weights at once in O(n).
+    void assign(const std::vector<double>& newWeights);
+
+    // Adds 'delta' to the weight of an entry (result is clamped at zero).
+    void add(size_t index, double delta);
+
+    // Sets the weight of an entry.
+    void set(size_t index, double weight);
+
+    // Multiplies every weight by 'factor' in O(n). Used to renormalize decayed weights.
+    void scale(double factor);
+
+    double weight(size_t index) const;
+    double total() const;
+    size_t size() const;
+
+    // Returns the entry whose cumulative weight range contains 'target', where 0 <= target < total().
+    size_t sample(double target) const;
+
+private:
+    void rebuildTree();
+
+    std::vector<double> weights;
+    std::vector<double> tree; // 1-based partial sums
+    size_t highestPowerOfTwo;
+    double totalWeight;
+};
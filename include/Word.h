@@ -1,8 +1,18 @@
 #pragma once
 #include "SFML/Graphics.hpp"
 #include <string>
+#include <vector>
 #include "../include/Constants.h"
 
+class GlyphMetrics;
+
+// Outcome of the last character appended by processInput, consumed by weakness tracking.
+struct TypedKey {
+    char expected = 0; // Character the word wanted at the typed position (0 if nothing was appended)
+    char previous = 0; // Character preceding it in the word (0 at the start of a word)
+    bool mistake = false;
+};
+
 class Word {
 public:
     Word(const std::string& text, const sf::Font& font, float speed, const sf::Vector2f& position,
@@ -10,6 +20,10 @@ public:
 
     virtual ~Word() = default;
 
+    // Reinitializes a recycled word as if freshly constructed, keeping its buffers.
+    void reset(const std::string& newText, const sf::Font& font, float newSpeed, const sf::Vector2f& newPosition,
+               unsigned int fontSize = GameConstants::DEFAULT_FONT_SIZE);
+
     bool isBeingActivelyTyped() const { return isActiveTypingTarget; }
     void setAsActiveTypingTarget(bool active) { isActiveTypingTarget = active; }
     virtual bool isLinked() const;
@@ -21,6 +35,9 @@ public:
     virtual void processInput(sf::Uint32 unicode, bool highlightTyping);
     virtual void updateTextColor(bool highlightTyping);
     virtual const std::string& getText() const;
+    // Screen rectangle of the text the player types next (the current part for linked words).
+    // Computed from cached glyph metrics; never queries sf::Text geometry.
+    virtual sf::FloatRect getTypingBounds() const;
 
     bool isBeingTyped() const;
     bool isComplete() const;
@@ -28,6 +45,16 @@ public:
     const sf::Vector2f& getPosition() const;
     float getSpeed() const;
     int getMistakesCount() const;
+    const TypedKey& getLastTypedKey() const;
+    // Per-game spawn number, used to attribute keystrokes to words (0 if unset).
+    uint32_t getId() const { return id; }
+    void setId(uint32_t value) { id = value; }
+    float getTextWidth() const;
+
+    // Incremental typing state, updated in O(1) per key.
+    size_t getMatchedLength() const;  // Leading characters of the input that match the text
+    bool hasTypingError() const;      // Input contains a wrong character after the matched prefix
+    int getMistakesAtPosition(size_t index) const; // Wrong keys typed at this position of the text
 
     virtual void setText(const std::string& newText);
     const sf::Text& getSfText() const;
@@ -45,6 +72,13 @@ public:
 
 protected:
     void updateColorBasedOnPosition();
+    void measurePrefixes();
+    void refreshTypingOverlay();
+    // sf::Text::setString copies into the text's own buffer, which keeps its capacity; going
+    // through stringBuffer instead of a temporary sf::String makes that allocation-free.
+    void setTextString(sf::Text& target, const std::string& value);
+    // Grows the text's buffer to MAX_WORD_LENGTH characters up front.
+    void reserveTextString(sf::Text& target);
 
 
 
@@ -59,10 +93,32 @@ protected:
     bool typedCorrectly;
     int mistakesCount;
     size_t currentWordIndex = 0;
+    TypedKey lastTypedKey;
+    uint32_t id = 0;
+    const GlyphMetrics* metrics; // Shared table for this word's font and size
+    float textWidth;             // Width of 'text', updated by setText
+    sf::String stringBuffer;     // Scratch for setTextString
+    std::vector<float> prefixWidths; // Pen advance after each prefix of 'text' (size + 1 entries)
+
+    size_t matchedLength = 0;
+    std::vector<unsigned char> positionMistakes; // Parallel to 'text'
+    // Per-character feedback drawn over sfText, so the word itself is never re-laid out:
+    // the matched prefix in COMPLETED_COLOR and the wrongly typed span in red. A key edits
+    // one character of one overlay string; SFML re-lays out that overlay (a few glyphs) when
+    // it is next drawn.
+    bool showTypingProgress = false;
+    float matchedWidth = 0.f;
+    sf::Text matchedText;
+    sf::Text errorText;
+    sf::String matchedString;      // text[0, matchedShownEnd)
+    sf::String errorString;        // text[errorShownBegin, errorShownEnd)
+    size_t matchedShownEnd = 0;
+    size_t errorShownBegin = 0;
+    size_t errorShownEnd = 0;
 
 public:
     void resetTyping() {
-        currentInput.clear();
+        clearCurrentInput();
         setAsActiveTypingTarget(false);
     }
 };
\ No newline at end of file
@@ -3,14 +3,37 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <cstddef>
+#include "../include/Constants.h"
+#include "../include/WordListCleaner.h"
+
+class StreamingWordSource;
+class DirectoryWatcher;
+class MarkovWordGenerator;
 
 class WordDatabaseManager {
 public:
     WordDatabaseManager();
+    ~WordDatabaseManager();
 
     // Loads all word sets from .txt files in the specified directory.
+    // Files larger than STREAMING_DICTIONARY_THRESHOLD_BYTES are not read into memory; they become
+    // streaming sets whose words are drawn from a reservoir refreshed by a background scanner.
+    // Files are read and cleaned (see WordListCleaner) in parallel.
     void loadWordSets(const std::string& dictionaryDirectory);
 
+    // Starts watching the dictionary directory; changed files are reparsed on the watcher thread.
+    void startWatching(const std::string& dictionaryDirectory);
+
+    // Swaps in word sets reparsed since the last call. Never blocks: if the watcher is busy
+    // publishing, the swap simply happens on a later frame. When sets were removed, 'indexRemap'
+    // maps every old set index to its new index (-1 for removed sets); otherwise it is left empty.
+    // Returns true if anything changed.
+    bool applyPendingUpdates(std::vector<std::ptrdiff_t>& indexRemap);
+
     // Returns the list of all loaded word sets.
     const std::vector<std::vector<std::string>>& getAllWordSets() const;
 
@@ -24,19 +47,71 @@ public:
     void setCurrentWordSetByIndex(size_t index);
 
 
+    // Words returned by the draw functions below stay valid until the next draw or
+    // applyPendingUpdates(); streamed and generated words are copied into a reused buffer.
+
     // Returns a random word from the currently selected word set.
-    std::string getRandomWord() const;
+    const std::string& getRandomWord() const;
 
-    // Returns the currently active word database (vector of strings).
+    // Returns the words of the current set (empty for a streaming set). Valid until the next
+    // applyPendingUpdates().
     const std::vector<std::string>& getCurrentWordDatabase() const;
 
-    std::string getRandomWordFromSet(size_t setIndex) const;
+    const std::string& getRandomWordFromSet(size_t setIndex) const;
     const std::vector<std::string>* getWordSetByIndexPtr(size_t setIndex) const; // Helper
 
+    // Streaming sets keep an empty placeholder in getAllWordSets(); their words come from the source.
+    bool isStreamingSet(size_t setIndex) const;
+    const StreamingWordSource* getStreamingSource(size_t setIndex) const;
+
+    // Returns a pseudo-word generated from the set's Markov model, or an empty string if the
+    // set has no model (streaming or too small) or mode is OFF.
+    const std::string& getGeneratedWordFromSet(size_t setIndex, GameConstants::PseudoWordMode mode) const;
+    bool hasGenerator(size_t setIndex) const;
+
+    size_t getCurrentWordSetIndex() const;
+
+    // Load-time cleaning statistics for an in-memory set (nullptr for streaming sets).
+    const WordSetStats* getWordSetStats(size_t setIndex) const;
+
 
 private:
+    struct PendingWordSetUpdate {
+        std::string name;
+        bool removed = false;
+        std::vector<std::string> words;
+        std::unique_ptr<StreamingWordSource> stream;
+        WordSetStats stats;
+        std::unique_ptr<MarkovWordGenerator> generator;
+    };
+
+    // Sets swapped out by applyPendingUpdates, handed to a background thread to destroy.
+    struct RetiredWordSets {
+        std::vector<std::vector<std::string>> words;
+        std::vector<std::unique_ptr<StreamingWordSource>> streams;
+        std::vector<std::unique_ptr<MarkovWordGenerator>> generators;
+    };
+
+    // Reads and cleans one dictionary file and loads or trains its generator. Oversized files
+    // yield a started streaming source instead of words. Returns false if nothing usable was read.
+    static bool readWordSetFile(const std::string& path, PendingWordSetUpdate& result);
+    static std::unique_ptr<MarkovWordGenerator> loadOrTrainGenerator(const std::string& dictionaryPath, const std::vector<std::string>& words);
+    void onDictionaryFileChanged(const std::string& fileName, bool removed);
+    void useDefaultWords();
+
     std::vector<std::vector<std::string>> wordSets;
     std::vector<std::string> wordSetNames; // Stores filenames
-    std::vector<std::string> currentWordDatabase; // The active set of words
+    size_t currentSetIndex; // Index of the active set
+    std::vector<std::unique_ptr<StreamingWordSource>> streamingSources; // Parallel to wordSets, null for in-memory sets
+    std::vector<WordSetStats> wordSetStats; // Parallel to wordSets
+    std::vector<std::unique_ptr<MarkovWordGenerator>> generators; // Parallel to wordSets, null without a model
     mutable std::mt19937 randomGenerator; // For random word selection
+    mutable std::string drawnWord;        // Streamed or generated word last returned by a draw
+    bool usingDefaultWords; // True while the built-in fallback set stands in for missing files
+
+    std::string watchedDirectory;
+    std::mutex pendingMutex;
+    std::vector<PendingWordSetUpdate> pendingUpdates; // Filled by the watcher thread, drained by applyPendingUpdates
+    std::vector<std::future<void>> retirements; // Destroying retired sets; waited for on destruction
+    std::unique_ptr<DirectoryWatcher> watcher; // Declared last so it stops before the state it feeds is destroyed
 };
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include "../include/Constants.h"
+
+// Load-time statistics for one in-memory word set.
+struct WordSetStats {
+    size_t tokensRead = 0;       // Raw whitespace-separated tokens in the file
+    size_t uniqueWords = 0;      // Words kept after normalization, filtering and dedup
+    size_t duplicatesRemoved = 0;
+    size_t invalidRemoved = 0;   // Non-ASCII, control characters or nothing left after trimming
+    size_t tooLongRemoved = 0;   // Longer than GameConstants::MAX_WORD_LENGTH
+    // lengthHistogram[i] counts words of length i + 1; the last bucket also holds longer words.
+    std::array<size_t, GameConstants::WORD_LENGTH_HISTOGRAM_BUCKETS> lengthHistogram{};
+};
+
+// Normalization pipeline applied to dictionary words before they reach the game.
+namespace WordListCleaner {
+    // Trims surrounding punctuation, rejects non-ASCII and control characters and folds
+    // to lower case in place. Returns false if the token is not a usable word.
+    // Letters are checked and folded eight bytes at a time.
+    bool normalizeToken(std::string& token);
+
+    // Normalizes every word, drops invalid, overlong and duplicate entries (keeping first
+    // occurrences in file order) and fills 'stats'. 'stats.tokensRead' must already be set.
+    void cleanWords(std::vector<std::string>& words, WordSetStats& stats);
+}
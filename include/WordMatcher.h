@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Multi-pattern matcher over the texts of all active words, used by free-typing mode.
+// The typed stream is fed one character at a time; after each character the matcher
+// reports every registered text that is a suffix of the stream.
+//
+// The texts form a trie, and the matcher keeps the set of trie nodes spelled by suffixes of
+// the stream (at most one per suffix no longer than the longest text). A character advances
+// each of them by one edge, so it costs O(longest text) whatever the number of registered
+// words, with no failure links to maintain. Adding or removing a text touches only its own
+// path, O(length); an addition can make a suffix of the stream spell a prefix it did not
+// before, so refresh() rewalks the stream's suffixes, O(longest text squared), also
+// independent of the number of words. Dead branches are compacted away once they outnumber
+// live nodes.
+class WordMatcher {
+public:
+    WordMatcher();
+
+    // Registers / unregisters one occurrence of a text. Texts may be registered repeatedly.
+    void addText(const std::string& text);
+    void removeText(const std::string& text);
+    void clear();
+    // Brings the stream up to date with texts added since the last call and compacts the trie
+    // if needed. The owner calls it once per batch of changes, off the input path; feed() only
+    // falls back to it if that was skipped.
+    void refresh();
+
+    // Feeds one typed character. Returns the registered texts that now end the typed
+    // stream, longest first. The result stays valid until the next call.
+    const std::vector<const std::string*>& feed(char c);
+
+    // Undoes the last fed character (backspace).
+    void unfeed();
+
+    // Forgets the typed stream, e.g. after words were completed.
+    void resetStream();
+    // True if the typed stream ends partway into (or at the end of) a registered text.
+    bool isStreamInText() const;
+
+    // The most recent typed characters (bounded), for display.
+    const std::string& getRecentInput() const;
+
+private:
+    struct Node {
+        std::vector<std::pair<char, int32_t>> children; // Few per node; a linear scan beats hashing
+        uint32_t liveCount = 0;     // Registered occurrences ending at this node
+        uint32_t liveBelow = 0;     // Occurrences ending in this subtree; 0 marks a dead branch
+        std::string text;           // Set on nodes where a text ends
+    };
+
+    int32_t child(int32_t node, char c) const;
+    void compact();
+    void rewalkStream();
+
+    std::vector<Node> nodes;
+    size_t liveNodes;                   // Nodes (root included) with liveBelow > 0
+    size_t longestText;                 // Longest text registered since the last clear or compaction
+    bool streamStale;                   // Texts were added since 'active' was derived
+    std::string recentInput;            // Bounded tail of the typed stream
+    std::vector<int32_t> active;        // Live nodes spelled by suffixes of the stream, longest first
+    std::vector<int32_t> nextActive;
+    std::vector<const std::string*> matches;
+};
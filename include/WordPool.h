@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Word.h"
+#include "LinkedWord.h"
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+class WordPool;
+
+// Deleter that hands a word back to its pool instead of freeing it.
+struct WordRecycler {
+    WordPool* pool = nullptr;
+    void operator()(Word* word) const noexcept;
+};
+
+using PooledWord = std::unique_ptr<Word, WordRecycler>;
+
+// Recycles Word and LinkedWord objects between spawns. A released word keeps its strings,
+// sf::Text vertex arrays and part vectors, and acquire() resets it in place, so once the
+// pool has warmed up to the peak number of words on screen, spawning does not allocate.
+// Linked words are only reused for the same number of parts, so their vectors never grow.
+// The pool must outlive every word it hands out.
+class WordPool {
+public:
+    WordPool() = default;
+    WordPool(const WordPool&) = delete;
+    WordPool& operator=(const WordPool&) = delete;
+
+    PooledWord acquireWord(const std::string& text, const sf::Font& font, float speed,
+                           const sf::Vector2f& position, unsigned int fontSize);
+    PooledWord acquireLinkedWord(const std::vector<std::string>& parts, const sf::Font& font, float speed,
+                                 const sf::Vector2f& position, unsigned int fontSize,
+                                 const std::vector<float>& yPositions);
+    // Never allocates: acquire*() reserved an idle slot for every object it constructed.
+    void release(Word* word) noexcept;
+
+    size_t getCreatedCount() const; // Objects constructed over the pool's lifetime
+    size_t getReusedCount() const;  // Acquisitions served from idle objects
+    size_t getIdleCount() const;
+
+private:
+    std::vector<std::unique_ptr<Word>> idleWords;
+    std::vector<std::unique_ptr<LinkedWord>> idleLinkedWords;
+    size_t createdWords = 0;
+    size_t createdLinkedWords = 0;
+    size_t reusedCount = 0;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+// Fixed set of worker threads, each with its own task deque. Submitted tasks are dealt round
+// robin (tasks submitted from a worker go to its own deque); a worker runs its own tasks newest
+// first and, when it runs out, steals the oldest task of another worker, so uneven tasks (games
+// lasting seconds or minutes) keep every core busy without a central queue to contend on.
+// Tasks must not throw.
+class WorkStealingPool {
+public:
+    // 0 threads means one per core.
+    explicit WorkStealingPool(size_t threadCount = 0);
+    ~WorkStealingPool(); // Runs all submitted tasks before returning
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // Blocks until every task submitted so far (and the tasks they submitted) has run.
+    void wait();
+
+    size_t getThreadCount() const;
+    uint64_t getStolenCount() const; // Tasks run by another worker than the one they were dealt to
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void runWorker(size_t index);
+    bool popOwn(size_t index, std::function<void()>& task);
+    bool steal(size_t thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<uint64_t> stolenCount{0};
+
+    std::mutex stateMutex; // Guards sleeping and waking; queued is only raised under it
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> queued{0};  // Tasks in the deques
+    std::atomic<size_t> pending{0}; // Tasks submitted and not finished
+    bool stopping = false;
+};
@@ -0,0 +1,39 @@
+#include "../include/AllocationCounter.h"
+
+namespace {
+    thread_local uint64_t allocationCount = 0; // Constant-initialized, so counting never allocates
+}
+
+#ifdef MONKEY_TYPER_COUNT_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+
+// The array, nothrow and sized forms forward to these two in the standard library.
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+namespace AllocationCounter {
+    bool isEnabled() {
+#ifdef MONKEY_TYPER_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t getCount() {
+        return allocationCount;
+    }
+}
@@ -0,0 +1,95 @@
+#include "../include/BatchSimulator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+BatchSimulator::BatchSimulator(const HeadlessGame::WordSupply& supply, const std::string& wordSetName, WorkStealingPool& pool)
+        : supply(supply), wordSetName(wordSetName), pool(pool) {
+}
+
+std::vector<BatchSimulator::ConfigResult> BatchSimulator::run(const std::vector<GameSession::Settings>& configs,
+                                                              const TypistBot::Profile& profile, size_t gamesPerConfig,
+                                                              uint32_t seed, float maxSeconds) {
+    // Every task writes its own slot, so games share nothing but the word supply and read-only inputs.
+    std::vector<GameResult> games(configs.size() * gamesPerConfig);
+    for (size_t config = 0; config < configs.size(); ++config) {
+        for (size_t game = 0; game < gamesPerConfig; ++game) {
+            size_t slot = config * gamesPerConfig + game;
+            pool.submit([this, &configs, &profile, &games, config, slot, seed, maxSeconds] {
+                std::seed_seq gameSeed{seed, static_cast<uint32_t>(config), static_cast<uint32_t>(slot)};
+                uint32_t gameSeedValue = 0;
+                gameSeed.generate(&gameSeedValue, &gameSeedValue + 1);
+
+                HeadlessGame headless(supply, wordSetName, gameSeedValue);
+                RunRecord run = headless.play(configs[config], profile, maxSeconds);
+                GameResult& result = games[slot];
+                result.score = static_cast<float>(run.score);
+                result.survivalSeconds = run.gameTime;
+                result.wordsPerMinute = run.stats.wordsPerMinute;
+                result.steps = headless.getStepTimings().steps;
+                result.steadyStateSpawnAllocations = headless.getSession().getSteadyStateSpawnAllocations();
+                result.capped = !headless.getSession().isOver();
+            });
+        }
+    }
+    pool.wait();
+
+    std::vector<ConfigResult> results(configs.size());
+    std::vector<float> scores;
+    std::vector<float> survivals;
+    std::vector<float> speeds;
+    simulatedSteps = 0;
+    steadyStateSpawnAllocations = 0;
+    for (size_t config = 0; config < configs.size(); ++config) {
+        ConfigResult& result = results[config];
+        result.settings = configs[config];
+        result.games = gamesPerConfig;
+        scores.clear();
+        survivals.clear();
+        speeds.clear();
+        for (size_t game = 0; game < gamesPerConfig; ++game) {
+            const GameResult& played = games[config * gamesPerConfig + game];
+            scores.push_back(played.score);
+            survivals.push_back(played.survivalSeconds);
+            speeds.push_back(played.wordsPerMinute);
+            if (played.capped) result.capped++;
+            simulatedSteps += played.steps;
+            steadyStateSpawnAllocations += played.steadyStateSpawnAllocations;
+        }
+        result.score = summarize(scores);
+        result.survivalSeconds = summarize(survivals);
+        result.wordsPerMinute = summarize(speeds);
+    }
+    return results;
+}
+
+uint64_t BatchSimulator::getSimulatedSteps() const {
+    return simulatedSteps;
+}
+
+uint64_t BatchSimulator::getSteadyStateSpawnAllocations() const {
+    return steadyStateSpawnAllocations;
+}
+
+BatchSimulator::Distribution BatchSimulator::summarize(std::vector<float>& values) {
+    Distribution distribution;
+    if (values.empty()) return distribution;
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    for (float value : values) sum += value;
+    distribution.mean = sum / values.size();
+    double squares = 0;
+    for (float value : values) squares += (value - distribution.mean) * (value - distribution.mean);
+    distribution.stddev = std::sqrt(squares / values.size());
+    // Nearest-rank percentiles.
+    auto percentile = [&values](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+        return static_cast<double>(values[std::clamp<size_t>(rank, 1, values.size()) - 1]);
+    };
+    distribution.min = values.front();
+    distribution.p10 = percentile(0.10);
+    distribution.p50 = percentile(0.50);
+    distribution.p90 = percentile(0.90);
+    distribution.max = values.back();
+    return distribution;
+}
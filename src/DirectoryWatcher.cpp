@@ -0,0 +1,123 @@
+#include "../include/DirectoryWatcher.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <chrono>
+#include <map>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Editors often write a file in several steps; wait for a quiet period before reporting.
+    constexpr auto SETTLE_DELAY = std::chrono::milliseconds(300);
+    constexpr int WAKE_INTERVAL_MS = 250;
+}
+
+DirectoryWatcher::DirectoryWatcher(const std::string& directory, ChangeCallback onChange)
+        : directory(directory), onChange(std::move(onChange)), stopRequested(false) {}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    stopRequested = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void DirectoryWatcher::start() {
+    if (worker.joinable()) return;
+    worker = std::thread(&DirectoryWatcher::run, this);
+}
+
+void DirectoryWatcher::run() {
+    if (!runInotify()) {
+        runPolling();
+    }
+}
+
+bool DirectoryWatcher::runInotify() {
+#ifdef __linux__
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return false;
+    int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM);
+    if (wd < 0) {
+        close(fd);
+        return false;
+    }
+    fmt::print("DirectoryWatcher: Watching '{}' (inotify).\n", directory);
+
+    std::map<std::string, bool> pending; // file name -> removed
+    auto lastEvent = std::chrono::steady_clock::now();
+    alignas(inotify_event) char buffer[4096];
+
+    while (!stopRequested) {
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, WAKE_INTERVAL_MS);
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            ssize_t length;
+            while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* ptr = buffer; ptr < buffer + length; ) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                    if (event->len > 0) {
+                        bool removed = (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+                        pending[event->name] = removed;
+                    }
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+            lastEvent = std::chrono::steady_clock::now();
+        }
+
+        if (!pending.empty() && std::chrono::steady_clock::now() - lastEvent >= SETTLE_DELAY) {
+            for (const auto& [name, removed] : pending) {
+                onChange(name, removed);
+            }
+            pending.clear();
+        }
+    }
+
+    inotify_rm_watch(fd, wd);
+    close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DirectoryWatcher::runPolling() {
+    fmt::print("DirectoryWatcher: Watching '{}' (polling).\n", directory);
+
+    auto scan = [this]() {
+        std::map<std::string, std::pair<fs::file_time_type, std::uintmax_t>> state;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (entry.is_regular_file(ec)) {
+                state[entry.path().filename().string()] = {entry.last_write_time(ec), entry.file_size(ec)};
+            }
+        }
+        return state;
+    };
+
+    auto known = scan();
+    while (!stopRequested) {
+        for (int slept = 0; slept < 1000 && !stopRequested; slept += WAKE_INTERVAL_MS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WAKE_INTERVAL_MS));
+        }
+        if (stopRequested) break;
+
+        auto current = scan();
+        for (const auto& [name, stamp] : current) {
+            auto it = known.find(name);
+            if (it == known.end() || it->second != stamp) onChange(name, false);
+        }
+        for (const auto& [name, stamp] : known) {
+            if (!current.count(name)) onChange(name, true);
+        }
+        known = std::move(current);
+    }
+}
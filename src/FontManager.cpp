@@ -1,13 +1,27 @@
 #include "../include/FontManager.h"
+#include "../include/DirectoryWatcher.h"
+#include "../include/GlyphMetrics.h"
 #include <fmt/core.h>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <random>
 #include <algorithm>
 
 namespace fs = std::filesystem;
 
+namespace {
+    bool isFontFile(const fs::path& path) {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == ".ttf" || ext == ".otf";
+    }
+}
+
 FontManager::FontManager() : defaultFont(nullptr) {}
 
+FontManager::~FontManager() = default;
+
 void FontManager::loadFonts(const std::string& defaultFontPath, const std::string& fallbackDefaultFontPath, const std::string& fontsDirectory) {
     defaultFont = std::make_shared<sf::Font>();
     if (!defaultFont->loadFromFile(defaultFontPath)) {
@@ -16,20 +30,17 @@ void FontManager::loadFonts(const std::string& defaultFontPath, const std::strin
             exit(1); // Critical error if default font cannot be loaded
         }
     }
-    availableFonts[fs::path(defaultFontPath).filename().string()] = defaultFont;
+    defaultFontName = fs::path(defaultFontPath).filename().string();
+    availableFonts[defaultFontName] = defaultFont;
 
     try {
         if (fs::exists(fontsDirectory) && fs::is_directory(fontsDirectory)) {
             for (const auto& entry : fs::directory_iterator(fontsDirectory)) {
-                if (entry.is_regular_file()) {
-                    std::string ext = entry.path().extension().string();
-                    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                    if (ext == ".ttf" || ext == ".otf") {
-                        auto font = std::make_shared<sf::Font>();
-                        if (font->loadFromFile(entry.path().string())) {
-                            availableFonts[entry.path().filename().string()] = font;
-                            fmt::print("Loaded font: {}\n", entry.path().filename().string());
-                        }
+                if (entry.is_regular_file() && isFontFile(entry.path())) {
+                    auto font = std::make_shared<sf::Font>();
+                    if (font->loadFromFile(entry.path().string())) {
+                        availableFonts[entry.path().filename().string()] = font;
+                        fmt::print("Loaded font: {}\n", entry.path().filename().string());
                     }
                 }
             }
@@ -68,4 +79,84 @@ std::shared_ptr<sf::Font> FontManager::getRandomFont() const {
     auto it = availableFonts.begin();
     std::advance(it, dist(gen));
     return it->second;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<sf::Font> FontManager::loadFontCopy(const std::string& path) {
+    // sf::Font reads glyphs from its source lazily, so the bytes must outlive the font.
+    struct FontWithData {
+        std::vector<char> data;
+        sf::Font font;
+    };
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return nullptr;
+    auto holder = std::make_shared<FontWithData>();
+    holder->data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (holder->data.empty() || !holder->font.loadFromMemory(holder->data.data(), holder->data.size())) {
+        return nullptr;
+    }
+    return std::shared_ptr<sf::Font>(holder, &holder->font);
+}
+
+void FontManager::startWatching(const std::string& fontsDirectory) {
+    if (watcher) return;
+    watchedDirectory = fontsDirectory;
+    watcher = std::make_unique<DirectoryWatcher>(fontsDirectory, [this](const std::string& fileName, bool removed) {
+        onFontFileChanged(fileName, removed);
+    });
+    watcher->start();
+}
+
+void FontManager::onFontFileChanged(const std::string& fileName, bool removed) {
+    // Runs on the watcher thread.
+    if (!isFontFile(fileName)) return;
+
+    std::shared_ptr<sf::Font> font;
+    if (!removed) {
+        font = loadFontCopy((fs::path(watchedDirectory) / fileName).string());
+        if (!font) {
+            fmt::print(stderr, "Failed to load font: {}\n", fileName);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingUpdates.emplace_back(fileName, std::move(font));
+}
+
+bool FontManager::applyPendingUpdates() {
+    std::vector<std::pair<std::string, std::shared_ptr<sf::Font>>> updates;
+    {
+        std::unique_lock<std::mutex> lock(pendingMutex, std::try_to_lock);
+        if (!lock.owns_lock() || pendingUpdates.empty()) return false;
+        updates.swap(pendingUpdates);
+    }
+
+    for (auto& [name, font] : updates) {
+        auto it = availableFonts.find(name);
+        if (it != availableFonts.end() && it->second != defaultFont) {
+            retiredFonts.push_back(it->second);
+        }
+
+        if (font) {
+            fmt::print("{} font: {}\n", it != availableFonts.end() ? "Reloaded" : "Added", name);
+            availableFonts[name] = std::move(font);
+        } else if (name == defaultFontName) {
+            availableFonts[name] = defaultFont; // The default font is always available
+        } else if (it != availableFonts.end()) {
+            availableFonts.erase(it);
+            fmt::print("Removed font: {}\n", name);
+        }
+    }
+    return true;
+}
+
+void FontManager::releaseRetiredFonts() {
+    // Fonts still shared elsewhere (e.g. as the current font) are kept for a later call.
+    auto released = std::partition(retiredFonts.begin(), retiredFonts.end(),
+                                   [](const std::shared_ptr<sf::Font>& font) { return font.use_count() > 1; });
+    for (auto it = released; it != retiredFonts.end(); ++it) {
+        GlyphMetrics::forget(**it);
+    }
+    retiredFonts.erase(released, retiredFonts.end());
+}
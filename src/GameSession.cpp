@@ -0,0 +1,444 @@
+#include "../include/GameSession.h"
+#include "../include/LinkedWord.h"
+#include "../include/ParagraphView.h"
+#include "../include/GlyphMetrics.h"
+#include "../include/WordMatcher.h"
+#include "../include/AllocationCounter.h"
+#include "../include/KeystrokeTelemetry.h" // KeystrokeRecord flags
+#include <algorithm>
+#include <cmath>
+
+GameSession::GameSession(Sources sources, uint32_t seed)
+        : sources(std::move(sources)), randomGen(seed), wordMatcher(std::make_unique<WordMatcher>()) {
+    spawnPartTexts.reserve(GameConstants::MAX_LINKED_WORD_PARTS);
+    spareSpawnParts.resize(GameConstants::MAX_LINKED_WORD_PARTS);
+    for (std::string& part : spareSpawnParts) part.reserve(GameConstants::MAX_WORD_LENGTH);
+    spawnPartYs.reserve(GameConstants::MAX_LINKED_WORD_PARTS);
+}
+
+GameSession::~GameSession() = default;
+
+void GameSession::setKeyListener(KeyListener listener) {
+    keyListener = std::move(listener);
+}
+
+void GameSession::start(const Settings& newSettings, uint64_t startMicros, std::unique_ptr<ParagraphView> paragraph) {
+    settings = newSettings;
+    activeWords.clear();
+    wordMatcher->clear();
+    matcherEntries.clear();
+    spawnCount = 0;
+    nextWordId = 0;
+    spawnAllocations = 0;
+    steadyStateSpawnAllocations = 0;
+    score = 0;
+    gameTime = 0;
+    wordSpawnTimer = 0;
+    scoreTimeline.clear();
+    gameStats = GameConstants::GameStats{};
+    typingStats.begin(startMicros);
+    over = false;
+
+    paragraphView = std::move(paragraph);
+    if (!paragraphView) {
+        for (int i = 0; i < 3; i++) spawnWord();
+    }
+}
+
+bool GameSession::update(float deltaTime, uint64_t nowMicros) {
+    if (over) return false;
+    gameTime += deltaTime;
+    wordSpawnTimer += deltaTime;
+
+    for (auto it = activeWords.begin(); it != activeWords.end(); ) {
+        if (!(*it)) {
+            it = activeWords.erase(it);
+            continue;
+        }
+        (*it)->update(deltaTime);
+        if ((*it)->getSpeed() > 0 && (*it)->isOutOfBoundsRight()) {
+            finish(nowMicros);
+            return false;
+        }
+        if ( (*it)->isOutOfBounds() && ( (*it)->getSpeed() < 0 || ((*it)->isComplete() && (*it)->isOutOfBounds()) ) ) {
+            if ((*it)->getSpeed() < 0 && !(*it)->isComplete()) {
+                score = std::max(0, score - GameConstants::MISTAKE_PENALTY);
+                gameStats.mistakesMade++;
+            }
+            it = activeWords.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    int completedThisFrame = 0;
+    int charsTypedThisFrame = 0;
+    int mistakesOnCompletedWordsThisFrame = 0;
+
+    activeWords.erase(std::remove_if(activeWords.begin(), activeWords.end(),
+                                     [&](PooledWord& word) {
+                                         if (!word) return false;
+                                         if (word->isComplete()) {
+                                             score += word->getText().length() * (word->isLinked() ? 2 : 1);
+                                             completedThisFrame++;
+                                             charsTypedThisFrame += word->getText().length();
+                                             mistakesOnCompletedWordsThisFrame += word->getMistakesCount();
+                                             return true;
+                                         }
+                                         return false;
+                                     }), activeWords.end());
+
+    gameStats.wordsTyped += completedThisFrame;
+    gameStats.charactersTyped += charsTypedThisFrame;
+    gameStats.mistakesMade += mistakesOnCompletedWordsThisFrame;
+    refreshTypingStats(nowMicros);
+
+    if (paragraphView) {
+        updateParagraph(deltaTime, completedThisFrame);
+        if (gameTime >= GameConstants::PARAGRAPH_MODE_DURATION || paragraphView->hasFailed()) {
+            finish(nowMicros);
+            return false;
+        }
+    }
+
+    float spawnInterval = GameConstants::WORD_SPAWN_INTERVAL / settings.spawnRateMultiplier;
+    if (!paragraphView && wordSpawnTimer >= spawnInterval) {
+        wordSpawnTimer = 0;
+        spawnWord();
+    }
+    if (isFreeTyping()) {
+        syncWordMatcher();
+    }
+
+    scoreTimeline.record(gameTime, score);
+    return true;
+}
+
+void GameSession::finish(uint64_t nowMicros) {
+    refreshTypingStats(nowMicros);
+    over = true;
+    paragraphView.reset(); // Stops its text stream
+}
+
+void GameSession::refreshTypingStats(uint64_t nowMicros) {
+    typingStats.advance(nowMicros);
+    gameStats.wordsPerMinute = typingStats.runNetWpm();
+    gameStats.rawWordsPerMinute = typingStats.runRawWpm();
+    gameStats.peakWordsPerMinute = typingStats.peakWpm();
+    gameStats.accuracy = typingStats.accuracy();
+}
+
+void GameSession::spawnWord() {
+    static const std::string fallbackWord = "fallback";
+    uint64_t allocationsBefore = AllocationCounter::getCount();
+    size_t createdBefore = wordPool.getCreatedCount();
+    spawnCount++;
+
+    const std::string* wordTextToSpawn = &sources.pickWord(randomGen);
+    if (wordTextToSpawn->empty() || *wordTextToSpawn == "error") {
+        wordTextToSpawn = &fallbackWord;
+    }
+
+    std::uniform_int_distribution<int> heightDist(100, GameConstants::WINDOW_HEIGHT - 150);
+    float speed = GameConstants::BASE_SPEED * settings.wordSpeedMultiplier;
+    unsigned int fontSize = settings.fontSize;
+    const sf::Font& fontToUse = sources.pickFont(randomGen);
+
+    bool makeLinked = settings.linkedWords && (std::uniform_int_distribution<int>(0, 100)(randomGen) < 30);
+    PooledWord spawned;
+
+    if (makeLinked) {
+        int wordCount = std::uniform_int_distribution<int>(2, std::min(GameConstants::MAX_LINKED_WORD_PARTS, 2 + score / 30))(randomGen);
+        while (spawnPartTexts.size() > static_cast<size_t>(wordCount)) {
+            spareSpawnParts.push_back(std::move(spawnPartTexts.back()));
+            spawnPartTexts.pop_back();
+        }
+        while (spawnPartTexts.size() < static_cast<size_t>(wordCount)) {
+            spawnPartTexts.push_back(std::move(spareSpawnParts.back()));
+            spareSpawnParts.pop_back();
+        }
+        spawnPartYs.clear();
+        float wordHeightEstimate = GlyphMetrics::get(fontToUse, fontSize).getLineSpacing();
+
+        for (int i = 0; i < wordCount; ++i) {
+            std::string& partText = spawnPartTexts[i];
+            partText = sources.pickWord(randomGen);
+            if(partText.empty() || partText == "error") partText = "lpart";
+
+            float attemptY;
+            int yAttempts = 0;
+            bool positionFound = false;
+
+            while(!positionFound && yAttempts < 15) {
+                attemptY = static_cast<float>(heightDist(randomGen));
+                bool collision = false;
+                for (const auto& existingWord : activeWords) {
+                    if (existingWord) {
+                        sf::FloatRect existingBounds = existingWord->getTypingBounds();
+                        if (attemptY < existingBounds.top + existingBounds.height && attemptY + wordHeightEstimate > existingBounds.top) {
+                            collision = true;
+                            break;
+                        }
+                    }
+                }
+                for (float prevY : spawnPartYs) {
+                    if (std::abs(prevY - attemptY) < wordHeightEstimate * 0.9f) {
+                        collision = true;
+                        break;
+                    }
+                }
+                if (!collision) positionFound = true;
+                yAttempts++;
+            }
+            if(!positionFound) {
+                attemptY = spawnPartYs.empty() ? static_cast<float>(heightDist(randomGen)) : (spawnPartYs.back() + wordHeightEstimate + 10.f);
+                if(attemptY > GameConstants::WINDOW_HEIGHT - wordHeightEstimate - 20.f) {
+                    attemptY = static_cast<float>(heightDist(randomGen));
+                } else if (attemptY < 50.f) {
+                    attemptY = 50.f;
+                }
+            }
+            spawnPartYs.push_back(attemptY);
+        }
+        if (spawnPartYs.empty()) {
+            spawnPartYs.push_back(static_cast<float>(heightDist(randomGen)));
+        }
+        if (spawnPartTexts.empty()){
+            spawnPartTexts.push_back("linkErr");
+        }
+        spawned = wordPool.acquireLinkedWord(spawnPartTexts, fontToUse, speed, sf::Vector2f(-150.f, spawnPartYs[0]), fontSize, spawnPartYs);
+    } else {
+        sf::Vector2f position(-100.f, static_cast<float>(heightDist(randomGen)));
+        spawned = wordPool.acquireWord(*wordTextToSpawn, fontToUse, speed, position, fontSize);
+    }
+    // Every active word came from the pool, so a spawn that reuses a word never grows this.
+    activeWords.reserve(wordPool.getCreatedCount());
+    activeWords.push_back(std::move(spawned));
+    activeWords.back()->setId(++nextWordId);
+    uint64_t allocations = AllocationCounter::getCount() - allocationsBefore;
+    spawnAllocations += allocations;
+    if (wordPool.getCreatedCount() == createdBefore) steadyStateSpawnAllocations += allocations;
+}
+
+void GameSession::updateParagraph(float deltaTime, int completedThisFrame) {
+    if (completedThisFrame > 0) {
+        paragraphView->advance();
+    }
+    paragraphView->update(deltaTime);
+
+    if (activeWords.empty()) {
+        if (const std::string* nextWord = paragraphView->getCurrentWord()) {
+            activeWords.push_back(wordPool.acquireWord(*nextWord, paragraphView->getFont(), 0.f, paragraphView->getCurrentWordPosition(),
+                                                       settings.fontSize));
+            activeWords.back()->setId(++nextWordId);
+        }
+    }
+    for (auto& word : activeWords) {
+        // The word stays selected even after Esc, so the first key of every word counts.
+        word->setAsActiveTypingTarget(true);
+        word->setPosition(paragraphView->getCurrentWordPosition());
+    }
+}
+
+void GameSession::reportKey(const KeyOutcome& outcome) {
+    if (!(outcome.flags & KeystrokeRecord::BACKSPACE)) {
+        typingStats.keyTyped(outcome.micros, (outcome.flags & KeystrokeRecord::CORRECT) != 0);
+    }
+    if (keyListener) keyListener(outcome);
+}
+
+void GameSession::recordTypedKey(const Word& word, const std::string& targetText, char typed, uint64_t micros) {
+    const TypedKey& key = word.getLastTypedKey();
+    KeyOutcome outcome;
+    outcome.typed = typed;
+    outcome.expected = key.expected;
+    outcome.previous = key.previous;
+    outcome.mistake = key.mistake;
+    outcome.wordId = word.getId();
+    outcome.flags = typed == 8 ? KeystrokeRecord::BACKSPACE : 0;
+    if (key.expected != 0 && !key.mistake) outcome.flags |= KeystrokeRecord::CORRECT;
+    outcome.targetText = &targetText;
+    outcome.micros = micros;
+    reportKey(outcome);
+}
+
+bool GameSession::isFreeTyping() const {
+    return settings.freeTyping && !paragraphView;
+}
+
+void GameSession::syncWordMatcher() {
+    // Register new words, follow linked words to their next part and drop words that are gone.
+    // This runs once per frame, so keystrokes never pay for spawns and removals.
+    ++matcherSyncStamp;
+    for (const auto& word : activeWords) {
+        if (!word || word->isComplete()) continue;
+        auto [it, inserted] = matcherEntries.try_emplace(word.get());
+        MatcherEntry& entry = it->second;
+        if (!inserted && entry.text != word->getText()) {
+            wordMatcher->removeText(entry.text);
+            inserted = true;
+        }
+        if (inserted) {
+            entry.text = word->getText();
+            wordMatcher->addText(entry.text);
+        }
+        entry.seenStamp = matcherSyncStamp;
+    }
+    for (auto it = matcherEntries.begin(); it != matcherEntries.end(); ) {
+        if (it->second.seenStamp != matcherSyncStamp) {
+            wordMatcher->removeText(it->second.text);
+            it = matcherEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    wordMatcher->refresh(); // Catches the typed stream up here rather than on the next keystroke
+}
+
+void GameSession::processFreeTypingKey(char typed, uint64_t micros) {
+    KeyOutcome outcome;
+    outcome.typed = typed;
+    outcome.micros = micros;
+    if (typed == 8) {
+        wordMatcher->unfeed();
+        outcome.flags = KeystrokeRecord::FREE_TYPING | KeystrokeRecord::BACKSPACE;
+        reportKey(outcome);
+        return;
+    }
+
+    bool completedAny = false;
+    uint32_t completedWordId = 0;
+    for (const std::string* matchedText : wordMatcher->feed(typed)) {
+        // Several words may share a text; finish the one closest to escaping, as targeting does.
+        Word* target = nullptr;
+        for (auto& word : activeWords) {
+            if (word && !word->isComplete() && word->getText() == *matchedText &&
+                (!target || word->getPosition().x > target->getPosition().x)) {
+                target = word.get();
+            }
+        }
+        if (!target) continue;
+
+        // Replay the text through the word so linked words advance exactly as if it had been typed.
+        const std::string part = *matchedText;
+        target->clearCurrentInput();
+        for (char c : part) {
+            target->processInput(static_cast<unsigned char>(c), settings.highlightTyping);
+        }
+        if (!completedAny) completedWordId = target->getId();
+        completedAny = true;
+    }
+    outcome.wordId = completedWordId;
+    outcome.flags = KeystrokeRecord::FREE_TYPING;
+    // CORRECT in the keystroke log means the key completed a word; for the typing stats a key
+    // is also correct if the stream still ends inside some word's text.
+    if (completedAny) {
+        outcome.flags |= KeystrokeRecord::CORRECT;
+    }
+    if (keyListener) keyListener(outcome);
+    typingStats.keyTyped(micros, completedAny || wordMatcher->isStreamInText());
+    if (completedAny) {
+        wordMatcher->resetStream();
+    }
+}
+
+void GameSession::processText(sf::Uint32 unicode, uint64_t micros) {
+    if (over || ((unicode < 32 || unicode > 126) && unicode != 8)) {
+        return;
+    }
+    char typed = static_cast<char>(unicode);
+    if (isFreeTyping()) {
+        processFreeTypingKey(typed, micros);
+        return;
+    }
+
+    Word* wordBeingTyped = nullptr;
+    for (auto& word : activeWords) {
+        if (word && word->isBeingActivelyTyped() && !word->isComplete()) {
+            wordBeingTyped = word.get();
+            break;
+        }
+    }
+
+    if (wordBeingTyped && paragraphView && unicode == ' ' && wordBeingTyped->getCurrentInput().empty()) {
+        return; // Habitual space between paragraph words; the next word is already selected
+    }
+
+    if (wordBeingTyped) {
+        // getText() refers to storage the key cannot change: a linked word moving on to its next
+        // part switches which of its part strings it returns.
+        const std::string& targetText = wordBeingTyped->getText();
+        wordBeingTyped->processInput(unicode, settings.highlightTyping);
+        recordTypedKey(*wordBeingTyped, targetText, typed, micros);
+    } else if (unicode != 8) {
+        std::vector<Word*>& matchingWords = keyCandidates;
+        matchingWords.clear();
+        char firstCharTyped = static_cast<char>(tolower(unicode));
+
+        for (auto& word : activeWords) {
+            if (word && !word->isComplete() && !word->getText().empty() &&
+                tolower(word->getText()[0]) == firstCharTyped) {
+                matchingWords.push_back(word.get());
+            }
+        }
+
+        if (!matchingWords.empty()) {
+            std::sort(matchingWords.begin(), matchingWords.end(), [](const Word* a, const Word* b) {
+                if (!a) return false;
+                if (!b) return true;
+                return a->getPosition().x > b->getPosition().x;
+            });
+
+            for(auto& w : activeWords) {
+                if(w && w.get() != matchingWords[0]) {
+                    w->setAsActiveTypingTarget(false);
+                }
+            }
+            matchingWords[0]->setAsActiveTypingTarget(true);
+            const std::string& targetText = matchingWords[0]->getText();
+            matchingWords[0]->processInput(unicode, settings.highlightTyping);
+            recordTypedKey(*matchingWords[0], targetText, typed, micros);
+        } else {
+            KeyOutcome outcome;
+            outcome.typed = typed;
+            outcome.flags = KeystrokeRecord::UNTARGETED;
+            outcome.micros = micros;
+            reportKey(outcome);
+        }
+    } else {
+        KeyOutcome outcome;
+        outcome.typed = 8;
+        outcome.flags = KeystrokeRecord::BACKSPACE | KeystrokeRecord::UNTARGETED;
+        outcome.micros = micros;
+        reportKey(outcome);
+    }
+}
+
+void GameSession::cancelTyping() {
+    if (isFreeTyping()) {
+        wordMatcher->resetStream();
+        return;
+    }
+    for (auto& word : activeWords) {
+        if (word && word->isBeingActivelyTyped()) {
+            word->resetTyping();
+            break;
+        }
+    }
+}
+
+bool GameSession::isOver() const { return over; }
+const std::vector<PooledWord>& GameSession::getActiveWords() const { return activeWords; }
+const ParagraphView* GameSession::getParagraphView() const { return paragraphView.get(); }
+const std::string& GameSession::getFreeTypingInput() const { return wordMatcher->getRecentInput(); }
+const GameSession::Settings& GameSession::getSettings() const { return settings; }
+int GameSession::getScore() const { return score; }
+float GameSession::getGameTime() const { return gameTime; }
+const GameConstants::GameStats& GameSession::getGameStats() const { return gameStats; }
+const ScoreTimeline& GameSession::getScoreTimeline() const { return scoreTimeline; }
+const TypingStatsEngine& GameSession::getTypingStats() const { return typingStats; }
+size_t GameSession::getSpawnCount() const { return spawnCount; }
+uint64_t GameSession::getSpawnAllocations() const { return spawnAllocations; }
+
+uint64_t GameSession::getSteadyStateSpawnAllocations() const { return steadyStateSpawnAllocations; }
+const WordPool& GameSession::getWordPool() const { return wordPool; }
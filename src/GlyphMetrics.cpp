@@ -0,0 +1,107 @@
+#include "../include/GlyphMetrics.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+
+GlyphMetrics::GlyphMetrics(const sf::Font& font, unsigned int characterSize)
+        : kerningPairs(static_cast<size_t>(CHAR_COUNT) * CHAR_COUNT, 0.f),
+          lineSpacing(font.getLineSpacing(characterSize)), textTop(0.f), textHeight(0.f) {
+    // sf::Text puts the baseline 'characterSize' pixels below its position.
+    float highest = 0.f;
+    float lowest = 0.f;
+    for (int i = 0; i < CHAR_COUNT; ++i) {
+        const sf::Glyph& glyph = font.getGlyph(static_cast<sf::Uint32>(FIRST_CHAR + i), characterSize, false);
+        advances[i] = glyph.advance;
+        highest = std::min(highest, glyph.bounds.top);
+        lowest = std::max(lowest, glyph.bounds.top + glyph.bounds.height);
+    }
+    textTop = static_cast<float>(characterSize) + highest;
+    textHeight = lowest - highest;
+    for (int first = 0; first < CHAR_COUNT; ++first) {
+        for (int second = 0; second < CHAR_COUNT; ++second) {
+            kerningPairs[static_cast<size_t>(first) * CHAR_COUNT + second] =
+                    font.getKerning(static_cast<sf::Uint32>(FIRST_CHAR + first), static_cast<sf::Uint32>(FIRST_CHAR + second), characterSize);
+        }
+    }
+}
+
+GlyphMetrics::GlyphMetrics(unsigned int characterSize)
+        : kerningPairs(static_cast<size_t>(CHAR_COUNT) * CHAR_COUNT, 0.f) {
+    // Proportions of a typical monospace font.
+    float size = static_cast<float>(characterSize);
+    advances.fill(size * 0.6f);
+    lineSpacing = size * 1.2f;
+    textTop = size * 0.1f;
+    textHeight = size * 1.1f;
+}
+
+namespace {
+    // Keyed by font address: FontManager keeps replaced fonts alive while words may draw them
+    // and calls forget() before releasing one, so references stay valid while they are used.
+    std::map<std::pair<const sf::Font*, unsigned int>, std::unique_ptr<GlyphMetrics>> metricsCache;
+    std::mutex metricsCacheMutex;
+}
+
+const GlyphMetrics& GlyphMetrics::get(const sf::Font& font, unsigned int characterSize) {
+    std::lock_guard<std::mutex> lock(metricsCacheMutex);
+    auto& entry = metricsCache[{&font, characterSize}];
+    if (!entry) {
+        entry = std::make_unique<GlyphMetrics>(font, characterSize);
+    }
+    return *entry;
+}
+
+void GlyphMetrics::registerMonospace(const sf::Font& font, unsigned int characterSize) {
+    std::lock_guard<std::mutex> lock(metricsCacheMutex);
+    auto& entry = metricsCache[{&font, characterSize}];
+    if (!entry) {
+        entry.reset(new GlyphMetrics(characterSize));
+    }
+}
+
+void GlyphMetrics::forget(const sf::Font& font) {
+    std::lock_guard<std::mutex> lock(metricsCacheMutex);
+    auto it = metricsCache.lower_bound({&font, 0u});
+    while (it != metricsCache.end() && it->first.first == &font) {
+        it = metricsCache.erase(it);
+    }
+}
+
+int GlyphMetrics::slot(char c) {
+    int index = static_cast<unsigned char>(c) - FIRST_CHAR;
+    return (index >= 0 && index < CHAR_COUNT) ? index : '?' - FIRST_CHAR;
+}
+
+float GlyphMetrics::measure(std::string_view text) const {
+    float width = 0.f;
+    int previous = -1;
+    for (char c : text) {
+        int current = slot(c);
+        if (previous >= 0) width += kerningPairs[static_cast<size_t>(previous) * CHAR_COUNT + current];
+        width += advances[current];
+        previous = current;
+    }
+    return width;
+}
+
+float GlyphMetrics::advance(char c) const {
+    return advances[slot(c)];
+}
+
+float GlyphMetrics::kerning(char first, char second) const {
+    return kerningPairs[static_cast<size_t>(slot(first)) * CHAR_COUNT + slot(second)];
+}
+
+float GlyphMetrics::getLineSpacing() const {
+    return lineSpacing;
+}
+
+float GlyphMetrics::getTextTop() const {
+    return textTop;
+}
+
+float GlyphMetrics::getTextHeight() const {
+    return textHeight;
+}
@@ -0,0 +1,108 @@
+#include "../include/HeadlessGame.h"
+#include "../include/GlyphMetrics.h"
+#include "../include/ParagraphView.h"
+#include "../include/StreamingWordSource.h"
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+bool HeadlessGame::WordSupply::forWordSet(const WordDatabaseManager& wordDb, size_t setIndex, WordSupply& out) {
+    out = WordSupply();
+    if (const StreamingWordSource* stream = wordDb.getStreamingSource(setIndex)) {
+        // Published samples are never empty, so once one exists every draw succeeds.
+        while (true) {
+            auto snapshot = stream->getSnapshot();
+            if (snapshot && !snapshot->empty()) break;
+            if (stream->hasFailed()) {
+                fmt::print(stderr, "Error: Streamed word set '{}' has no words.\n", stream->getFilePath());
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        out.stream = stream;
+        return true;
+    }
+    const auto& wordSets = wordDb.getAllWordSets();
+    if (setIndex >= wordSets.size() || wordSets[setIndex].empty()) {
+        fmt::print(stderr, "Error: No words loaded to play with.\n");
+        return false;
+    }
+    out.words = &wordSets[setIndex];
+    return true;
+}
+
+bool HeadlessGame::WordSupply::draw(std::mt19937& randomGen, std::string& out) const {
+    if (stream) return stream->drawWord(randomGen, out);
+    if (!words || words->empty()) return false;
+    out = (*words)[std::uniform_int_distribution<size_t>(0, words->size() - 1)(randomGen)];
+    return true;
+}
+
+HeadlessGame::HeadlessGame(const WordSupply& supply, const std::string& wordSetName, uint32_t seed)
+        : wordSetName(wordSetName), seedGen(seed),
+          session(GameSession::Sources{
+                  [supply, word = std::string(GameConstants::MAX_WORD_LENGTH, ' ')](std::mt19937& randomGen) mutable -> const std::string& {
+                      supply.draw(randomGen, word); // Cannot fail on a supply with words
+                      return word;
+                  },
+                  [](std::mt19937&) -> const sf::Font& { return placeholderFont(); }},
+                  static_cast<uint32_t>(seedGen())) {
+}
+
+const sf::Font& HeadlessGame::placeholderFont() {
+    // Never loaded: its metrics come from GlyphMetrics::registerMonospace.
+    static const sf::Font font;
+    return font;
+}
+
+RunRecord HeadlessGame::play(const GameSession::Settings& settings, const TypistBot::Profile& profile, float maxSeconds) {
+    GlyphMetrics::registerMonospace(placeholderFont(), settings.fontSize);
+    TypistBot bot(profile, static_cast<uint32_t>(seedGen()));
+
+    const float step = GameConstants::HEADLESS_STEP_SECONDS;
+    const uint64_t stepMicros = static_cast<uint64_t>(std::lround(step * 1e6f));
+    uint64_t nowMicros = 0;
+    session.start(settings, nowMicros);
+
+    bool running = true;
+    while (running) {
+        auto stepStart = std::chrono::steady_clock::now();
+        nowMicros += stepMicros;
+        sf::Event event;
+        float lateBy = 0.f;
+        // Bot keys take the path of TextEntered events in the windowed game.
+        if (bot.update(session, step, event, lateBy) && event.type == sf::Event::TextEntered) {
+            session.processText(event.text.unicode, nowMicros - static_cast<uint64_t>(lateBy * 1e6f));
+        }
+        running = session.update(step, nowMicros) && session.getGameTime() < maxSeconds;
+
+        uint64_t nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - stepStart).count());
+        timings.steps++;
+        timings.totalNanos += nanos;
+        timings.maxNanos = std::max(timings.maxNanos, nanos);
+    }
+
+    RunRecord run;
+    run.finishedAt = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    run.score = session.getScore();
+    run.gameTime = session.getGameTime();
+    run.stats = session.getGameStats();
+    session.getScoreTimeline().copyPoints(run.history);
+    run.config.wordSpeedPercent = static_cast<uint16_t>(std::lround(settings.wordSpeedMultiplier * 100.f));
+    run.config.spawnRatePercent = static_cast<uint16_t>(std::lround(settings.spawnRateMultiplier * 100.f));
+    if (settings.linkedWords) run.config.flags |= RunConfig::LINKED_WORDS;
+    if (settings.freeTyping) run.config.flags |= RunConfig::FREE_TYPING;
+    run.config.wordSet = wordSetName;
+    return run;
+}
+
+const GameSession& HeadlessGame::getSession() const {
+    return session;
+}
+
+const HeadlessGame::StepTimings& HeadlessGame::getStepTimings() const {
+    return timings;
+}
@@ -1,15 +1,69 @@
 #include "../include/HighScoreManager.h"
+#include "../include/PersistenceWorker.h"
 #include <fstream>
 #include <fmt/core.h>
 #include <sstream> // For parsing score history lines
 #include <algorithm> // For std::sort
-#include <tuple>     // For std::tuple
 
-HighScoreManager::HighScoreManager() {}
+HighScoreManager::HighScoreManager(PersistenceWorker& persistence, size_t capacity)
+        : persistence(persistence), leaderboards(capacity) {}
 
-void HighScoreManager::loadHighScores(const std::string& filePath) {
-    highScores.clear();
-    highScoreHistories.clear();
+HighScoreManager::~HighScoreManager() {
+    persistence.flush(); // Queued commits point at runLog
+}
+
+void HighScoreManager::scheduleCommit() {
+    RunLog* log = runLog.get();
+    persistence.post("runlog", [log] { log->commit(); });
+}
+
+void HighScoreManager::loadHighScores(const std::string& logPath, const std::string& indexPath, const std::string& legacyTextPath) {
+    persistence.flush();
+    leaderboards.clear();
+    cachedHistoryRunId = 0;
+    runLog = std::make_unique<RunLog>(logPath, indexPath);
+    if (!runLog->open()) {
+        runLog.reset();
+        return;
+    }
+    if (runLog->getEntries().empty()) {
+        importLegacyHighScores(legacyTextPath);
+        runLog->commit(); // Names are read back below
+    }
+
+    // Only named runs are leaderboard entries. Histories stay in the log; names are read here, and
+    // one run per configuration is read for the partition's label.
+    std::string name;
+    RunRecord run;
+    for (const auto& entry : runLog->getEntries()) {
+        if (entry.nameOffset == 0 || !leaderboards.qualifies(entry.configHash, entry.score)) continue;
+        if (!runLog->readName(entry.nameOffset, name)) {
+            fmt::print(stderr, "Warning: Unreadable name for run at offset {} in '{}'.\n", entry.runOffset, logPath);
+            continue;
+        }
+        size_t partition = leaderboards.findPartition(entry.configHash);
+        if (partition == LeaderboardStore::NO_PARTITION) {
+            std::string label = runLog->readRun(entry.runOffset, run) ? run.config.label() : RunConfig{}.label();
+            partition = leaderboards.partitionOf(entry.configHash, label);
+        }
+        leaderboards.insert(partition, name, entry.score, entry.runOffset);
+    }
+}
+
+uint64_t HighScoreManager::recordRun(const RunRecord& run) {
+    if (!runLog) return 0;
+    uint64_t runId = runLog->appendRun(run);
+    if (runId != 0) scheduleCommit();
+    return runId;
+}
+
+bool HighScoreManager::isRunRecorded(int64_t startedAt, const RunConfig& config) {
+    return runLog && runLog->containsRun(startedAt, config);
+}
+
+void HighScoreManager::importLegacyHighScores(const std::string& filePath) {
+    std::vector<std::pair<std::string, int>> legacyScores;
+    std::vector<std::vector<ScorePoint>> legacyHistories;
     std::ifstream file(filePath);
     if (file.is_open()) {
         std::string line;
@@ -51,7 +105,7 @@ void HighScoreManager::loadHighScores(const std::string& filePath) {
                 continue;
             }
 
-            highScores.emplace_back(fullName, scoreVal);
+            legacyScores.emplace_back(fullName, scoreVal);
 
             // Read score history for this entry (next line)
             std::vector<ScorePoint> history;
@@ -74,110 +128,70 @@ void HighScoreManager::loadHighScores(const std::string& filePath) {
             } else {
                 fmt::print(stderr, "Warning: Missing score history line for '{}'.\n", fullName);
             }
-            highScoreHistories.push_back(history);
+            legacyHistories.push_back(history);
         }
         file.close();
-
-    } else {
-        fmt::print("High scores file '{}' not found. No scores loaded.\n", filePath);
     }
-
-    // Sort scores and their corresponding histories together
-    std::vector<std::tuple<int, std::string, std::vector<ScorePoint>>> sortableScores;
-    for(size_t i = 0; i < highScores.size(); ++i) {
-        if (i < highScoreHistories.size()) {
-            sortableScores.emplace_back(highScores[i].second, highScores[i].first, highScoreHistories[i]);
-        } else {
-            sortableScores.emplace_back(highScores[i].second, highScores[i].first, std::vector<ScorePoint>());
-            fmt::print(stderr, "Warning: Mismatch between scores and histories count during loading. Score '{}' assigned empty history.\n", highScores[i].first);
-        }
-    }
-
-    // Sort by score descending (std::get<0> is the score)
-    std::sort(sortableScores.begin(), sortableScores.end(), [](const auto& a, const auto& b) {
-        return std::get<0>(a) > std::get<0>(b);
-    });
-
-    // Rebuild the primary vectors from the sorted data
-    highScores.clear();
-    highScoreHistories.clear();
-    for(const auto& entry : sortableScores) {
-        highScores.emplace_back(std::get<1>(entry), std::get<0>(entry)); // name, score
-        highScoreHistories.push_back(std::get<2>(entry));                       // history
-    }
-
-    // Trim to MAX_HIGH_SCORES
-    if (highScores.size() > MAX_HIGH_SCORES) {
-        highScores.resize(MAX_HIGH_SCORES);
-        highScoreHistories.resize(MAX_HIGH_SCORES);
+    if (legacyScores.empty()) return;
+
+    for (size_t i = 0; i < legacyScores.size(); ++i) {
+        RunRecord run;
+        run.score = legacyScores[i].second;
+        if (i < legacyHistories.size()) run.history = legacyHistories[i];
+        if (!run.history.empty()) run.gameTime = run.history.back().timeStamp;
+        uint64_t runId = runLog->appendRun(run);
+        if (runId != 0) runLog->nameRun(runId, legacyScores[i].first);
     }
+    fmt::print("Imported {} high scores from '{}' into the run log.\n", legacyScores.size(), filePath);
 }
 
-void HighScoreManager::saveHighScores(const std::string& filePath) {
-    std::ofstream file(filePath);
-    if (file.is_open()) {
-        for (size_t i = 0; i < highScores.size(); ++i) {
-            file << highScores[i].first << " " << highScores[i].second << "\n";
-            // Save score history for this entry
-            if (i < highScoreHistories.size()) {
-                for(const auto& point : highScoreHistories[i]) {
-                    file << point.timeStamp << ":" << point.score << " ";
-                }
-            } else {
-                fmt::print(stderr, "Warning: Missing history for score '{}' during save.\n", highScores[i].first);
-            }
-            file << "\n";
-        }
-        file.close();
-    } else {
-        fmt::print(stderr, "Error: Could not open high scores file '{}' for saving.\n", filePath);
+size_t HighScoreManager::addHighScore(uint64_t runId, const std::string& name, int score, const RunConfig& config) {
+    if (runLog && runId != 0 && runLog->nameRun(runId, name)) {
+        scheduleCommit();
     }
+    size_t partition = leaderboards.partitionOf(config.hash(), config.label());
+    return leaderboards.insert(partition, name, score, runId);
 }
 
-void HighScoreManager::addHighScore(const std::string& name, int score, const std::deque<ScorePoint>& currentScoreHistory) {
-    std::vector<ScorePoint> historyVec(currentScoreHistory.begin(), currentScoreHistory.end());
-
-    // Don't add directly to highScores but create a tuple for the new entry and add it to a temporary list with existing scores.
-    std::vector<std::tuple<int, std::string, std::vector<ScorePoint>>> allEntries;
-    for (size_t i = 0; i < highScores.size(); ++i) {
-        if (i < highScoreHistories.size()) {
-            allEntries.emplace_back(highScores[i].second, highScores[i].first, highScoreHistories[i]);
-        } else {
-            allEntries.emplace_back(highScores[i].second, highScores[i].first, std::vector<ScorePoint>());
-        }
-    }
-    // Add the new entry
-    allEntries.emplace_back(score, name, historyVec);
+bool HighScoreManager::qualifies(const RunConfig& config, int score) const {
+    return leaderboards.qualifies(config.hash(), score);
+}
 
+size_t HighScoreManager::getPartitionCount() const {
+    return leaderboards.getPartitionCount();
+}
 
-    std::sort(allEntries.begin(), allEntries.end(), [](const auto& a, const auto& b) {
-        return std::get<0>(a) > std::get<0>(b);
-    });
+const std::string& HighScoreManager::getPartitionLabel(size_t partition) const {
+    return leaderboards.getLabel(partition);
+}
 
-    // Rebuild the main vectors from the sorted temporary structure
-    highScores.clear();
-    highScoreHistories.clear();
-    for (const auto& entry : allEntries) {
-        highScores.emplace_back(std::get<1>(entry), std::get<0>(entry)); // name, score
-        highScoreHistories.push_back(std::get<2>(entry));                       // history
-    }
+size_t HighScoreManager::findPartition(const RunConfig& config) const {
+    return leaderboards.findPartition(config.hash());
+}
 
-    // Keep only top N
-    if (highScores.size() > MAX_HIGH_SCORES) {
-        highScores.resize(MAX_HIGH_SCORES);
-        highScoreHistories.resize(MAX_HIGH_SCORES);
-    }
+size_t HighScoreManager::getHighScoreCount(size_t partition) const {
+    return leaderboards.getBoard(partition).size();
 }
 
-const std::vector<std::pair<std::string, int>>& HighScoreManager::getHighScores() const {
-    return highScores;
+const Leaderboard::Entry& HighScoreManager::getHighScore(size_t partition, size_t rank) const {
+    return leaderboards.getBoard(partition).at(rank);
 }
 
-const std::vector<ScorePoint>& HighScoreManager::getScoreHistory(size_t index) const {
+const std::vector<ScorePoint>& HighScoreManager::getScoreHistory(size_t partition, size_t rank) const {
     static const std::vector<ScorePoint> emptyHistory;
-    if (index < highScoreHistories.size()) {
-        return highScoreHistories[index];
+    if (partition >= leaderboards.getPartitionCount() || rank >= leaderboards.getBoard(partition).size()) {
+        fmt::print(stderr, "Warning: Requested score history for out-of-bounds index {}.\n", rank);
+        return emptyHistory;
     }
-    fmt::print(stderr, "Warning: Requested score history for out-of-bounds index {}.\n", index);
-    return emptyHistory;
-}
\ No newline at end of file
+    uint64_t runId = leaderboards.getBoard(partition).at(rank).runId;
+    if (runId != cachedHistoryRunId) {
+        RunRecord run;
+        cachedHistory.clear();
+        cachedHistoryRunId = 0;
+        if (runLog && runId != 0 && runLog->readRun(runId, run)) {
+            cachedHistory = std::move(run.history);
+            cachedHistoryRunId = runId; // A run still waiting for its commit is retried next time
+        }
+    }
+    return cachedHistory;
+}
@@ -0,0 +1,49 @@
+#include "../include/InputLatencyMeter.h"
+#include <chrono>
+#include <algorithm>
+
+uint64_t InputLatencyMeter::nowMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+InputLatencyMeter::InputLatencyMeter() {
+    latencies.reserve(GameConstants::INPUT_LATENCY_RESERVED_SAMPLES);
+    scratch.reserve(GameConstants::INPUT_LATENCY_RESERVED_SAMPLES);
+}
+
+void InputLatencyMeter::reset() {
+    pendingCount = 0;
+    latencies.clear();
+    summary = InputLatencySummary{};
+}
+
+void InputLatencyMeter::keyDelivered(uint64_t deliveredMicros) {
+    // More keys than this in one frame means the game is stalled; the excess goes unmeasured.
+    if (pendingCount < pending.size()) pending[pendingCount++] = deliveredMicros;
+}
+
+void InputLatencyMeter::framePresented(uint64_t presentedMicros) {
+    for (size_t i = 0; i < pendingCount; ++i) {
+        uint64_t latency = presentedMicros > pending[i] ? presentedMicros - pending[i] : 0;
+        latencies.push_back(static_cast<uint32_t>(std::min<uint64_t>(latency, UINT32_MAX)));
+    }
+    pendingCount = 0;
+}
+
+const InputLatencySummary& InputLatencyMeter::summarize() {
+    if (summary.samples == latencies.size()) return summary;
+    scratch.assign(latencies.begin(), latencies.end());
+    summary.samples = static_cast<uint32_t>(latencies.size());
+    summary.p50Ms = percentileMs(0.50f);
+    summary.p95Ms = percentileMs(0.95f);
+    summary.p99Ms = percentileMs(0.99f);
+    return summary;
+}
+
+float InputLatencyMeter::percentileMs(float fraction) {
+    // Nearest rank; nth_element keeps this linear, cheap enough to refresh the overlay every frame.
+    auto rank = std::min(scratch.size() - 1, static_cast<size_t>(fraction * (scratch.size() - 1) + 0.5f));
+    std::nth_element(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(rank), scratch.end());
+    return scratch[rank] / 1000.f;
+}
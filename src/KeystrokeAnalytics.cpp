@@ -0,0 +1,476 @@
+#include "../include/KeystrokeAnalytics.h"
+#include "../include/PersistenceWorker.h"
+#include "../include/Crc32.h"
+#include "../include/BinaryIO.h"
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+
+namespace {
+    constexpr char CACHE_MAGIC[4] = {'M', 'T', 'K', 'A'};
+    constexpr uint32_t CACHE_VERSION = 1;
+    constexpr uint8_t INVALID_KIND = 0xFF; // Records of a damaged block; they also break n-gram context
+    constexpr uint8_t UNCOUNTED_KEY = KeystrokeRecord::BACKSPACE | KeystrokeRecord::UNTARGETED | KeystrokeRecord::FREE_TYPING;
+
+    size_t bucketOf(uint32_t micros) {
+        uint32_t ms = micros / 1000;
+        if (ms < 8) return ms;
+        uint32_t octave = 3;
+        while ((ms >> (octave + 1)) != 0) ++octave;
+        size_t index = 8 + (octave - 3) * 4 + ((ms >> (octave - 2)) & 3);
+        return std::min(index, LatencyStats::BUCKETS - 1);
+    }
+
+    float bucketLowerMs(size_t index) {
+        if (index < 8) return static_cast<float>(index);
+        size_t octave = (index - 8) / 4 + 3;
+        size_t sub = (index - 8) % 4;
+        return static_cast<float>((4 + sub) << (octave - 2));
+    }
+
+    // Runs work(chunk, first, last) over [0, count) on up to one thread per core, or inline when
+    // there is too little work to be worth the threads.
+    template <typename Work>
+    size_t forEachChunk(size_t count, size_t grain, Work&& work) {
+        size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunks = std::min(cores, (count + grain - 1) / std::max<size_t>(grain, 1));
+        if (chunks <= 1) {
+            work(0, 0, count);
+            return 1;
+        }
+        std::vector<std::thread> threads;
+        size_t perChunk = (count + chunks - 1) / chunks;
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            size_t first = std::min(count, chunk * perChunk);
+            size_t last = std::min(count, first + perChunk);
+            threads.emplace_back([&work, chunk, first, last] { work(chunk, first, last); });
+        }
+        for (auto& thread : threads) thread.join();
+        return chunks;
+    }
+
+    void putStats(std::string& out, const LatencyStats& stats) {
+        put(out, stats.keys);
+        put(out, stats.errors);
+        put(out, stats.samples);
+        put(out, stats.latencySumMicros);
+        put(out, stats.histogram);
+    }
+
+    bool getStats(const unsigned char*& cursor, const unsigned char* end, LatencyStats& stats) {
+        return get(cursor, end, stats.keys) && get(cursor, end, stats.errors) && get(cursor, end, stats.samples) &&
+               get(cursor, end, stats.latencySumMicros) && get(cursor, end, stats.histogram);
+    }
+
+    void putRun(std::string& out, const RunTypingSummary& run) {
+        put(out, run.startedAt);
+        put(out, run.runId);
+        put(out, run.keys);
+        put(out, run.errors);
+        put(out, run.samples);
+        put(out, run.latencySumMicros);
+    }
+
+    bool getRun(const unsigned char*& cursor, const unsigned char* end, RunTypingSummary& run) {
+        return get(cursor, end, run.startedAt) && get(cursor, end, run.runId) && get(cursor, end, run.keys) &&
+               get(cursor, end, run.errors) && get(cursor, end, run.samples) && get(cursor, end, run.latencySumMicros);
+    }
+}
+
+void LatencyStats::addLatency(uint32_t micros) {
+    ++samples;
+    latencySumMicros += micros;
+    ++histogram[bucketOf(micros)];
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+    keys += other.keys;
+    errors += other.errors;
+    samples += other.samples;
+    latencySumMicros += other.latencySumMicros;
+    for (size_t i = 0; i < BUCKETS; ++i) histogram[i] += other.histogram[i];
+}
+
+float LatencyStats::meanMs() const {
+    return samples ? static_cast<float>(latencySumMicros / 1000.0 / samples) : 0.f;
+}
+
+float LatencyStats::percentileMs(float fraction) const {
+    if (samples == 0) return 0.f;
+    float target = fraction * samples;
+    uint32_t before = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        if (histogram[i] > 0 && before + histogram[i] >= target) {
+            float lower = bucketLowerMs(i);
+            float upper = bucketLowerMs(i + 1);
+            return lower + (upper - lower) * (target - before) / histogram[i];
+        }
+        before += histogram[i];
+    }
+    return bucketLowerMs(BUCKETS);
+}
+
+float LatencyStats::errorRate() const {
+    return keys ? static_cast<float>(errors) / keys : 0.f;
+}
+
+float RunTypingSummary::meanMs() const {
+    return samples ? static_cast<float>(latencySumMicros / 1000.0 / samples) : 0.f;
+}
+
+KeystrokeAnalytics::Tables::Tables() : characters(CHARACTERS), bigrams(CHARACTERS * CHARACTERS) {}
+
+void KeystrokeAnalytics::Tables::merge(const Tables& other) {
+    overall.merge(other.overall);
+    for (size_t i = 0; i < characters.size(); ++i) characters[i].merge(other.characters[i]);
+    for (size_t i = 0; i < bigrams.size(); ++i) {
+        if (other.bigrams[i].keys > 0) bigrams[i].merge(other.bigrams[i]);
+    }
+    for (const auto& [key, stats] : other.trigrams) trigrams[key].merge(stats);
+}
+
+void KeystrokeAnalytics::Columns::resize(size_t size) {
+    kind.resize(size);
+    flags.resize(size);
+    expected.resize(size);
+    latency.resize(size);
+    value.resize(size);
+}
+
+KeystrokeAnalytics::KeystrokeAnalytics(const std::string& logPath, const std::string& cachePath)
+        : logPath(logPath), cachePath(cachePath) {
+    reset();
+}
+
+void KeystrokeAnalytics::reset() {
+    totals = Tables();
+    runs.clear();
+    openRun = RunTypingSummary{};
+    runOpen = false;
+    coveredOffset = KeystrokeLog::HEADER_SIZE;
+    logIdentity = 0;
+    context.fill(KeystrokeRecord{});
+}
+
+size_t KeystrokeAnalytics::refresh(PersistenceWorker& worker) {
+    auto started = std::chrono::steady_clock::now();
+    if (!cacheLoaded) {
+        cacheLoaded = true;
+        if (!loadCache()) reset();
+    }
+
+    MappedFile file;
+    if (!file.map(logPath) || !KeystrokeLog::checkHeader(file.data(), file.size())) return 0;
+    const unsigned char* base = file.data();
+    const unsigned char* end = base + file.size();
+    bool hasBlock = file.size() >= KeystrokeLog::HEADER_SIZE + KeystrokeLog::BLOCK_HEADER_SIZE;
+    uint32_t identity = hasBlock ? crc32(base + KeystrokeLog::HEADER_SIZE, KeystrokeLog::BLOCK_HEADER_SIZE) : 0;
+    if (coveredOffset > KeystrokeLog::HEADER_SIZE && (file.size() < coveredOffset || identity != logIdentity)) {
+        fmt::print("KeystrokeAnalytics: '{}' was replaced; rebuilding statistics.\n", logPath);
+        reset();
+    }
+
+    // Block headers are walked sequentially (they chain by size); everything else is split by block.
+    std::vector<KeystrokeLog::Block> blocks;
+    std::vector<size_t> firstRecord;
+    size_t recordCount = 0;
+    KeystrokeLog::Block block;
+    for (const unsigned char* at = base + coveredOffset; KeystrokeLog::readBlock(at, end, block); at = block.payload + block.payloadSize) {
+        blocks.push_back(block);
+        firstRecord.push_back(CONTEXT_RECORDS + recordCount);
+        recordCount += block.recordCount;
+    }
+    if (blocks.empty()) return 0;
+
+    columns.resize(CONTEXT_RECORDS + recordCount);
+    for (size_t i = 0; i < CONTEXT_RECORDS; ++i) {
+        columns.kind[i] = context[i].kind;
+        columns.flags[i] = context[i].flags;
+        columns.expected[i] = static_cast<uint8_t>(context[i].expected);
+        columns.latency[i] = context[i].sincePreviousMicros;
+        columns.value[i] = context[i].value;
+    }
+
+    std::vector<uint8_t> blockIntact(blocks.size(), 0);
+    size_t grainBlocks = std::max<size_t>(1, blocks.size() * GameConstants::KEYSTROKE_PARALLEL_GRAIN / std::max<size_t>(recordCount, 1));
+    forEachChunk(blocks.size(), grainBlocks, [&](size_t, size_t first, size_t last) {
+        KeystrokeRecord record;
+        for (size_t b = first; b < last; ++b) {
+            const KeystrokeLog::Block& current = blocks[b];
+            size_t row = firstRecord[b];
+            bool intact = KeystrokeLog::verifyBlock(current);
+            const unsigned char* cursor = current.payload;
+            const unsigned char* blockEnd = current.payload + current.payloadSize;
+            uint64_t timeMicros = current.baseMicros;
+            for (uint32_t r = 0; r < current.recordCount; ++r, ++row) {
+                intact = intact && KeystrokeLog::decodeRecord(cursor, blockEnd, timeMicros, record);
+                columns.kind[row] = intact ? static_cast<uint8_t>(record.kind) : INVALID_KIND;
+                columns.flags[row] = record.flags;
+                columns.expected[row] = static_cast<uint8_t>(record.expected);
+                columns.latency[row] = record.sincePreviousMicros;
+                columns.value[row] = record.value;
+            }
+            blockIntact[b] = intact;
+        }
+    });
+
+    // A damaged last block may still be being written; leave it for the next refresh. Damaged
+    // blocks before an intact one stay damaged and are skipped.
+    size_t usableBlocks = blocks.size();
+    while (usableBlocks > 0 && !blockIntact[usableBlocks - 1]) --usableBlocks;
+    if (usableBlocks == 0) return 0;
+    size_t rowEnd = usableBlocks == blocks.size() ? CONTEXT_RECORDS + recordCount : firstRecord[usableBlocks];
+
+    std::vector<Tables> partial;
+    size_t rowCount = rowEnd - CONTEXT_RECORDS;
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    if (rowCount >= 2 * GameConstants::KEYSTROKE_PARALLEL_GRAIN && cores > 1) {
+        partial.resize(std::min(cores, rowCount / GameConstants::KEYSTROKE_PARALLEL_GRAIN));
+    }
+    if (partial.empty()) {
+        aggregateRange(CONTEXT_RECORDS, rowEnd, totals);
+    } else {
+        size_t grain = (rowCount + partial.size() - 1) / partial.size();
+        forEachChunk(rowCount, grain, [&](size_t chunk, size_t first, size_t last) {
+            aggregateRange(CONTEXT_RECORDS + first, CONTEXT_RECORDS + last, partial[chunk]);
+        });
+        for (const Tables& tables : partial) totals.merge(tables);
+    }
+    foldRuns(rowEnd);
+
+    for (size_t i = 0; i < CONTEXT_RECORDS; ++i) {
+        size_t row = rowEnd - CONTEXT_RECORDS + i;
+        context[i] = KeystrokeRecord{};
+        context[i].kind = static_cast<KeystrokeRecord::Kind>(columns.kind[row]);
+        context[i].flags = columns.flags[row];
+        context[i].expected = static_cast<char>(columns.expected[row]);
+        context[i].sincePreviousMicros = columns.latency[row];
+        context[i].value = columns.value[row];
+    }
+    const KeystrokeLog::Block& lastBlock = blocks[usableBlocks - 1];
+    coveredOffset = static_cast<uint64_t>(lastBlock.payload + lastBlock.payloadSize - base);
+    logIdentity = identity;
+    if (columns.kind.capacity() > 4 * GameConstants::KEYSTROKE_PARALLEL_GRAIN) columns = Columns(); // Keep only small scratch
+    worker.saveFile(cachePath, [snapshot = serializeCache()] { return snapshot; });
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    fmt::print("KeystrokeAnalytics: Folded {} keystroke records in {} ms ({} runs total).\n", rowCount, elapsed, runs.size());
+    return rowCount;
+}
+
+void KeystrokeAnalytics::aggregateRange(size_t first, size_t last, Tables& tables) const {
+    // Column scans with a fixed-size table per n-gram length; rows before 'first' are only read as context.
+    auto countable = [this](size_t row) {
+        return columns.kind[row] == KeystrokeRecord::KEY && !(columns.flags[row] & UNCOUNTED_KEY) &&
+               static_cast<uint8_t>(columns.expected[row] - 32) < CHARACTERS;
+    };
+    for (size_t row = first; row < last; ++row) {
+        if (!countable(row)) continue;
+        uint32_t latency = columns.latency[row];
+        bool timed = latency > 0 && latency <= GameConstants::KEYSTROKE_PAUSE_MICROS;
+        uint32_t error = (columns.flags[row] & KeystrokeRecord::CORRECT) ? 0 : 1;
+        auto add = [&](LatencyStats& stats) {
+            ++stats.keys;
+            stats.errors += error;
+            if (timed) stats.addLatency(latency);
+        };
+
+        size_t character = columns.expected[row] - 32;
+        add(tables.overall);
+        add(tables.characters[character]);
+        uint64_t word = columns.value[row];
+        if (word == 0 || !countable(row - 1) || columns.value[row - 1] != word) continue;
+        size_t bigram = (columns.expected[row - 1] - 32) * CHARACTERS + character;
+        add(tables.bigrams[bigram]);
+        if (!countable(row - 2) || columns.value[row - 2] != word) continue;
+        add(tables.trigrams[static_cast<uint32_t>((columns.expected[row - 2] - 32) * CHARACTERS * CHARACTERS + bigram)]);
+    }
+}
+
+void KeystrokeAnalytics::foldRuns(size_t rowEnd) {
+    for (size_t row = CONTEXT_RECORDS; row < rowEnd; ++row) {
+        switch (columns.kind[row]) {
+            case KeystrokeRecord::RUN_START:
+                // A start without an end (the game quit mid-run) drops the unfinished run.
+                openRun = RunTypingSummary{};
+                openRun.startedAt = static_cast<int64_t>(columns.value[row]);
+                runOpen = true;
+                break;
+            case KeystrokeRecord::RUN_END:
+                if (runOpen) {
+                    openRun.runId = columns.value[row];
+                    runs.push_back(openRun);
+                }
+                runOpen = false;
+                break;
+            case KeystrokeRecord::KEY:
+                if (runOpen && !(columns.flags[row] & UNCOUNTED_KEY) && columns.expected[row] != 0) {
+                    ++openRun.keys;
+                    if (!(columns.flags[row] & KeystrokeRecord::CORRECT)) ++openRun.errors;
+                    uint32_t latency = columns.latency[row];
+                    if (latency > 0 && latency <= GameConstants::KEYSTROKE_PAUSE_MICROS) {
+                        ++openRun.samples;
+                        openRun.latencySumMicros += latency;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+const LatencyStats& KeystrokeAnalytics::getOverall() const {
+    return totals.overall;
+}
+
+const LatencyStats& KeystrokeAnalytics::getCharacter(char c) const {
+    static const LatencyStats none;
+    auto index = static_cast<size_t>(static_cast<unsigned char>(c)) - 32;
+    return index < CHARACTERS ? totals.characters[index] : none;
+}
+
+const LatencyStats& KeystrokeAnalytics::getBigram(char first, char second) const {
+    static const LatencyStats none;
+    auto a = static_cast<size_t>(static_cast<unsigned char>(first)) - 32;
+    auto b = static_cast<size_t>(static_cast<unsigned char>(second)) - 32;
+    return (a < CHARACTERS && b < CHARACTERS) ? totals.bigrams[a * CHARACTERS + b] : none;
+}
+
+const std::vector<RunTypingSummary>& KeystrokeAnalytics::getRuns() const {
+    return runs;
+}
+
+float KeystrokeAnalytics::getTrendMsPerRun(size_t runCount) const {
+    double n = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    size_t first = runs.size() > runCount ? runs.size() - runCount : 0;
+    for (size_t i = first; i < runs.size(); ++i) {
+        if (runs[i].samples == 0) continue;
+        double x = static_cast<double>(i - first);
+        double y = runs[i].meanMs();
+        n += 1;
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+    double denominator = n * sumXX - sumX * sumX;
+    return (n >= 2 && denominator > 0) ? static_cast<float>((n * sumXY - sumX * sumY) / denominator) : 0.f;
+}
+
+void KeystrokeAnalytics::rankSlowest(size_t length, size_t count, uint32_t minSamples, std::vector<Ranked>& out) const {
+    out.clear();
+    auto consider = [&](size_t index, const LatencyStats& stats) {
+        if (stats.samples < minSamples) return;
+        Ranked ranked;
+        for (size_t i = 0; i < length; ++i) {
+            ranked.keys.insert(ranked.keys.begin(), static_cast<char>(32 + index % CHARACTERS));
+            index /= CHARACTERS;
+        }
+        ranked.stats = stats;
+        out.push_back(std::move(ranked));
+    };
+    if (length == 1) {
+        for (size_t i = 0; i < totals.characters.size(); ++i) consider(i, totals.characters[i]);
+    } else if (length == 2) {
+        for (size_t i = 0; i < totals.bigrams.size(); ++i) consider(i, totals.bigrams[i]);
+    } else if (length == 3) {
+        for (const auto& [key, stats] : totals.trigrams) consider(key, stats);
+    }
+    auto slower = [](const Ranked& a, const Ranked& b) { return a.stats.percentileMs(0.5f) > b.stats.percentileMs(0.5f); };
+    size_t kept = std::min(count, out.size());
+    std::partial_sort(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(kept), out.end(), slower);
+    out.resize(kept);
+}
+
+std::string KeystrokeAnalytics::serializeCache() const {
+    std::string out;
+    out.append(CACHE_MAGIC, 4);
+    put(out, CACHE_VERSION);
+    put(out, coveredOffset);
+    put(out, logIdentity);
+    for (const KeystrokeRecord& record : context) {
+        put(out, static_cast<uint8_t>(record.kind));
+        put(out, record.flags);
+        put(out, record.expected);
+        put(out, record.sincePreviousMicros);
+        put(out, record.value);
+    }
+    put(out, static_cast<uint8_t>(runOpen));
+    putRun(out, openRun);
+    put(out, static_cast<uint32_t>(runs.size()));
+    for (const RunTypingSummary& run : runs) putRun(out, run);
+
+    putStats(out, totals.overall);
+    for (const LatencyStats& stats : totals.characters) putStats(out, stats);
+    // Only n-grams that occurred are stored.
+    auto bigramCount = static_cast<uint32_t>(std::count_if(totals.bigrams.begin(), totals.bigrams.end(),
+                                                          [](const LatencyStats& stats) { return stats.keys > 0; }));
+    put(out, bigramCount);
+    for (size_t i = 0; i < totals.bigrams.size(); ++i) {
+        if (totals.bigrams[i].keys == 0) continue;
+        put(out, static_cast<uint32_t>(i));
+        putStats(out, totals.bigrams[i]);
+    }
+    put(out, static_cast<uint32_t>(totals.trigrams.size()));
+    for (const auto& [key, stats] : totals.trigrams) {
+        put(out, key);
+        putStats(out, stats);
+    }
+    return out;
+}
+
+bool KeystrokeAnalytics::loadCache() {
+    MappedFile file;
+    if (!file.map(cachePath)) return false;
+    const unsigned char* cursor = file.data();
+    const unsigned char* end = cursor + file.size();
+    char magic[4];
+    uint32_t version;
+    if (!get(cursor, end, magic) || std::memcmp(magic, CACHE_MAGIC, 4) != 0 || !get(cursor, end, version) || version != CACHE_VERSION) {
+        fmt::print(stderr, "KeystrokeAnalytics: Ignoring unreadable cache '{}'.\n", cachePath);
+        return false;
+    }
+
+    reset();
+    bool ok = get(cursor, end, coveredOffset) && get(cursor, end, logIdentity);
+    for (KeystrokeRecord& record : context) {
+        uint8_t kind = 0;
+        ok = ok && get(cursor, end, kind) && get(cursor, end, record.flags) && get(cursor, end, record.expected) &&
+             get(cursor, end, record.sincePreviousMicros) && get(cursor, end, record.value);
+        record.kind = static_cast<KeystrokeRecord::Kind>(kind);
+    }
+    uint8_t open = 0;
+    uint32_t runCount = 0;
+    ok = ok && get(cursor, end, open) && getRun(cursor, end, openRun) && get(cursor, end, runCount);
+    runOpen = open != 0;
+    for (uint32_t i = 0; ok && i < runCount; ++i) {
+        RunTypingSummary run;
+        ok = getRun(cursor, end, run);
+        runs.push_back(run);
+    }
+
+    ok = ok && getStats(cursor, end, totals.overall);
+    for (LatencyStats& stats : totals.characters) ok = ok && getStats(cursor, end, stats);
+    uint32_t bigramCount = 0;
+    ok = ok && get(cursor, end, bigramCount);
+    for (uint32_t i = 0; ok && i < bigramCount; ++i) {
+        uint32_t index = 0;
+        ok = get(cursor, end, index) && index < totals.bigrams.size() && getStats(cursor, end, totals.bigrams[index]);
+    }
+    uint32_t trigramCount = 0;
+    ok = ok && get(cursor, end, trigramCount);
+    for (uint32_t i = 0; ok && i < trigramCount; ++i) {
+        uint32_t key = 0;
+        LatencyStats stats;
+        ok = get(cursor, end, key) && getStats(cursor, end, stats);
+        totals.trigrams[key] = stats;
+    }
+    if (!ok || coveredOffset < KeystrokeLog::HEADER_SIZE) {
+        fmt::print(stderr, "KeystrokeAnalytics: Cache '{}' is truncated; rebuilding statistics.\n", cachePath);
+        return false;
+    }
+    return true;
+}
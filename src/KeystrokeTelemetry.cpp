@@ -0,0 +1,242 @@
+#include "../include/KeystrokeTelemetry.h"
+#include "../include/Crc32.h"
+#include "../include/Varint.h"
+#include "../include/BinaryIO.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char LOG_MAGIC[4] = {'M', 'T', 'K', 'S'};
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint32_t MAX_BLOCK_PAYLOAD = 16u << 20;
+
+    uint64_t nowMicros() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+namespace KeystrokeLog {
+    bool checkHeader(const unsigned char* data, size_t size) {
+        uint32_t version;
+        if (size < HEADER_SIZE || std::memcmp(data, LOG_MAGIC, 4) != 0) return false;
+        std::memcpy(&version, data + 4, sizeof(version));
+        return version == FORMAT_VERSION;
+    }
+
+    bool readBlock(const unsigned char* at, const unsigned char* end, Block& block) {
+        if (!get(at, end, block.payloadSize) || !get(at, end, block.recordCount) || !get(at, end, block.checksum) ||
+            !get(at, end, block.baseMicros)) {
+            return false;
+        }
+        block.payload = at;
+        return block.payloadSize <= MAX_BLOCK_PAYLOAD && block.payloadSize <= static_cast<size_t>(end - block.payload);
+    }
+
+    bool verifyBlock(const Block& block) {
+        return crc32(block.payload, block.payloadSize) == block.checksum;
+    }
+
+    bool decodeRecord(const unsigned char*& cursor, const unsigned char* end, uint64_t& timeMicros, KeystrokeRecord& out) {
+        uint64_t delta, sincePrevious, value;
+        if (end - cursor < 3) return false;
+        uint8_t kindAndFlags = cursor[0];
+        out.character = static_cast<char>(cursor[1]);
+        out.expected = static_cast<char>(cursor[2]);
+        cursor += 3;
+        if (!getVarint(cursor, end, delta) || !getVarint(cursor, end, sincePrevious) || !getVarint(cursor, end, value) ||
+            (kindAndFlags & 3) > KeystrokeRecord::RUN_END) {
+            return false;
+        }
+        timeMicros += delta;
+        out.timeMicros = timeMicros;
+        out.sincePreviousMicros = static_cast<uint32_t>(sincePrevious);
+        out.value = value;
+        out.kind = static_cast<KeystrokeRecord::Kind>(kindAndFlags & 3);
+        out.flags = static_cast<uint8_t>(kindAndFlags >> 2);
+        return true;
+    }
+}
+
+KeystrokeTelemetry::KeystrokeTelemetry(const std::string& logPath) : logPath(logPath) {
+    writer = std::thread(&KeystrokeTelemetry::runWriter, this);
+}
+
+KeystrokeTelemetry::~KeystrokeTelemetry() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopRequested = true;
+    }
+    sleepCondition.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+void KeystrokeTelemetry::push(const KeystrokeRecord& record) {
+    if (!ring.push(record)) droppedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KeystrokeTelemetry::beginRun() {
+    KeystrokeRecord record;
+    record.kind = KeystrokeRecord::RUN_START;
+    record.timeMicros = nowMicros();
+    record.value = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    runHasKeys = false;
+    push(record);
+}
+
+void KeystrokeTelemetry::endRun(uint64_t runId) {
+    KeystrokeRecord record;
+    record.kind = KeystrokeRecord::RUN_END;
+    record.timeMicros = nowMicros();
+    record.value = runId;
+    push(record);
+}
+
+void KeystrokeTelemetry::recordKey(char character, char expected, uint64_t wordId, uint8_t flags) {
+    KeystrokeRecord record;
+    record.timeMicros = nowMicros();
+    record.value = wordId;
+    record.flags = flags;
+    record.character = character;
+    record.expected = expected;
+    if (runHasKeys) {
+        record.sincePreviousMicros = static_cast<uint32_t>(std::min<uint64_t>(record.timeMicros - lastKeyMicros, UINT32_MAX));
+    }
+    lastKeyMicros = record.timeMicros;
+    runHasKeys = true;
+    push(record);
+}
+
+uint64_t KeystrokeTelemetry::getDroppedCount() const {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+bool KeystrokeTelemetry::openLog() {
+    std::error_code ec;
+    if (!fs::exists(logPath, ec) || fs::file_size(logPath, ec) == 0) {
+        std::ofstream create(logPath, std::ios::binary | std::ios::trunc);
+        create.write(LOG_MAGIC, 4);
+        create.write(reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+        if (!create) {
+            fmt::print(stderr, "KeystrokeTelemetry: Could not create '{}'.\n", logPath);
+            return false;
+        }
+    }
+
+    uint64_t validEnd = 0;
+    uint64_t fileSize = 0;
+    {
+        MappedFile existing;
+        if (!existing.map(logPath) || !KeystrokeLog::checkHeader(existing.data(), existing.size())) {
+            fmt::print(stderr, "KeystrokeTelemetry: '{}' is not a keystroke log of this version; keystrokes will not be saved.\n", logPath);
+            return false;
+        }
+        const unsigned char* cursor = existing.data() + KeystrokeLog::HEADER_SIZE;
+        const unsigned char* end = existing.data() + existing.size();
+        KeystrokeLog::Block block;
+        while (KeystrokeLog::readBlock(cursor, end, block) && KeystrokeLog::verifyBlock(block)) {
+            cursor = block.payload + block.payloadSize;
+        }
+        validEnd = static_cast<uint64_t>(cursor - existing.data());
+        fileSize = existing.size();
+    }
+    if (validEnd < fileSize) {
+        fmt::print(stderr, "KeystrokeTelemetry: Dropping {} bytes of incomplete data at the end of '{}'.\n", fileSize - validEnd, logPath);
+        fs::resize_file(logPath, validEnd, ec);
+    }
+
+    logOut.open(logPath, std::ios::binary | std::ios::app);
+    if (!logOut.is_open()) {
+        fmt::print(stderr, "KeystrokeTelemetry: Could not open '{}' for appending.\n", logPath);
+        return false;
+    }
+    return true;
+}
+
+void KeystrokeTelemetry::runWriter() {
+    bool writable = openLog();
+    pending.reserve(GameConstants::KEYSTROKE_RING_CAPACITY);
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(GameConstants::KEYSTROKE_DRAIN_INTERVAL_MS),
+                                    [this] { return stopRequested; });
+            stopping = stopRequested;
+        }
+        // The ring is always drained, so the game never sees it fill up when the file is unusable.
+        pending.clear();
+        ring.drain([this](const KeystrokeRecord& record) { pending.push_back(record); });
+        if (writable && !pending.empty()) writeBlock();
+        if (stopping) break;
+    }
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        fmt::print(stderr, "KeystrokeTelemetry: {} keystrokes were dropped because the writer fell behind.\n", dropped);
+    }
+}
+
+void KeystrokeTelemetry::writeBlock() {
+    block.assign(KeystrokeLog::BLOCK_HEADER_SIZE, 0);
+    uint64_t baseMicros = pending.front().timeMicros;
+    uint64_t previousMicros = baseMicros;
+    for (const KeystrokeRecord& record : pending) {
+        block.push_back(static_cast<unsigned char>(record.kind | (record.flags << 2)));
+        block.push_back(static_cast<unsigned char>(record.character));
+        block.push_back(static_cast<unsigned char>(record.expected));
+        // Records are pushed in time order by one thread, so the deltas are never negative.
+        putVarint(block, record.timeMicros - previousMicros);
+        putVarint(block, record.sincePreviousMicros);
+        putVarint(block, record.value);
+        previousMicros = record.timeMicros;
+    }
+
+    auto payloadSize = static_cast<uint32_t>(block.size() - KeystrokeLog::BLOCK_HEADER_SIZE);
+    auto recordCount = static_cast<uint32_t>(pending.size());
+    uint32_t checksum = crc32(block.data() + KeystrokeLog::BLOCK_HEADER_SIZE, payloadSize);
+    std::memcpy(block.data(), &payloadSize, 4);
+    std::memcpy(block.data() + 4, &recordCount, 4);
+    std::memcpy(block.data() + 8, &checksum, 4);
+    std::memcpy(block.data() + 12, &baseMicros, 8);
+    logOut.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    logOut.flush();
+    if (!logOut) {
+        fmt::print(stderr, "KeystrokeTelemetry: Write to '{}' failed.\n", logPath);
+        logOut.clear();
+    }
+}
+
+bool KeystrokeLogReader::open(const std::string& logPath) {
+    cursor = end = blockEnd = nullptr;
+    remainingInBlock = 0;
+    if (!file.map(logPath) || !KeystrokeLog::checkHeader(file.data(), file.size())) return false;
+    cursor = blockEnd = file.data() + KeystrokeLog::HEADER_SIZE;
+    end = file.data() + file.size();
+    return true;
+}
+
+bool KeystrokeLogReader::next(KeystrokeRecord& out) {
+    while (remainingInBlock == 0) {
+        KeystrokeLog::Block block;
+        if (!blockEnd || !KeystrokeLog::readBlock(blockEnd, end, block) || !KeystrokeLog::verifyBlock(block)) return false;
+        cursor = block.payload;
+        blockEnd = block.payload + block.payloadSize;
+        remainingInBlock = block.recordCount;
+        timeMicros = block.baseMicros;
+    }
+    if (!KeystrokeLog::decodeRecord(cursor, blockEnd, timeMicros, out)) {
+        blockEnd = nullptr; // A block that passed its checksum but does not parse ends the log
+        remainingInBlock = 0;
+        return false;
+    }
+    --remainingInBlock;
+    return true;
+}
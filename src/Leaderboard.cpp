@@ -0,0 +1,160 @@
+#include "../include/Leaderboard.h"
+#include <utility>
+
+Leaderboard::Leaderboard(size_t capacity)
+        : capacity(capacity > 0 ? capacity : 1), root(NIL), priorityRandom(0x5eed) {}
+
+void Leaderboard::setCapacity(size_t newCapacity) {
+    capacity = newCapacity > 0 ? newCapacity : 1;
+    if (size() > capacity) {
+        uint32_t kept, dropped;
+        splitByCount(root, capacity, kept, dropped);
+        root = kept;
+        releaseSubtree(dropped);
+    }
+}
+
+size_t Leaderboard::getCapacity() const { return capacity; }
+size_t Leaderboard::size() const { return sizeOf(root); }
+
+void Leaderboard::clear() {
+    root = NIL;
+    nodes.clear();
+    freeNodes.clear();
+}
+
+bool Leaderboard::ranksAbove(const Entry& a, const Entry& b) {
+    return a.score != b.score ? a.score > b.score : a.runId < b.runId;
+}
+
+uint32_t Leaderboard::sizeOf(uint32_t node) const {
+    return node == NIL ? 0 : nodes[node].size;
+}
+
+void Leaderboard::pull(uint32_t node) {
+    nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+}
+
+void Leaderboard::splitByKey(uint32_t node, const Entry& key, uint32_t& above, uint32_t& rest) {
+    if (node == NIL) {
+        above = rest = NIL;
+        return;
+    }
+    if (ranksAbove(nodes[node].entry, key)) {
+        splitByKey(nodes[node].right, key, nodes[node].right, rest);
+        above = node;
+    } else {
+        splitByKey(nodes[node].left, key, above, nodes[node].left);
+        rest = node;
+    }
+    pull(node);
+}
+
+void Leaderboard::splitByCount(uint32_t node, size_t count, uint32_t& first, uint32_t& rest) {
+    if (node == NIL) {
+        first = rest = NIL;
+        return;
+    }
+    size_t leftSize = sizeOf(nodes[node].left);
+    if (count <= leftSize) {
+        splitByCount(nodes[node].left, count, first, nodes[node].left);
+        rest = node;
+    } else {
+        splitByCount(nodes[node].right, count - leftSize - 1, nodes[node].right, rest);
+        first = node;
+    }
+    pull(node);
+}
+
+uint32_t Leaderboard::merge(uint32_t a, uint32_t b) {
+    if (a == NIL) return b;
+    if (b == NIL) return a;
+    if (nodes[a].priority > nodes[b].priority) {
+        nodes[a].right = merge(nodes[a].right, b);
+        pull(a);
+        return a;
+    }
+    nodes[b].left = merge(a, nodes[b].left);
+    pull(b);
+    return b;
+}
+
+void Leaderboard::releaseSubtree(uint32_t node) {
+    // Iterative, since a dropped range can be large after shrinking the capacity.
+    std::vector<uint32_t> pending;
+    if (node != NIL) pending.push_back(node);
+    while (!pending.empty()) {
+        uint32_t current = pending.back();
+        pending.pop_back();
+        if (nodes[current].left != NIL) pending.push_back(nodes[current].left);
+        if (nodes[current].right != NIL) pending.push_back(nodes[current].right);
+        nodes[current].entry = Entry{};
+        freeNodes.push_back(current);
+    }
+}
+
+size_t Leaderboard::insert(Entry&& entry) {
+    if (size() >= capacity && !ranksAbove(entry, at(size() - 1))) {
+        return NOT_RANKED;
+    }
+
+    uint32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node].entry = std::move(entry);
+    } else {
+        node = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{std::move(entry), 0, NIL, NIL, 1});
+    }
+    nodes[node].priority = static_cast<uint32_t>(priorityRandom());
+    nodes[node].left = nodes[node].right = NIL;
+    nodes[node].size = 1;
+
+    uint32_t above, rest;
+    splitByKey(root, nodes[node].entry, above, rest);
+    size_t rank = sizeOf(above);
+    root = merge(merge(above, node), rest);
+
+    if (size() > capacity) {
+        uint32_t kept, dropped;
+        splitByCount(root, capacity, kept, dropped);
+        root = kept;
+        releaseSubtree(dropped);
+    }
+    return rank;
+}
+
+bool Leaderboard::qualifies(int score) const {
+    return size() < capacity || score > at(size() - 1).score;
+}
+
+size_t Leaderboard::rankOf(int score) const {
+    // A new run has the highest id, so it ranks below every entry with the same score.
+    size_t rank = 0;
+    uint32_t node = root;
+    while (node != NIL) {
+        if (nodes[node].entry.score >= score) {
+            rank += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        } else {
+            node = nodes[node].left;
+        }
+    }
+    return rank;
+}
+
+const Leaderboard::Entry& Leaderboard::at(size_t rank) const {
+    uint32_t node = root;
+    while (true) {
+        size_t leftSize = sizeOf(nodes[node].left);
+        if (rank < leftSize) {
+            node = nodes[node].left;
+        } else if (rank == leftSize) {
+            return nodes[node].entry;
+        } else {
+            rank -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include "../include/LeaderboardStore.h"
+
+LeaderboardStore::LeaderboardStore(size_t capacity) : capacity(capacity) {
+    clear();
+}
+
+void LeaderboardStore::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    for (Partition& partition : partitions) partition.board.setCapacity(capacity);
+}
+
+void LeaderboardStore::clear() {
+    partitions.clear();
+    partitionByHash.clear();
+    partitions.push_back(Partition{0, "All configurations", Leaderboard(capacity)});
+}
+
+size_t LeaderboardStore::partitionOf(uint32_t configHash, const std::string& label) {
+    auto [it, inserted] = partitionByHash.try_emplace(configHash, partitions.size());
+    if (inserted) {
+        partitions.push_back(Partition{configHash, label, Leaderboard(capacity)});
+    }
+    return it->second;
+}
+
+size_t LeaderboardStore::findPartition(uint32_t configHash) const {
+    auto it = partitionByHash.find(configHash);
+    return it != partitionByHash.end() ? it->second : NO_PARTITION;
+}
+
+size_t LeaderboardStore::insert(size_t partition, const std::string& name, int score, uint64_t runId) {
+    partitions[OVERALL].board.insert(Leaderboard::Entry(name, score, runId));
+    return partitions[partition].board.insert(Leaderboard::Entry(name, score, runId));
+}
+
+bool LeaderboardStore::qualifies(uint32_t configHash, int score) const {
+    if (partitions[OVERALL].board.qualifies(score)) return true;
+    size_t partition = findPartition(configHash);
+    return partition == NO_PARTITION || partitions[partition].board.qualifies(score);
+}
+
+size_t LeaderboardStore::getPartitionCount() const {
+    return partitions.size();
+}
+
+const Leaderboard& LeaderboardStore::getBoard(size_t partition) const {
+    return partitions[partition].board;
+}
+
+const std::string& LeaderboardStore::getLabel(size_t partition) const {
+    return partitions[partition].label;
+}
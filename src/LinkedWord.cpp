@@ -1,19 +1,42 @@
 #include "../include/LinkedWord.h"
 #include "../include/Constants.h"
+#include "../include/GlyphMetrics.h"
 
 LinkedWord::LinkedWord(const std::vector<std::string>& words,
                        const sf::Font& font, float speed,
                        const sf::Vector2f& position, unsigned int fontSize,
                        const std::vector<float>& yPositions)
-        : Word(words[0], font, speed, position, fontSize), words(words), yPositions(yPositions)
+        : Word(words[0], font, speed, position, fontSize)
 {
-    wordTexts.clear();
-    for (const auto& word : words) {
-        sf::Text text(word, font, fontSize);
+    // The pool only reuses this word for as many parts as it has now; sized for the longest
+    // parts, it never allocates again.
+    this->words.resize(words.size());
+    for (std::string& part : this->words) part.reserve(GameConstants::MAX_WORD_LENGTH);
+    wordTexts.resize(words.size());
+    for (sf::Text& text : wordTexts) reserveTextString(text);
+    linkPoints.reserve(words.size());
+    this->yPositions.reserve(words.size());
+    reset(words, font, speed, position, fontSize, yPositions);
+}
+
+void LinkedWord::reset(const std::vector<std::string>& parts, const sf::Font& font, float speed,
+                       const sf::Vector2f& position, unsigned int fontSize, const std::vector<float>& partYPositions) {
+    Word::reset(parts[0], font, speed, position, fontSize);
+    currentPartIndex = 0;
+    words.assign(parts.begin(), parts.end());
+    yPositions.assign(partYPositions.begin(), partYPositions.end());
+
+    wordTexts.resize(words.size());
+    partWidths.resize(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        sf::Text& text = wordTexts[i];
+        text.setFont(font);
+        text.setCharacterSize(fontSize);
+        setTextString(text, words[i]);
         text.setFillColor(sf::Color(150, 150, 150));    // Gray for blocked words
         text.setOutlineColor(sf::Color::Black);
         text.setOutlineThickness(1);
-        wordTexts.push_back(text);
+        partWidths[i] = metrics->measure(words[i]);
     }
 
     // Only the first word is active initially
@@ -35,6 +58,7 @@ void LinkedWord::update(float deltaTime) {
 
 void LinkedWord::processInput(sf::Uint32 unicode, bool highlightTyping) {
     if (getTypedCorrectly()) return;
+    lastTypedKey = TypedKey{};
 
     // Only process input for the current active word
     if (unicode == 8) { // Backspace
@@ -47,13 +71,18 @@ void LinkedWord::processInput(sf::Uint32 unicode, bool highlightTyping) {
     // Allow typing any character, but only count correct ones
     if (getCurrentInput().length() < words[currentPartIndex].length()) {
         appendToCurrentInput(static_cast<char>(unicode));
-        if (tolower(unicode) != tolower(words[currentPartIndex][getCurrentInput().length() - 1])) {
+        const std::string& part = words[currentPartIndex];
+        size_t typedPos = getCurrentInput().length() - 1;
+        lastTypedKey.expected = part[typedPos];
+        lastTypedKey.previous = typedPos > 0 ? part[typedPos - 1] : 0;
+        if (tolower(unicode) != tolower(part[typedPos])) {
             incrementMistakesCount();
+            lastTypedKey.mistake = true;
         }
     }
 
     // Check if current word is completed
-    if (getCurrentInput() == words[currentPartIndex]) {
+    if (getMatchedLength() == words[currentPartIndex].length()) {
         if (currentPartIndex + 1 < static_cast<int>(words.size())) {
             // Move to next word in sequence
             currentPartIndex++;
@@ -163,6 +192,11 @@ const std::string& LinkedWord::getText() const {
     return words[currentPartIndex];
 }
 
+sf::FloatRect LinkedWord::getTypingBounds() const {
+    const sf::Vector2f& partPosition = wordTexts[currentPartIndex].getPosition();
+    return sf::FloatRect(partPosition.x, partPosition.y + metrics->getTextTop(), partWidths[currentPartIndex], metrics->getTextHeight());
+}
+
 void LinkedWord::updatePositions() {
     linkPoints.clear();
     if (wordTexts.empty()) return;
@@ -176,12 +210,11 @@ void LinkedWord::updatePositions() {
         wordTexts[i].setPosition(x, y);
 
         // Calculate center point for connections
-        sf::FloatRect bounds = wordTexts[i].getLocalBounds();
         linkPoints.emplace_back(
-                x + bounds.width / 2,
-                y + bounds.height / 2
+                x + partWidths[i] / 2,
+                y + metrics->getTextTop() + metrics->getTextHeight() / 2
         );
 
-        x += bounds.width + 30.0f;
+        x += partWidths[i] + 30.0f;
     }
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "../include/MappedFile.h"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MONKEY_TYPER_HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+bool MappedFile::map(const std::string& path) {
+    unmap();
+#ifdef MONKEY_TYPER_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return true; // mmap rejects empty ranges; an empty view is still valid
+    }
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    bytes = static_cast<const unsigned char*>(address);
+    mapped = true;
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!buffer.empty() && !file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+        buffer.clear();
+        return false;
+    }
+    bytes = buffer.data();
+    length = buffer.size();
+    return true;
+#endif
+}
+
+void MappedFile::unmap() {
+#ifdef MONKEY_TYPER_HAS_MMAP
+    if (mapped) {
+        munmap(const_cast<unsigned char*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+const unsigned char* MappedFile::data() const { return bytes; }
+size_t MappedFile::size() const { return length; }
@@ -0,0 +1,131 @@
+#include "../include/MarkovWordGenerator.h"
+#include <fmt/core.h>
+#include <fstream>
+#include <algorithm>
+
+namespace {
+    constexpr char FILE_MAGIC[4] = {'M', 'W', 'G', '1'};
+    constexpr int MAX_GENERATE_ATTEMPTS = 16;
+}
+
+MarkovWordGenerator::MarkovWordGenerator() {}
+
+size_t MarkovWordGenerator::startState() {
+    size_t state = 0;
+    for (int i = 0; i < ORDER; ++i) state = nextState(state, BOUNDARY);
+    return state;
+}
+
+size_t MarkovWordGenerator::nextState(size_t state, int symbol) {
+    // Drop the oldest symbol of the context and append the new one.
+    return (state * SYMBOL_COUNT + static_cast<size_t>(symbol)) % STATE_COUNT;
+}
+
+bool MarkovWordGenerator::train(const std::vector<std::string>& words) {
+    const size_t initialState = startState();
+    std::vector<uint32_t> counts(STATE_COUNT * SYMBOL_COUNT, 0);
+    size_t trainedWords = 0;
+
+    for (const auto& word : words) {
+        if (word.empty() || !std::all_of(word.begin(), word.end(), [](char c) { return c >= 'a' && c <= 'z'; })) continue;
+        size_t state = initialState;
+        for (char c : word) {
+            int symbol = c - 'a';
+            counts[state * SYMBOL_COUNT + symbol]++;
+            state = nextState(state, symbol);
+        }
+        counts[state * SYMBOL_COUNT + BOUNDARY]++;
+        ++trainedWords;
+    }
+    if (trainedWords == 0) return false;
+
+    // Keep only contexts that were actually observed, as rows of cumulative counts.
+    rowOfState.assign(STATE_COUNT, NO_ROW);
+    cumulative.clear();
+    for (size_t state = 0; state < STATE_COUNT; ++state) {
+        const uint32_t* row = &counts[state * SYMBOL_COUNT];
+        if (std::all_of(row, row + SYMBOL_COUNT, [](uint32_t n) { return n == 0; })) continue;
+        rowOfState[state] = static_cast<uint16_t>(cumulative.size() / SYMBOL_COUNT);
+        uint32_t running = 0;
+        for (int symbol = 0; symbol < SYMBOL_COUNT; ++symbol) {
+            running += row[symbol];
+            cumulative.push_back(running);
+        }
+    }
+    return true;
+}
+
+bool MarkovWordGenerator::save(const std::string& path, uint64_t sourceStamp) const {
+    if (!isTrained()) return false;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    uint32_t order = ORDER;
+    uint32_t rowCount = static_cast<uint32_t>(cumulative.size() / SYMBOL_COUNT);
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&order), sizeof(order));
+    file.write(reinterpret_cast<const char*>(&sourceStamp), sizeof(sourceStamp));
+    file.write(reinterpret_cast<const char*>(&rowCount), sizeof(rowCount));
+    file.write(reinterpret_cast<const char*>(rowOfState.data()), static_cast<std::streamsize>(rowOfState.size() * sizeof(uint16_t)));
+    file.write(reinterpret_cast<const char*>(cumulative.data()), static_cast<std::streamsize>(cumulative.size() * sizeof(uint32_t)));
+    return static_cast<bool>(file);
+}
+
+bool MarkovWordGenerator::load(const std::string& path, uint64_t sourceStamp) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4];
+    uint32_t order = 0;
+    uint64_t storedStamp = 0;
+    uint32_t rowCount = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&order), sizeof(order));
+    file.read(reinterpret_cast<char*>(&storedStamp), sizeof(storedStamp));
+    file.read(reinterpret_cast<char*>(&rowCount), sizeof(rowCount));
+    if (!file || !std::equal(magic, magic + 4, FILE_MAGIC) || order != ORDER || storedStamp != sourceStamp
+        || rowCount == 0 || rowCount > STATE_COUNT) {
+        return false;
+    }
+
+    std::vector<uint16_t> loadedRows(STATE_COUNT);
+    std::vector<uint32_t> loadedCumulative(static_cast<size_t>(rowCount) * SYMBOL_COUNT);
+    file.read(reinterpret_cast<char*>(loadedRows.data()), static_cast<std::streamsize>(loadedRows.size() * sizeof(uint16_t)));
+    file.read(reinterpret_cast<char*>(loadedCumulative.data()), static_cast<std::streamsize>(loadedCumulative.size() * sizeof(uint32_t)));
+    if (!file) return false;
+    for (uint16_t row : loadedRows) {
+        if (row != NO_ROW && row >= rowCount) return false;
+    }
+
+    rowOfState.swap(loadedRows);
+    cumulative.swap(loadedCumulative);
+    return true;
+}
+
+size_t MarkovWordGenerator::generate(std::mt19937& rng, size_t minLength, size_t maxLength, char* out, size_t capacity) const {
+    if (!isTrained() || maxLength == 0 || capacity < maxLength) return 0;
+    const size_t initialState = startState();
+
+    for (int attempt = 0; attempt < MAX_GENERATE_ATTEMPTS; ++attempt) {
+        size_t state = initialState;
+        size_t length = 0;
+        while (length < maxLength) {
+            uint16_t row = rowOfState[state];
+            if (row == NO_ROW) break;
+            const uint32_t* cumulativeRow = &cumulative[static_cast<size_t>(row) * SYMBOL_COUNT];
+            // The boundary symbol is last, so excluding it before minLength just shortens the range.
+            uint32_t total = length < minLength ? cumulativeRow[LETTER_COUNT - 1] : cumulativeRow[SYMBOL_COUNT - 1];
+            if (total == 0) break;
+            uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(rng);
+            int symbol = static_cast<int>(std::upper_bound(cumulativeRow, cumulativeRow + SYMBOL_COUNT, pick) - cumulativeRow);
+            if (symbol == BOUNDARY) break;
+            out[length++] = static_cast<char>('a' + symbol);
+            state = nextState(state, symbol);
+        }
+        if (length >= minLength && length > 0) return length;
+    }
+    return 0;
+}
+
+bool MarkovWordGenerator::isTrained() const {
+    return !cumulative.empty();
+}
@@ -4,21 +4,31 @@
 #include "../include/SettingsManager.h"
 #include "../include/HighScoreManager.h"
 #include "../include/UIManager.h"
-#include "../include/LinkedWord.h"
+#include "../include/WeaknessTrainer.h"
+#include "../include/TextStreamSource.h"
+#include "../include/ParagraphView.h"
+#include "../include/GlyphMetrics.h"
+#include "../include/AllocationCounter.h"
+#include "../include/PersistenceWorker.h"
+#include "../include/KeystrokeTelemetry.h"
+#include "../include/KeystrokeAnalytics.h"
+#include "../include/RunJournal.h"
+#include "../include/RunExporter.h"
+#include "../include/GameSession.h"
+#include "../include/TypistBot.h"
 #include <fmt/core.h>
+#include <filesystem>
+#include <chrono>
 #include <random>
 #include <algorithm>
 #include <vector>
+#include <cmath>
 
-MonkeyTyperGame::MonkeyTyperGame()
+MonkeyTyperGame::MonkeyTyperGame(const std::string& profile)
         : window(sf::VideoMode(GameConstants::WINDOW_WIDTH, GameConstants::WINDOW_HEIGHT), "Monkey Typer"),
           gameState(GameState::MENU),
+          settingsPath(SettingsManager::profilePath(profile)),
           currentGlobalFont(nullptr),
-          score(0),
-          gameTime(0),
-          lastScoreRecordTime(0),
-          wordSpawnTimer(0),
-          gameStats{},
           newHighScoreEligibleFlag(false),
           highScoreNamePromptAttempted(false) {
     init();
@@ -28,6 +38,7 @@ MonkeyTyperGame::~MonkeyTyperGame() {
 }
 
 void MonkeyTyperGame::init() {
+    persistenceWorker = std::make_unique<PersistenceWorker>();
     fontManager = std::make_unique<FontManager>();
     fontManager->loadFonts("PixelTCG.ttf", "../fonts/PixelTCG.ttf", "../fonts");
     currentGlobalFont = fontManager->getDefaultFont();
@@ -36,7 +47,15 @@ void MonkeyTyperGame::init() {
     wordDbManager->loadWordSets("../dictionary");
 
     settingsManager = std::make_unique<SettingsManager>();
-    settingsManager->loadSettings("../util/settings.cfg", *fontManager, currentGlobalFont);
+    // A new profile keeps the built-in defaults (not the default profile's file) and is saved under its own name.
+    bool newProfile = settingsPath != SettingsManager::profilePath("") && !std::filesystem::exists(settingsPath);
+    if (!newProfile) {
+        settingsManager->loadSettings(settingsPath, *fontManager, currentGlobalFont);
+    } else {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(settingsPath).parent_path(), ec);
+        fmt::print("Settings: Creating profile '{}'.\n", settingsPath);
+    }
 
     if (settingsManager->randomizeFontsEnabled) {
         if (!settingsManager->getRandomizedFontNames().empty()) {
@@ -80,11 +99,26 @@ void MonkeyTyperGame::init() {
         }
     }
 
-    highScoreManager = std::make_unique<HighScoreManager>();
-    highScoreManager->loadHighScores("../util/highscores.txt");
+    weaknessTrainer = std::make_unique<WeaknessTrainer>();
+    static std::mt19937 session_seed_gen(std::random_device{}());
+    GameSession::Sources sources;
+    sources.pickWord = [this](std::mt19937& randomGen) -> const std::string& { return pickSpawnWordText(randomGen); };
+    sources.pickFont = [this](std::mt19937& randomGen) -> const sf::Font& { return pickSpawnFont(randomGen); };
+    session = std::make_unique<GameSession>(std::move(sources), session_seed_gen());
+    session->setKeyListener([this](const GameSession::KeyOutcome& key) { onSessionKey(key); });
+    keystrokeTelemetry = std::make_unique<KeystrokeTelemetry>("../util/keystrokes.bin");
+    keystrokeAnalytics = std::make_unique<KeystrokeAnalytics>("../util/keystrokes.bin", "../util/keystrokes.stats");
+
+    highScoreManager = std::make_unique<HighScoreManager>(*persistenceWorker, settingsManager->getLeaderboardCapacity());
+    highScoreManager->loadHighScores("../util/runs.log", "../util/runs.idx", "../util/highscores.txt");
+    runJournal = std::make_unique<RunJournal>("../util/run.journal");
+    recoverInterruptedRun();
 
     uiManager = std::make_unique<UIManager>(window, *this, *fontManager, *settingsManager, *highScoreManager, *wordDbManager);
     uiManager->initUI();
+
+    fontManager->startWatching("../fonts");
+    wordDbManager->startWatching("../dictionary");
 }
 
 void MonkeyTyperGame::run() {
@@ -100,13 +134,19 @@ void MonkeyTyperGame::run() {
 void MonkeyTyperGame::processEvents() {
     sf::Event event;
     while (window.pollEvent(event)) {
+        eventPolledMicros = InputLatencyMeter::nowMicros();
         if (event.type == sf::Event::Closed) {
             if(settingsManager && fontManager) { // Ensure managers exist before saving
-                settingsManager->saveSettings("../util/settings.cfg", currentGlobalFont, *fontManager);
+                settingsManager->saveSettings(*persistenceWorker, settingsPath, currentGlobalFont, *fontManager);
             }
             window.close();
         }
 
+        if (event.type == sf::Event::KeyPressed || event.type == sf::Event::TextEntered || event.type == sf::Event::MouseMoved ||
+            event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::MouseWheelScrolled) {
+            menuIdleTime = 0.f;
+        }
+
         switch (gameState) {
             case GameState::MENU:         if(uiManager) uiManager->processMenuEvent(event); break;
             case GameState::PLAYING:      processPlayingEvents(event); break;
@@ -117,11 +157,15 @@ void MonkeyTyperGame::processEvents() {
             case GameState::FONT_RANDOMIZATION: if(uiManager) uiManager->processFontRandomizationEvent(event); break;
             case GameState::WORD_SET_SELECTION: if(uiManager) uiManager->processWordSetSelectionEvent(event); break;
             case GameState::GRAPH_VIEW:   if(uiManager) uiManager->processGraphViewEvent(event); break;
+            case GameState::STATS_VIEW:   if(uiManager) uiManager->processStatsViewEvent(event); break;
+            case GameState::ATTRACT:      processAttractEvents(event); break;
         }
     }
 }
 
 void MonkeyTyperGame::update(float deltaTime) {
+    applyHotReloads();
+
     sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
     if (uiManager) {
         uiManager->update(mousePos, deltaTime);
@@ -129,6 +173,13 @@ void MonkeyTyperGame::update(float deltaTime) {
 
     if (gameState == GameState::PLAYING) {
         updateGame(deltaTime);
+    } else if (gameState == GameState::ATTRACT) {
+        updateAttract(deltaTime);
+    } else if (gameState == GameState::MENU) {
+        menuIdleTime += deltaTime;
+        if (menuIdleTime >= GameConstants::ATTRACT_IDLE_SECONDS) {
+            startAttract();
+        }
     }
 }
 
@@ -139,16 +190,19 @@ void MonkeyTyperGame::render() {
     switch (gameState) {
         case GameState::MENU:         uiManager->renderMenu(); break;
         case GameState::PLAYING:      renderGame(); break;
-        case GameState::GAME_OVER:    uiManager->renderGameOver(gameStats, score, scoreHistory, currentGlobalFont); break;
+        case GameState::GAME_OVER:    uiManager->renderGameOver(session->getGameStats(), session->getScore(), session->getScoreTimeline(), currentGlobalFont); break;
         case GameState::HIGH_SCORES:  uiManager->renderHighScores(); break;
         case GameState::SETTINGS:     uiManager->renderSettings(); break;
         case GameState::FONT_SELECTION: uiManager->renderFontSelection(); break;
         case GameState::FONT_RANDOMIZATION: uiManager->renderFontRandomization(); break;
         case GameState::WORD_SET_SELECTION: uiManager->renderWordSetSelection(); break;
         case GameState::GRAPH_VIEW:   uiManager->renderGraphView(); break;
+        case GameState::STATS_VIEW:   uiManager->renderStatsView(); break;
+        case GameState::ATTRACT:      renderGame(); window.draw(uiManager->attractBannerDisplay); break;
     }
 
     window.display();
+    inputLatency.framePresented(InputLatencyMeter::nowMicros());
 }
 
 void MonkeyTyperGame::setGameState(GameState newState) {
@@ -156,12 +210,15 @@ void MonkeyTyperGame::setGameState(GameState newState) {
     gameState = newState;
 
     if (newState == GameState::GAME_OVER && oldState == GameState::PLAYING) {
-        newHighScoreEligibleFlag = isNewHighScoreEligible(score);
+        newHighScoreEligibleFlag = isNewHighScoreEligible(session->getScore());
         highScoreNamePromptAttempted = false;
     } else if (newState == GameState::MENU || (newState == GameState::PLAYING && oldState != GameState::PLAYING)) {
         newHighScoreEligibleFlag = false;
         highScoreNamePromptAttempted = false;
     }
+    if (newState == GameState::MENU) {
+        menuIdleTime = 0.f;
+    }
 }
 
 MonkeyTyperGame::GameState MonkeyTyperGame::getGameState() const {
@@ -169,14 +226,6 @@ MonkeyTyperGame::GameState MonkeyTyperGame::getGameState() const {
 }
 
 void MonkeyTyperGame::startGame() {
-    activeWords.clear();
-    score = 0;
-    gameTime = 0;
-    lastScoreRecordTime = 0;
-    wordSpawnTimer = 0;
-    scoreHistory.clear();
-    gameStats = GameConstants::GameStats{};
-
     if (settingsManager->randomizeFontsEnabled) {
         if (!settingsManager->getRandomizedFontNames().empty()) {
             auto& rFonts = settingsManager->getRandomizedFontNames();
@@ -203,18 +252,78 @@ void MonkeyTyperGame::startGame() {
         }
     }
 
+    if (settingsManager->weaknessTraining()) {
+        rebuildTrainingIndex();
+    }
+
     setGameState(GameState::PLAYING);
-    for (int i = 0; i < 3; i++) spawnWord();
+    std::unique_ptr<ParagraphView> paragraph;
+    if (settingsManager->paragraphMode()) {
+        static std::mt19937 paragraph_random_gen(std::random_device{}());
+        paragraph = createParagraphView(paragraph_random_gen);
+    }
+    session->start(buildSessionSettings(), InputLatencyMeter::nowMicros(), std::move(paragraph));
+    fontManager->releaseRetiredFonts(); // The previous game's words are gone
+    inputLatency.reset();
+    latencyOverlayDueMicros = 0;
+    currentRunConfig = buildRunConfig(); // After paragraph setup: a paragraph game may fall back to words
+    keystrokeTelemetry->beginRun();
+    runStartedAt = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    journalRunId = runJournal->begin(currentRunConfig, runStartedAt);
 }
 
 void MonkeyTyperGame::endGame() {
     setGameState(GameState::GAME_OVER);
+
+    RunRecord run;
+    run.finishedAt = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    run.startedAt = runStartedAt;
+    run.score = session->getScore();
+    run.gameTime = session->getGameTime();
+    run.stats = session->getGameStats();
+    session->getScoreTimeline().copyPoints(run.history);
+    run.config = currentRunConfig;
+    run.inputLatency = inputLatency.summarize();
+    lastRunId = highScoreManager->recordRun(run);
+    keystrokeTelemetry->endRun(lastRunId);
+    // Queued behind the run log commit, so the journal is only deleted once the run is on disk.
+    RunJournal* journal = runJournal.get();
+    uint64_t journalRun = journalRunId;
+    persistenceWorker->post("runjournal", [journal, journalRun] { journal->end(journalRun); });
+    if (AllocationCounter::isEnabled()) {
+        fmt::print("Word pool: {} spawns, {} words created, {} reused; {} heap allocations while spawning.\n",
+                   session->getSpawnCount(), session->getWordPool().getCreatedCount(), session->getWordPool().getReusedCount(),
+                   session->getSpawnAllocations());
+        if (session->getSteadyStateSpawnAllocations() > 0) {
+            fmt::print(stderr, "AllocationCounter: FAILED: {} heap allocations in spawns served from the word pool (expected 0).\n",
+                       session->getSteadyStateSpawnAllocations());
+        }
+    }
+}
+
+void MonkeyTyperGame::recoverInterruptedRun() {
+    RunRecord interruptedRun;
+    if (!runJournal->recover(interruptedRun)) return;
+    if (highScoreManager->isRunRecorded(interruptedRun.startedAt, interruptedRun.config)) {
+        // Crashed after the run was archived but before its journal was deleted.
+        runJournal->discardRecovered();
+        return;
+    }
+    uint64_t runId = highScoreManager->recordRun(interruptedRun);
+    keystrokeTelemetry->endRun(runId); // Its keystrokes are already logged, up to the crash
+    persistenceWorker->flush();
+    if (runId == 0) {
+        fmt::print(stderr, "RunJournal: Could not archive the interrupted run; keeping its journal.\n");
+        return;
+    }
+    runJournal->discardRecovered();
+    fmt::print("RunJournal: Recovered an interrupted run (score {}, {:.1f}s) into the run archive.\n",
+               interruptedRun.score, interruptedRun.gameTime);
 }
 
 void MonkeyTyperGame::submitHighScore(const std::string& playerName) {
     if (newHighScoreEligibleFlag) {
-        highScoreManager->addHighScore(playerName, score, scoreHistory);
-        highScoreManager->saveHighScores("../util/highscores.txt");
+        highScoreManager->addHighScore(lastRunId, playerName, session->getScore(), currentRunConfig);
     }
     newHighScoreEligibleFlag = false;
     highScoreNamePromptAttempted = true;
@@ -222,12 +331,7 @@ void MonkeyTyperGame::submitHighScore(const std::string& playerName) {
 
 bool MonkeyTyperGame::isNewHighScoreEligible(int currentScoreValue) const {
     if (currentScoreValue <= 0) return false;
-    const auto& currentHighScores = highScoreManager->getHighScores();
-    if (currentHighScores.size() < highScoreManager->MAX_HIGH_SCORES) {
-        return true;
-    }
-    if (currentHighScores.empty()) return true;
-    return currentScoreValue > currentHighScores.back().second;
+    return highScoreManager->qualifies(currentRunConfig, currentScoreValue);
 }
 
 std::shared_ptr<sf::Font> MonkeyTyperGame::getCurrentFont() const {
@@ -275,6 +379,32 @@ SettingsManager& MonkeyTyperGame::getSettingsManager() const {
     return *settingsManager;
 }
 
+PersistenceWorker& MonkeyTyperGame::getPersistenceWorker() const {
+    return *persistenceWorker;
+}
+
+KeystrokeAnalytics& MonkeyTyperGame::getKeystrokeAnalytics() const {
+    return *keystrokeAnalytics;
+}
+
+std::string MonkeyTyperGame::exportRuns() {
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string stem = fmt::format("../util/exports/runs-{}", now);
+    // Queued behind pending run log commits; the exporter reads its own snapshot of the logs.
+    persistenceWorker->post("export", [stem] {
+        std::error_code ec;
+        std::filesystem::create_directories("../util/exports", ec);
+        RunExporter exporter("../util/runs.log", "../util/runs.idx", "../util/keystrokes.bin");
+        exporter.exportTo(stem + ".csv", RunExporter::Format::CSV);
+        exporter.exportTo(stem + ".jsonl", RunExporter::Format::JSON_LINES);
+    });
+    return stem;
+}
+
+const std::string& MonkeyTyperGame::getSettingsPath() const {
+    return settingsPath;
+}
+
 bool MonkeyTyperGame::getHighScoreNamePromptAttemptedFlag() const {
     return highScoreNamePromptAttempted;
 }
@@ -285,271 +415,264 @@ void MonkeyTyperGame::setHighScoreNamePromptAttemptedFlag(bool attempted) {
 
 
 void MonkeyTyperGame::updateGame(float deltaTime) {
-    gameTime += deltaTime;
-    wordSpawnTimer += deltaTime;
-
-    for (auto it = activeWords.begin(); it != activeWords.end(); ) {
-        if (!(*it)) {
-            it = activeWords.erase(it);
-            continue;
-        }
-        (*it)->update(deltaTime);
-        if ((*it)->getSpeed() > 0 && (*it)->isOutOfBoundsRight()) {
-            endGame();
-            return;
-        }
-        if ( (*it)->isOutOfBounds() && ( (*it)->getSpeed() < 0 || ((*it)->isComplete() && (*it)->isOutOfBounds()) ) ) {
-            if ((*it)->getSpeed() < 0 && !(*it)->isComplete()) {
-                score = std::max(0, score - GameConstants::MISTAKE_PENALTY);
-                gameStats.mistakesMade++;
-            }
-            it = activeWords.erase(it);
-        } else {
-            ++it;
-        }
+    if (!session->update(deltaTime, InputLatencyMeter::nowMicros())) {
+        endGame();
+        return;
     }
+    runJournal->checkpoint(session->getGameTime(), session->getScore(), session->getGameStats());
+    updateHud();
+}
 
-    int completedThisFrame = 0;
-    int charsTypedThisFrame = 0;
-    int mistakesOnCompletedWordsThisFrame = 0;
-
-    activeWords.erase(std::remove_if(activeWords.begin(), activeWords.end(),
-                                     [&](std::unique_ptr<Word>& word) {
-                                         if (!word) return false;
-                                         if (word->isComplete()) {
-                                             score += word->getText().length() * (word->isLinked() ? 2 : 1);
-                                             completedThisFrame++;
-                                             charsTypedThisFrame += word->getText().length();
-                                             mistakesOnCompletedWordsThisFrame += word->getMistakesCount();
-                                             return true;
-                                         }
-                                         return false;
-                                     }), activeWords.end());
-
-    gameStats.wordsTyped += completedThisFrame;
-    gameStats.charactersTyped += charsTypedThisFrame;
-    gameStats.mistakesMade += mistakesOnCompletedWordsThisFrame;
-
-    if (gameTime > 0.001f) {
-        gameStats.wordsPerMinute = (static_cast<float>(gameStats.charactersTyped) / 5.0f) / (gameTime / 60.0f);
-        if (gameStats.wordsPerMinute < 0) gameStats.wordsPerMinute = 0;
-
-        int totalCharsForAccuracy = gameStats.charactersTyped;
-        int totalMistakesForAccuracy = gameStats.mistakesMade;
+void MonkeyTyperGame::updateHud() {
+    if (!uiManager) return;
+    const GameConstants::GameStats& stats = session->getGameStats();
+    const TypingStatsEngine& typing = session->getTypingStats();
+    uiManager->scoreTextDisplay.setString(fmt::format("Score: {}", session->getScore()));
+    uiManager->gameTimeStatsTextDisplay.setString(fmt::format(
+            "Time: {:.1f}s | WPM: {:.1f} (raw {:.1f}) | Now: {:.0f} | 10s: {:.0f} | Peak: {:.0f} | Acc: {:.1f}%",
+            session->getGameTime(), stats.wordsPerMinute, stats.rawWordsPerMinute, typing.netWpm(TypingStatsEngine::INSTANT),
+            typing.netWpm(TypingStatsEngine::SHORT), stats.peakWordsPerMinute, stats.accuracy));
+    // summarize() sorts every sample of the run, so the overlay is refreshed at a fixed rate, not every frame.
+    uint64_t nowMicros = showLatencyOverlay ? InputLatencyMeter::nowMicros() : 0;
+    if (showLatencyOverlay && nowMicros >= latencyOverlayDueMicros) {
+        latencyOverlayDueMicros = nowMicros + GameConstants::INPUT_LATENCY_OVERLAY_REFRESH_MICROS;
+        const InputLatencySummary& latency = inputLatency.summarize();
+        uiManager->latencyOverlayDisplay.setString(fmt::format(
+                "Input latency p50 {:.1f} ms | p95 {:.1f} ms | p99 {:.1f} ms ({} keys)",
+                latency.p50Ms, latency.p95Ms, latency.p99Ms, latency.samples));
+    }
+}
 
-        int accuracyDenominator = totalCharsForAccuracy + totalMistakesForAccuracy;
-        gameStats.accuracy = accuracyDenominator > 0 ? (static_cast<float>(totalCharsForAccuracy) / accuracyDenominator) * 100.0f : 100.0f;
+GameSession::Settings MonkeyTyperGame::buildSessionSettings() const {
+    GameSession::Settings settings;
+    settings.wordSpeedMultiplier = settingsManager->getWordSpeedMultiplier();
+    settings.spawnRateMultiplier = settingsManager->getSpawnRateMultiplier();
+    settings.linkedWords = settingsManager->useLinkedWords();
+    settings.freeTyping = settingsManager->freeTyping();
+    settings.highlightTyping = settingsManager->isHighlightTypingEnabled();
+    settings.fontSize = settingsManager->getCurrentFontSize();
+    return settings;
+}
 
-        if (gameStats.accuracy < 0) gameStats.accuracy = 0;
-        if (gameStats.accuracy > 100) gameStats.accuracy = 100;
-    } else {
-        gameStats.wordsPerMinute = 0;
-        gameStats.accuracy = 100.0f;
+const sf::Font& MonkeyTyperGame::pickSpawnFont(std::mt19937& randomGen) {
+    std::shared_ptr<sf::Font> fontToUse = currentGlobalFont;
+    if (settingsManager->randomizeFontsEnabled) {
+        if (!settingsManager->getRandomizedFontNames().empty()) {
+            auto& rFonts = settingsManager->getRandomizedFontNames();
+            auto it = rFonts.begin();
+            std::uniform_int_distribution<size_t> dist(0, rFonts.size() - 1);
+            std::advance(it, dist(randomGen));
+            fontToUse = fontManager->getFont(*it);
+        } else if(!fontManager->getAvailableFonts().empty()){
+            fontToUse = fontManager->getRandomFont();
+        } else {
+            fontToUse = fontManager->getDefaultFont();
+        }
     }
-
-    float spawnInterval = GameConstants::WORD_SPAWN_INTERVAL / settingsManager->getSpawnRateMultiplier();
-    if (wordSpawnTimer >= spawnInterval) {
-        wordSpawnTimer = 0;
-        spawnWord();
+    if (!fontToUse) {
+        fontToUse = fontManager->getDefaultFont();
     }
+    // Fonts are never destroyed while the game runs (FontManager retires replaced ones).
+    return *fontToUse;
+}
 
-    if (gameTime - lastScoreRecordTime >= 1.0f) {
-        lastScoreRecordTime = gameTime;
-        scoreHistory.push_back({gameTime, score});
-        if (scoreHistory.size() > GameConstants::MAX_HISTORY_POINTS) {
-            scoreHistory.pop_front();
-        }
+void MonkeyTyperGame::onSessionKey(const GameSession::KeyOutcome& key) {
+    if (gameState == GameState::ATTRACT) return; // The demo bot's keys are not the player's
+    if (key.expected != 0 && key.targetText && weaknessTrainer) {
+        weaknessTrainer->recordKeystroke(*key.targetText, key.expected, key.previous, key.mistake);
     }
-    if (uiManager) {
-        uiManager->scoreTextDisplay.setString(fmt::format("Score: {}", score));
-        uiManager->gameTimeStatsTextDisplay.setString(fmt::format("Time: {:.1f}s | WPM: {:.1f} | Acc: {:.1f}%",
-                                                                  gameTime, gameStats.wordsPerMinute, gameStats.accuracy));
+    keystrokeTelemetry->recordKey(key.typed, key.expected, key.wordId, key.flags);
+    if (!(key.flags & KeystrokeRecord::UNTARGETED)) {
+        inputLatency.keyDelivered(key.micros); // The key changed what is drawn next frame
     }
 }
 
-void MonkeyTyperGame::spawnWord() {
-    static std::mt19937 spawn_random_gen(std::random_device{}());
+RunConfig MonkeyTyperGame::buildRunConfig() const {
+    RunConfig config;
+    config.wordSpeedPercent = static_cast<uint16_t>(std::lround(settingsManager->getWordSpeedMultiplier() * 100.f));
+    config.spawnRatePercent = static_cast<uint16_t>(std::lround(settingsManager->getSpawnRateMultiplier() * 100.f));
+    if (settingsManager->useLinkedWords()) config.flags |= RunConfig::LINKED_WORDS;
+    if (session->getParagraphView()) config.flags |= RunConfig::PARAGRAPH_MODE;
+    if (settingsManager->freeTyping()) config.flags |= RunConfig::FREE_TYPING;
+    if (settingsManager->weaknessTraining()) config.flags |= RunConfig::WEAKNESS_TRAINING;
+    config.pseudoWordMode = static_cast<uint8_t>(settingsManager->getPseudoWordMode());
+
+    // The same sets the spawner draws from (see pickSpawnWordText).
+    std::vector<std::string> setNames = wordDbManager->getWordSetNames();
+    if (!settingsManager->randomizeWordSets()) {
+        size_t index = wordDbManager->getCurrentWordSetIndex();
+        config.wordSet = index < setNames.size() ? setNames[index] : "Default";
+    } else if (settingsManager->getRandomizedWordSetIndices().empty()) {
+        config.wordSet = "All sets";
+    } else {
+        for (size_t index : settingsManager->getRandomizedWordSetIndices()) {
+            if (index >= setNames.size()) continue;
+            if (!config.wordSet.empty()) config.wordSet += '+';
+            config.wordSet += setNames[index];
+        }
+    }
+    return config;
+}
 
-    std::string wordTextToSpawn;
+const std::string& MonkeyTyperGame::pickSpawnWordText(std::mt19937& randomGen) {
+    if (settingsManager->weaknessTraining() && weaknessTrainer) {
+        if (const std::string* drilled = weaknessTrainer->sampleWord(randomGen)) {
+            return *drilled;
+        }
+    }
 
+    size_t setIndex = wordDbManager->getCurrentWordSetIndex();
+    bool drawFromChosenSet = false;
     if (settingsManager->randomizeWordSets()) {
         const auto& randomizedSetIndices = settingsManager->getRandomizedWordSetIndices();
         if (!randomizedSetIndices.empty()) {
             auto it = randomizedSetIndices.begin();
             std::uniform_int_distribution<size_t> dist(0, randomizedSetIndices.size() - 1);
-            std::advance(it, dist(spawn_random_gen));
-            wordTextToSpawn = wordDbManager->getRandomWordFromSet(*it);
+            std::advance(it, dist(randomGen));
+            setIndex = *it;
+            drawFromChosenSet = true;
         } else if (!wordDbManager->getAllWordSets().empty()) {
             std::uniform_int_distribution<size_t> dist(0, wordDbManager->getAllWordSets().size() - 1);
-            wordTextToSpawn = wordDbManager->getRandomWordFromSet(dist(spawn_random_gen));
-        } else {
-            wordTextToSpawn = wordDbManager->getRandomWord();
+            setIndex = dist(randomGen);
+            drawFromChosenSet = true;
         }
-    } else {
-        wordTextToSpawn = wordDbManager->getRandomWord();
-    }
-    if (wordTextToSpawn.empty() || wordTextToSpawn == "error") {
-        wordTextToSpawn = "fallback";
     }
 
-    std::uniform_int_distribution<int> heightDist(100, GameConstants::WINDOW_HEIGHT - 150);
-    float speed = GameConstants::BASE_SPEED * settingsManager->getWordSpeedMultiplier();
-    unsigned int fontSize = settingsManager->getCurrentFontSize();
-    std::shared_ptr<sf::Font> fontToUse = currentGlobalFont;
+    if (settingsManager->getPseudoWordMode() != GameConstants::PseudoWordMode::OFF) {
+        const std::string& generated = wordDbManager->getGeneratedWordFromSet(setIndex, settingsManager->getPseudoWordMode());
+        if (!generated.empty()) {
+            return generated;
+        }
+    }
+    return drawFromChosenSet ? wordDbManager->getRandomWordFromSet(setIndex) : wordDbManager->getRandomWord();
+}
 
-    if (settingsManager->randomizeFontsEnabled) {
-        if (!settingsManager->getRandomizedFontNames().empty()) {
-            auto& rFonts = settingsManager->getRandomizedFontNames();
-            auto it = rFonts.begin();
-            std::uniform_int_distribution<size_t> dist(0, rFonts.size() - 1);
-            std::advance(it, dist(spawn_random_gen));
-            fontToUse = fontManager->getFont(*it);
-        } else if(!fontManager->getAvailableFonts().empty()){
-            fontToUse = fontManager->getRandomFont();
+void MonkeyTyperGame::rebuildTrainingIndex() {
+    // Index exactly the pool spawnWord would otherwise draw from.
+    std::vector<const std::vector<std::string>*> sources;
+    if (settingsManager->randomizeWordSets()) {
+        const auto& randomizedSetIndices = settingsManager->getRandomizedWordSetIndices();
+        if (!randomizedSetIndices.empty()) {
+            for (size_t index : randomizedSetIndices) {
+                sources.push_back(wordDbManager->getWordSetByIndexPtr(index));
+            }
         } else {
-            fontToUse = fontManager->getDefaultFont();
+            for (const auto& set : wordDbManager->getAllWordSets()) {
+                sources.push_back(&set);
+            }
         }
+    } else {
+        sources.push_back(&wordDbManager->getCurrentWordDatabase());
     }
-    if (!fontToUse) {
-        fontToUse = fontManager->getDefaultFont();
+    weaknessTrainer->rebuildIndex(sources);
+}
+
+void MonkeyTyperGame::applyHotReloads() {
+    if (fontManager->applyPendingUpdates()) {
+        bool currentStillAvailable = false;
+        for (const auto& [name, f_ptr] : fontManager->getAvailableFonts()) {
+            if (f_ptr == currentGlobalFont) { currentStillAvailable = true; break; }
+        }
+        if (!currentStillAvailable) {
+            // Words already on screen keep the old font; everything created from now on uses the new one.
+            setCurrentFont(settingsManager->randomizeFonts() ? fontManager->getRandomFont()
+                                                             : fontManager->getFont(settingsManager->explicitlySelectedFontName));
+        }
     }
 
-    bool makeLinked = settingsManager->useLinkedWords() && (std::uniform_int_distribution<int>(0, 100)(spawn_random_gen) < 30);
-
-    if (makeLinked) {
-        int wordCount = std::uniform_int_distribution<int>(2, std::min(4, 2 + score / 30))(spawn_random_gen);
-        std::vector<std::string> linkedWordTextsList;
-        std::vector<float> yPositionsList;
-        float wordHeightEstimate = fontToUse->getLineSpacing(fontSize);
-
-        for (int i = 0; i < wordCount; ++i) {
-            std::string partText;
-            if (settingsManager->randomizeWordSets()) {
-                const auto& randomizedSetIndices = settingsManager->getRandomizedWordSetIndices();
-                if (!randomizedSetIndices.empty()) {
-                    auto it = randomizedSetIndices.begin(); std::uniform_int_distribution<size_t> dist(0, randomizedSetIndices.size()-1); std::advance(it, dist(spawn_random_gen)); partText = wordDbManager->getRandomWordFromSet(*it);
-                } else if(!wordDbManager->getAllWordSets().empty()) {
-                    std::uniform_int_distribution<size_t> dist(0, wordDbManager->getAllWordSets().size()-1); partText = wordDbManager->getRandomWordFromSet(dist(spawn_random_gen));
-                } else {partText = wordDbManager->getRandomWord();}
-            } else {
-                partText = wordDbManager->getRandomWord();
-            }
-            if(partText.empty() || partText == "error") partText = "lpart";
-            linkedWordTextsList.push_back(partText);
-
-            float attemptY;
-            int yAttempts = 0;
-            bool positionFound = false;
-
-            while(!positionFound && yAttempts < 15) {
-                attemptY = static_cast<float>(heightDist(spawn_random_gen));
-                bool collision = false;
-                for (const auto& existingWord : activeWords) {
-                    if (existingWord) {
-                        sf::FloatRect existingBounds;
-                        if (existingWord->isLinked()) {
-                            const auto& lw = static_cast<const LinkedWord&>(*existingWord);
-                            if (!lw.getWordTexts().empty() && lw.getCurrentPart() >=0 && lw.getCurrentPart() < static_cast<int>(lw.getWordTexts().size())) {
-                                existingBounds = lw.getWordTexts()[lw.getCurrentPart()].getGlobalBounds();
-                            } else continue;
-                        } else {
-                            existingBounds = existingWord->getSfText().getGlobalBounds();
-                        }
-                        if (attemptY < existingBounds.top + existingBounds.height && attemptY + wordHeightEstimate > existingBounds.top) {
-                            collision = true;
-                            break;
-                        }
-                    }
-                }
-                for (float prevY : yPositionsList) {
-                    if (std::abs(prevY - attemptY) < wordHeightEstimate * 0.9f) {
-                        collision = true;
-                        break;
-                    }
-                }
-                if (!collision) positionFound = true;
-                yAttempts++;
-            }
-            if(!positionFound) {
-                attemptY = yPositionsList.empty() ? static_cast<float>(heightDist(spawn_random_gen)) : (yPositionsList.back() + wordHeightEstimate + 10.f);
-                if(attemptY > GameConstants::WINDOW_HEIGHT - wordHeightEstimate - 20.f) {
-                    attemptY = static_cast<float>(heightDist(spawn_random_gen));
-                } else if (attemptY < 50.f) {
-                    attemptY = 50.f;
-                }
-            }
-            yPositionsList.push_back(attemptY);
+    std::vector<std::ptrdiff_t> indexRemap;
+    if (wordDbManager->applyPendingUpdates(indexRemap)) {
+        if (!indexRemap.empty()) {
+            settingsManager->remapRandomizedWordSets(indexRemap);
         }
-        if (yPositionsList.empty()) {
-            yPositionsList.push_back(static_cast<float>(heightDist(spawn_random_gen)));
+        if (gameState == GameState::PLAYING && settingsManager->weaknessTraining()) {
+            rebuildTrainingIndex();
         }
-        if (linkedWordTextsList.empty()){
-            linkedWordTextsList.push_back("linkErr");
+    }
+}
+
+std::unique_ptr<ParagraphView> MonkeyTyperGame::createParagraphView(std::mt19937& randomGen) {
+    // Prefer a text from the texts folder; fall back to the current word list as running text.
+    std::vector<std::string> textFiles;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("../texts", ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".txt") {
+            textFiles.push_back(entry.path().string());
         }
-        activeWords.emplace_back(std::make_unique<LinkedWord>(linkedWordTextsList, *fontToUse, speed, sf::Vector2f(-150.f, yPositionsList[0]), fontSize, yPositionsList));
+    }
+    std::string textPath;
+    if (!textFiles.empty()) {
+        textPath = textFiles[std::uniform_int_distribution<size_t>(0, textFiles.size() - 1)(randomGen)];
     } else {
-        sf::Vector2f position(-100.f, static_cast<float>(heightDist(spawn_random_gen)));
-        activeWords.emplace_back(std::make_unique<Word>(wordTextToSpawn, *fontToUse, speed, position, fontSize));
+        const auto names = wordDbManager->getWordSetNames();
+        size_t setIndex = wordDbManager->getCurrentWordSetIndex();
+        if (setIndex >= names.size()) return nullptr;
+        textPath = "../dictionary/" + names[setIndex];
+    }
+    if (!std::filesystem::exists(textPath, ec)) {
+        fmt::print(stderr, "Paragraph mode: no text to stream, playing with flying words instead.\n");
+        return nullptr;
     }
+
+    auto source = std::make_unique<TextStreamSource>(textPath);
+    source->start(randomGen());
+    fmt::print("Paragraph mode: streaming '{}'.\n", textPath);
+    return std::make_unique<ParagraphView>(std::move(source), *currentGlobalFont, settingsManager->getCurrentFontSize());
 }
 
 void MonkeyTyperGame::processPlayingEvents(sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+        showLatencyOverlay = !showLatencyOverlay;
+        latencyOverlayDueMicros = 0;
+        return;
+    }
     if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-        for (auto& word : activeWords) {
-            if (word && word->isBeingActivelyTyped()) {
-                word->resetTyping();
-                break;
-            }
-        }
+        session->cancelTyping();
         return;
     }
-
     if (event.type == sf::Event::TextEntered) {
-        sf::Uint32 unicode = event.text.unicode;
-        if ((unicode < 32 || unicode > 126) && unicode != 8) {
-            return;
-        }
-
-        Word* wordBeingTyped = nullptr;
-        for (auto& word : activeWords) {
-            if (word && word->isBeingActivelyTyped() && !word->isComplete()) {
-                wordBeingTyped = word.get();
-                break;
-            }
-        }
-
-        if (wordBeingTyped) {
-            wordBeingTyped->processInput(unicode, settingsManager->isHighlightTypingEnabled());
-        } else if (unicode != 8 && unicode >=32 && unicode <=126) {
-            std::vector<Word*> matchingWords;
-            char firstCharTyped = static_cast<char>(tolower(unicode));
+        session->processText(event.text.unicode, eventPolledMicros);
+    }
+}
 
-            for (auto& word : activeWords) {
-                if (word && !word->isComplete() && !word->getText().empty() &&
-                    tolower(word->getText()[0]) == firstCharTyped) {
-                    matchingWords.push_back(word.get());
-                }
-            }
+void MonkeyTyperGame::startAttract() {
+    if (!attractBot) {
+        static std::mt19937 attract_seed_gen(std::random_device{}());
+        attractBot = std::make_unique<TypistBot>(TypistBot::Profile{}, attract_seed_gen());
+    }
+    attractBot->reset();
+    setGameState(GameState::ATTRACT);
+    session->start(buildSessionSettings(), InputLatencyMeter::nowMicros()); // Flying words, also in paragraph mode
+    fontManager->releaseRetiredFonts();
+    updateHud();
+}
 
-            if (!matchingWords.empty()) {
-                std::sort(matchingWords.begin(), matchingWords.end(), [](const Word* a, const Word* b) {
-                    if (!a) return false; if (!b) return true;
-                    return a->getPosition().x > b->getPosition().x;
-                });
+void MonkeyTyperGame::updateAttract(float deltaTime) {
+    uint64_t nowMicros = InputLatencyMeter::nowMicros();
+    sf::Event event;
+    float lateBy = 0.f;
+    if (attractBot->update(*session, deltaTime, event, lateBy)) {
+        // The bot's key goes through the same path as a key taken off the window's queue.
+        eventPolledMicros = nowMicros - static_cast<uint64_t>(lateBy * 1e6f);
+        processPlayingEvents(event);
+    }
+    if (!session->update(deltaTime, nowMicros)) {
+        startAttract(); // Lost: the demo starts over
+        return;
+    }
+    updateHud();
+}
 
-                for(auto& w : activeWords) {
-                    if(w && w.get() != matchingWords[0]) {
-                        w->setAsActiveTypingTarget(false);
-                    }
-                }
-                matchingWords[0]->setAsActiveTypingTarget(true);
-                matchingWords[0]->processInput(unicode, settingsManager->isHighlightTypingEnabled());
-            }
-        }
+void MonkeyTyperGame::processAttractEvents(const sf::Event& event) {
+    if (event.type == sf::Event::KeyPressed || event.type == sf::Event::MouseButtonPressed) {
+        setGameState(GameState::MENU);
     }
 }
 
 void MonkeyTyperGame::renderGame() {
+    if (const ParagraphView* paragraphView = session->getParagraphView()) {
+        paragraphView->draw(window);
+    }
     if (settingsManager->getCurrentInputStyle() == GameConstants::InputDisplayStyle::CENTERED) {
         sf::RectangleShape pathGuide(sf::Vector2f(GameConstants::WINDOW_WIDTH, 5));
         pathGuide.setFillColor(sf::Color(80, 80, 80, 150));
@@ -557,19 +680,11 @@ void MonkeyTyperGame::renderGame() {
         window.draw(pathGuide);
     }
 
-    for (const auto& word : activeWords) {
+    for (const auto& word : session->getActiveWords()) {
         if (word) {
             word->draw(window);
             if (settingsManager->isHighlightTypingEnabled() && word->isBeingActivelyTyped()) {
-                sf::FloatRect bounds;
-                if (word->isLinked()){
-                    const auto& lw = static_cast<const LinkedWord&>(*word);
-                    if (lw.getCurrentPart() >= 0 && lw.getCurrentPart() < static_cast<int>(lw.getWordTexts().size())) {
-                        bounds = lw.getWordTexts()[lw.getCurrentPart()].getGlobalBounds();
-                    } else continue;
-                } else {
-                    bounds = word->getSfText().getGlobalBounds();
-                }
+                sf::FloatRect bounds = word->getTypingBounds();
                 if (bounds.width > 0 && bounds.height > 0) {
                     sf::RectangleShape highlightRect(sf::Vector2f(bounds.width + 10, bounds.height + 6));
                     highlightRect.setFillColor(sf::Color(255, 255, 0, 50));
@@ -580,7 +695,7 @@ void MonkeyTyperGame::renderGame() {
         }
     }
 
-    for (const auto& word : activeWords) {
+    for (const auto& word : session->getActiveWords()) {
         if (word && word->isBeingActivelyTyped() && !word->getCurrentInput().empty()) {
             sf::Text inputDisplay(word->getCurrentInput(), *currentGlobalFont, settingsManager->getCurrentFontSize());
             inputDisplay.setFillColor(sf::Color(100, 255, 100));
@@ -592,23 +707,16 @@ void MonkeyTyperGame::renderGame() {
                     break;
                 case GameConstants::InputDisplayStyle::BELOW_WORD:
                 {
-                    sf::FloatRect wordBounds;
-                    if (word->isLinked()){
-                        const auto& lw = static_cast<const LinkedWord&>(*word);
-                        if (lw.getCurrentPart() >= 0 && lw.getCurrentPart() < static_cast<int>(lw.getWordTexts().size())) {
-                            wordBounds = lw.getWordTexts()[lw.getCurrentPart()].getGlobalBounds();
-                        } else { break; }
-                    } else {
-                        wordBounds = word->getSfText().getGlobalBounds();
-                    }
+                    sf::FloatRect wordBounds = word->getTypingBounds();
                     textPos = sf::Vector2f(wordBounds.left, wordBounds.top + wordBounds.height + 3);
                 }
                     break;
                 case GameConstants::InputDisplayStyle::CENTERED:
                 {
-                    sf::FloatRect inputBounds = inputDisplay.getLocalBounds();
-                    textPos = sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - inputBounds.width / 2.0f,
-                                           GameConstants::WINDOW_HEIGHT / 2.0f - inputBounds.height / 2.0f + 30.0f);
+                    const GlyphMetrics& inputMetrics = GlyphMetrics::get(*currentGlobalFont, settingsManager->getCurrentFontSize());
+                    float inputWidth = inputMetrics.measure(word->getCurrentInput());
+                    textPos = sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - inputWidth / 2.0f,
+                                           GameConstants::WINDOW_HEIGHT / 2.0f - inputMetrics.getTextHeight() / 2.0f + 30.0f);
                 }
                     break;
             }
@@ -617,13 +725,29 @@ void MonkeyTyperGame::renderGame() {
             break;
         }
     }
+    if (session->isFreeTyping() && !session->getFreeTypingInput().empty()) {
+        const std::string& typed = session->getFreeTypingInput();
+        std::string tail = typed.substr(typed.size() - std::min(typed.size(), GameConstants::FREE_TYPING_DISPLAY_CHARS));
+        sf::Text inputDisplay(tail, *currentGlobalFont, settingsManager->getCurrentFontSize());
+        inputDisplay.setFillColor(sf::Color(100, 255, 100));
+        if (settingsManager->getCurrentInputStyle() == GameConstants::InputDisplayStyle::UNDER_CURSOR) {
+            inputDisplay.setPosition(sf::Vector2f(sf::Mouse::getPosition(window).x + 7.f, sf::Mouse::getPosition(window).y + 20.f));
+        } else {
+            // No single word to sit below, so Below Word shares the centered placement.
+            const GlyphMetrics& inputMetrics = GlyphMetrics::get(*currentGlobalFont, settingsManager->getCurrentFontSize());
+            inputDisplay.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - inputMetrics.measure(tail) / 2.0f,
+                                                  GameConstants::WINDOW_HEIGHT / 2.0f - inputMetrics.getTextHeight() / 2.0f + 30.0f));
+        }
+        window.draw(inputDisplay);
+    }
     if(uiManager) {
         window.draw(uiManager->scoreTextDisplay);
         window.draw(uiManager->gameTimeStatsTextDisplay);
+        if (showLatencyOverlay) window.draw(uiManager->latencyOverlayDisplay);
     }
 }
 
-const GameConstants::GameStats& MonkeyTyperGame::getGameStats() const { return gameStats; }
-float MonkeyTyperGame::getGameTime() const { return gameTime; }
-int MonkeyTyperGame::getScore() const { return score; }
-const std::deque<ScorePoint>& MonkeyTyperGame::getScoreHistory() const { return scoreHistory; }
\ No newline at end of file
+const GameConstants::GameStats& MonkeyTyperGame::getGameStats() const { return session->getGameStats(); }
+float MonkeyTyperGame::getGameTime() const { return session->getGameTime(); }
+int MonkeyTyperGame::getScore() const { return session->getScore(); }
+const ScoreTimeline& MonkeyTyperGame::getScoreTimeline() const { return session->getScoreTimeline(); }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "../include/ParagraphView.h"
+#include "../include/TextStreamSource.h"
+#include "../include/GlyphMetrics.h"
+#include "../include/Constants.h"
+#include <cmath>
+#include <algorithm>
+
+ParagraphView::ParagraphView(std::unique_ptr<TextStreamSource> source, const sf::Font& font, unsigned int fontSize)
+        : source(std::move(source)), font(font), fontSize(fontSize),
+          metrics(GlyphMetrics::get(font, fontSize)),
+          lineWidth(GameConstants::WINDOW_WIDTH - 2.f * GameConstants::PARAGRAPH_MARGIN_X),
+          currentLine(0), currentWordInLine(0), scrollOffset(0.f) {
+    appendLine();
+}
+
+ParagraphView::~ParagraphView() = default;
+
+void ParagraphView::update(float deltaTime) {
+    layoutIncomingWords();
+    // Exponential ease: frame-rate independent and never overshoots.
+    scrollOffset *= std::exp(-GameConstants::PARAGRAPH_SCROLL_RATE * deltaTime);
+    if (std::abs(scrollOffset) < 0.5f) scrollOffset = 0.f;
+}
+
+void ParagraphView::appendLine() {
+    Line& line = lines.emplace_back();
+    line.typedText.setFont(font);
+    line.typedText.setCharacterSize(fontSize);
+    line.typedText.setFillColor(sf::Color(110, 170, 110));
+    line.upcomingText.setFont(font);
+    line.upcomingText.setCharacterSize(fontSize);
+    line.upcomingText.setFillColor(sf::Color(220, 220, 220));
+}
+
+void ParagraphView::layoutIncomingWords() {
+    // Materialize only as many lines as can be shown; the rest waits in the source's queue.
+    const float spaceWidth = metrics.advance(' ');
+    while (lines.size() - currentLine <= GameConstants::PARAGRAPH_LOOKAHEAD_LINES) {
+        incoming.clear();
+        if (source->takeWords(incoming, GameConstants::PARAGRAPH_LAYOUT_BATCH) == 0) return;
+
+        for (auto& word : incoming) {
+            float wordWidth = metrics.measure(word);
+            Line* line = &lines.back();
+            float x = line->words.empty() ? 0.f : line->width + spaceWidth;
+            if (!line->words.empty() && x + wordWidth > lineWidth) {
+                appendLine();
+                line = &lines.back();
+                x = 0.f;
+            }
+            line->words.push_back(PlacedWord{std::move(word), x});
+            line->width = x + wordWidth;
+        }
+        stepLineIfFinished();
+    }
+}
+
+const std::string* ParagraphView::getCurrentWord() const {
+    const Line& line = lines[currentLine];
+    if (currentWordInLine >= line.words.size()) return nullptr;
+    return &line.words[currentWordInLine].text;
+}
+
+void ParagraphView::advance() {
+    if (currentWordInLine < lines[currentLine].words.size()) {
+        ++currentWordInLine;
+    }
+    stepLineIfFinished();
+}
+
+void ParagraphView::stepLineIfFinished() {
+    // Step to the next line only once it exists; until then the current line may still grow.
+    if (currentWordInLine >= lines[currentLine].words.size() && currentLine + 1 < lines.size()) {
+        ++currentLine;
+        currentWordInLine = 0;
+        scrollOffset += metrics.getLineSpacing();
+        if (currentLine > 1) {
+            lines.pop_front();
+            --currentLine;
+        }
+    }
+}
+
+float ParagraphView::lineY(size_t lineIndex) const {
+    float spacing = metrics.getLineSpacing();
+    return GameConstants::PARAGRAPH_TOP_Y + (static_cast<float>(lineIndex) - static_cast<float>(currentLine) + 1.f) * spacing + scrollOffset;
+}
+
+sf::Vector2f ParagraphView::getCurrentWordPosition() const {
+    const Line& line = lines[currentLine];
+    float x = currentWordInLine < line.words.size() ? line.words[currentWordInLine].x : line.width;
+    return sf::Vector2f(GameConstants::PARAGRAPH_MARGIN_X + x, lineY(currentLine));
+}
+
+void ParagraphView::setSegmentString(sf::Text& text, const Line& line, size_t first, size_t last) const {
+    joined.clear();
+    for (size_t i = first; i < last; ++i) {
+        if (i > first) joined += ' ';
+        joined += line.words[i].text;
+    }
+    text.setString(joined);
+}
+
+void ParagraphView::refreshLineText(const Line& line, size_t typedEnd, size_t upcomingBegin) const {
+    if (line.typedEnd != typedEnd || line.builtWordCount != line.words.size()) {
+        setSegmentString(line.typedText, line, 0, typedEnd);
+    }
+    if (line.upcomingBegin != upcomingBegin || line.builtWordCount != line.words.size()) {
+        setSegmentString(line.upcomingText, line, upcomingBegin, line.words.size());
+    }
+    line.typedEnd = typedEnd;
+    line.upcomingBegin = upcomingBegin;
+    line.builtWordCount = line.words.size();
+}
+
+void ParagraphView::draw(sf::RenderWindow& window) const {
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const Line& line = lines[i];
+        size_t wordCount = line.words.size();
+        if (i < currentLine) {
+            refreshLineText(line, wordCount, wordCount);
+        } else if (i == currentLine) {
+            refreshLineText(line, currentWordInLine, std::min(currentWordInLine + 1, wordCount));
+        } else {
+            refreshLineText(line, 0, 0);
+        }
+
+        float y = lineY(i);
+        if (line.typedEnd > 0) {
+            line.typedText.setPosition(sf::Vector2f(GameConstants::PARAGRAPH_MARGIN_X, y));
+            window.draw(line.typedText);
+        }
+        if (line.upcomingBegin < wordCount) {
+            line.upcomingText.setPosition(sf::Vector2f(GameConstants::PARAGRAPH_MARGIN_X + line.words[line.upcomingBegin].x, y));
+            window.draw(line.upcomingText);
+        }
+    }
+}
+
+bool ParagraphView::hasFailed() const {
+    return source->hasFailed();
+}
@@ -0,0 +1,148 @@
+#include "../include/PersistenceWorker.h"
+#include "../include/Constants.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MONKEY_TYPER_HAS_FSYNC 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+PersistenceWorker::PersistenceWorker() {
+    worker = std::thread(&PersistenceWorker::runWorker, this);
+}
+
+PersistenceWorker::~PersistenceWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    wakeCondition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void PersistenceWorker::post(const std::string& key, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++submittedCount;
+        auto it = std::find_if(pending.begin(), pending.end(), [&key](const Job& queued) { return queued.key == key; });
+        if (it != pending.end()) {
+            it->run = std::move(job); // Keeps its place in the queue
+            ++finishedCount;
+        } else {
+            pending.push_back(Job{key, std::move(job)});
+        }
+    }
+    wakeCondition.notify_all();
+}
+
+void PersistenceWorker::saveFile(const std::string& path, std::function<std::string()> serialize) {
+    post(path, [path, serialize = std::move(serialize)] {
+        writeFileAtomically(path, serialize());
+    });
+}
+
+void PersistenceWorker::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = submittedCount;
+    if (finishedCount >= target) return;
+    flushRequested = true;
+    wakeCondition.notify_all();
+    doneCondition.wait(lock, [this, target] { return finishedCount >= target; });
+}
+
+void PersistenceWorker::runWorker() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeCondition.wait(lock, [this] { return stopRequested || !pending.empty(); });
+        if (pending.empty()) break; // Stopping with nothing left to do
+
+        // Let closely spaced saves pile up; a flush or shutdown cuts the wait short.
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(GameConstants::PERSISTENCE_COALESCE_MS),
+                               [this] { return stopRequested || flushRequested; });
+        flushRequested = false;
+
+        std::vector<Job> batch;
+        batch.swap(pending);
+        lock.unlock();
+        for (Job& job : batch) {
+            job.run();
+        }
+        lock.lock();
+        finishedCount += batch.size();
+        doneCondition.notify_all();
+    }
+}
+
+bool PersistenceWorker::writeFileAtomically(const std::string& path, const std::string& contents) {
+    std::string tempPath = path + ".tmp";
+#ifdef MONKEY_TYPER_HAS_FSYNC
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fmt::print(stderr, "PersistenceWorker: Could not create '{}'.\n", tempPath);
+        return false;
+    }
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+    bool ok = true;
+    while (ok && remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            ok = false;
+        } else {
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+#else
+    bool ok;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        out.flush();
+        ok = static_cast<bool>(out);
+    }
+#endif
+    std::error_code ec;
+    if (ok) {
+        fs::rename(tempPath, path, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        fmt::print(stderr, "PersistenceWorker: Could not save '{}'; the previous version is kept.\n", path);
+        fs::remove(tempPath, ec);
+        return false;
+    }
+#ifdef MONKEY_TYPER_HAS_FSYNC
+    // Make the rename itself durable.
+    fs::path directory = fs::path(path).parent_path();
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+    return true;
+}
+
+bool PersistenceWorker::syncFile(const std::string& path) {
+#ifdef MONKEY_TYPER_HAS_FSYNC
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#else
+    return true;
+#endif
+}
@@ -0,0 +1,265 @@
+#include "../include/RunExporter.h"
+#include "../include/Constants.h"
+#include <filesystem>
+#include <string_view>
+#include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+    void appendText(fmt::memory_buffer& out, std::string_view text) {
+        out.append(text.data(), text.data() + text.size());
+    }
+
+    void appendCsvField(fmt::memory_buffer& out, const std::string& text) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) {
+            appendText(out, text);
+            return;
+        }
+        out.push_back('"');
+        for (char c : text) {
+            if (c == '"') out.push_back('"');
+            out.push_back(c);
+        }
+        out.push_back('"');
+    }
+
+    void appendJsonString(fmt::memory_buffer& out, const std::string& text) {
+        out.push_back('"');
+        for (char c : text) {
+            switch (c) {
+                case '"':  appendText(out, "\\\""); break;
+                case '\\': appendText(out, "\\\\"); break;
+                case '\n': appendText(out, "\\n"); break;
+                case '\r': appendText(out, "\\r"); break;
+                case '\t': appendText(out, "\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        fmt::format_to(fmt::appender(out), "\\u{:04x}", static_cast<unsigned>(c));
+                    } else {
+                        out.push_back(c);
+                    }
+            }
+        }
+        out.push_back('"');
+    }
+
+    // History timestamps are whole milliseconds (see ScoreHistoryCodec); integer formatting keeps
+    // long histories at disk speed.
+    void appendHistoryPoint(fmt::memory_buffer& out, const ScorePoint& point, char separator) {
+        auto millis = static_cast<long long>(std::llround(std::max(0.f, point.timeStamp) * 1000.0));
+        fmt::format_int seconds(millis / 1000);
+        appendText(out, std::string_view(seconds.data(), seconds.size()));
+        char fraction[5] = {'.', static_cast<char>('0' + millis / 100 % 10), static_cast<char>('0' + millis / 10 % 10),
+                            static_cast<char>('0' + millis % 10), separator};
+        out.append(fraction, fraction + 5);
+        fmt::format_int score(point.score);
+        appendText(out, std::string_view(score.data(), score.size()));
+    }
+
+    const char* pseudoWordModeName(uint8_t mode) {
+        return mode < GameConstants::PSEUDO_WORD_MODE_NAMES.size() ? GameConstants::PSEUDO_WORD_MODE_NAMES[mode].c_str() : "Unknown";
+    }
+}
+
+RunExporter::Format RunExporter::formatForPath(const std::string& path) {
+    std::string extension = fs::path(path).extension().string();
+    return (extension == ".jsonl" || extension == ".json") ? Format::JSON_LINES : Format::CSV;
+}
+
+RunExporter::RunExporter(const std::string& logPath, const std::string& indexPath, const std::string& keystrokePath)
+        : logPath(logPath), indexPath(indexPath), keystrokePath(keystrokePath) {}
+
+size_t RunExporter::getExportedCount() const {
+    return exportedCount;
+}
+
+bool RunExporter::exportTo(const std::string& outPath, Format format) {
+    exportedCount = 0;
+    RunLog log(logPath, indexPath);
+    if (!log.openReadOnly()) return false;
+    keystrokesLeft = keystrokes.open(keystrokePath);
+    haveSummary = false;
+
+    out = std::fopen(outPath.c_str(), "wb");
+    if (!out) {
+        fmt::print(stderr, "RunExporter: Could not create '{}': {}.\n", outPath, std::strerror(errno));
+        return false;
+    }
+    buffer.clear();
+    if (format == Format::CSV) writeCsvHeader();
+
+    RunRecord run; // Reused, so the history buffer is allocated once
+    std::string name;
+    bool ok = true;
+    for (const RunLog::IndexEntry& entry : log.getEntries()) {
+        if (!log.readRun(entry.runOffset, run)) {
+            fmt::print(stderr, "RunExporter: Skipping unreadable run at offset {} in '{}'.\n", entry.runOffset, logPath);
+            continue;
+        }
+        bool named = entry.nameOffset != 0 && log.readName(entry.nameOffset, name);
+        const TypingSummary* typing = findTypingSummary(entry.runOffset);
+        if (format == Format::CSV) {
+            writeCsvRun(entry.runOffset, run, named ? &name : nullptr, typing);
+        } else {
+            writeJsonRun(entry.runOffset, run, named ? &name : nullptr, typing);
+        }
+        ++exportedCount;
+        if (!flushBuffer(false)) {
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && flushBuffer(true);
+    ok = std::fclose(out) == 0 && ok;
+    out = nullptr;
+    if (!ok) {
+        fmt::print(stderr, "RunExporter: Write to '{}' failed.\n", outPath);
+        std::error_code ec;
+        fs::remove(outPath, ec);
+        return false;
+    }
+    fmt::print("RunExporter: Exported {} runs to '{}'.\n", exportedCount, outPath);
+    return true;
+}
+
+bool RunExporter::nextTypingSummary(TypingSummary& out) {
+    out = TypingSummary{};
+    KeystrokeRecord record;
+    while (keystrokes.next(record)) {
+        switch (record.kind) {
+            case KeystrokeRecord::RUN_START:
+                out = TypingSummary{}; // A run that never ended (crash before recovery existed) is dropped
+                break;
+            case KeystrokeRecord::RUN_END:
+                if (record.value != 0) {
+                    out.runId = record.value;
+                    return true;
+                }
+                out = TypingSummary{}; // Not saved in the run log
+                break;
+            case KeystrokeRecord::KEY:
+                ++out.keys;
+                if (record.flags & KeystrokeRecord::CORRECT) ++out.correctKeys;
+                if (record.flags & KeystrokeRecord::BACKSPACE) ++out.backspaces;
+                if (record.sincePreviousMicros > 0 && record.sincePreviousMicros < GameConstants::KEYSTROKE_PAUSE_MICROS) {
+                    ++out.intervals;
+                    out.intervalSumMicros += record.sincePreviousMicros;
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+const RunExporter::TypingSummary* RunExporter::findTypingSummary(uint64_t runId) {
+    // Both logs are in run order, so the keystroke log only ever moves forward.
+    while (keystrokesLeft && (!haveSummary || summary.runId < runId)) {
+        haveSummary = nextTypingSummary(summary);
+        keystrokesLeft = haveSummary;
+    }
+    return haveSummary && summary.runId == runId ? &summary : nullptr;
+}
+
+void RunExporter::writeCsvHeader() {
+    const std::string header = "run_id,finished_at,name,score,game_time,wpm,accuracy,words_typed,characters_typed,mistakes,"
+                               "config_hash,config,word_speed_percent,spawn_rate_percent,linked_words,paragraph_mode,"
+                               "free_typing,weakness_training,pseudo_words,word_set,"
+                               "keys,correct_keys,backspaces,mean_key_interval_ms,"
+                               "latency_samples,latency_p50_ms,latency_p95_ms,latency_p99_ms,history\n";
+    appendText(buffer, header);
+}
+
+void RunExporter::writeCsvRun(uint64_t runId, const RunRecord& run, const std::string* name, const TypingSummary* typing) {
+    auto inserter = fmt::appender(buffer);
+    fmt::format_to(inserter, "{},{},", runId, run.finishedAt);
+    if (name) appendCsvField(buffer, *name);
+    const RunConfig& config = run.config;
+    fmt::format_to(inserter, ",{},{:.3f},{:.2f},{:.2f},{},{},{},{:08x},", run.score, run.gameTime, run.stats.wordsPerMinute,
+                   run.stats.accuracy, run.stats.wordsTyped, run.stats.charactersTyped, run.stats.mistakesMade, config.hash());
+    appendCsvField(buffer, config.label());
+    fmt::format_to(inserter, ",{},{},{:d},{:d},{:d},{:d},{},", config.wordSpeedPercent, config.spawnRatePercent,
+                   (config.flags & RunConfig::LINKED_WORDS) != 0, (config.flags & RunConfig::PARAGRAPH_MODE) != 0,
+                   (config.flags & RunConfig::FREE_TYPING) != 0, (config.flags & RunConfig::WEAKNESS_TRAINING) != 0,
+                   pseudoWordModeName(config.pseudoWordMode));
+    appendCsvField(buffer, config.wordSet);
+    if (typing) {
+        fmt::format_to(inserter, ",{},{},{},", typing->keys, typing->correctKeys, typing->backspaces);
+        if (typing->intervals > 0) fmt::format_to(inserter, "{:.1f}", typing->intervalSumMicros / 1000.0 / typing->intervals);
+        buffer.push_back(',');
+    } else {
+        appendText(buffer, ",,,,,");
+    }
+    const InputLatencySummary& latency = run.inputLatency;
+    if (latency.samples > 0) {
+        fmt::format_to(inserter, "{},{:.1f},{:.1f},{:.1f},", latency.samples, latency.p50Ms, latency.p95Ms, latency.p99Ms);
+    } else {
+        appendText(buffer, ",,,,");
+    }
+    // History as space-separated time:score pairs, so it stays one field.
+    for (size_t i = 0; i < run.history.size(); ++i) {
+        if (i > 0) buffer.push_back(' ');
+        appendHistoryPoint(buffer, run.history[i], ':');
+    }
+    buffer.push_back('\n');
+}
+
+void RunExporter::writeJsonRun(uint64_t runId, const RunRecord& run, const std::string* name, const TypingSummary* typing) {
+    auto inserter = fmt::appender(buffer);
+    fmt::format_to(inserter, "{{\"run_id\":{},\"finished_at\":{},\"name\":", runId, run.finishedAt);
+    if (name) {
+        appendJsonString(buffer, *name);
+    } else {
+        appendText(buffer, "null");
+    }
+    const RunConfig& config = run.config;
+    fmt::format_to(inserter, ",\"score\":{},\"game_time\":{:.3f},\"stats\":{{\"wpm\":{:.2f},\"accuracy\":{:.2f},"
+                             "\"words_typed\":{},\"characters_typed\":{},\"mistakes\":{}}},\"config\":{{\"hash\":\"{:08x}\",\"label\":",
+                   run.score, run.gameTime, run.stats.wordsPerMinute, run.stats.accuracy, run.stats.wordsTyped,
+                   run.stats.charactersTyped, run.stats.mistakesMade, config.hash());
+    appendJsonString(buffer, config.label());
+    fmt::format_to(inserter, ",\"word_speed_percent\":{},\"spawn_rate_percent\":{},\"linked_words\":{},\"paragraph_mode\":{},"
+                             "\"free_typing\":{},\"weakness_training\":{},\"pseudo_words\":\"{}\",\"word_set\":",
+                   config.wordSpeedPercent, config.spawnRatePercent, (config.flags & RunConfig::LINKED_WORDS) != 0,
+                   (config.flags & RunConfig::PARAGRAPH_MODE) != 0, (config.flags & RunConfig::FREE_TYPING) != 0,
+                   (config.flags & RunConfig::WEAKNESS_TRAINING) != 0, pseudoWordModeName(config.pseudoWordMode));
+    appendJsonString(buffer, config.wordSet);
+    appendText(buffer, "},\"keystrokes\":");
+    if (typing) {
+        fmt::format_to(inserter, "{{\"keys\":{},\"correct_keys\":{},\"backspaces\":{},\"mean_key_interval_ms\":",
+                       typing->keys, typing->correctKeys, typing->backspaces);
+        if (typing->intervals > 0) {
+            fmt::format_to(inserter, "{:.1f}}}", typing->intervalSumMicros / 1000.0 / typing->intervals);
+        } else {
+            appendText(buffer, "null}");
+        }
+    } else {
+        appendText(buffer, "null");
+    }
+    appendText(buffer, ",\"input_latency\":");
+    const InputLatencySummary& latency = run.inputLatency;
+    if (latency.samples > 0) {
+        fmt::format_to(inserter, "{{\"samples\":{},\"p50_ms\":{:.1f},\"p95_ms\":{:.1f},\"p99_ms\":{:.1f}}}",
+                       latency.samples, latency.p50Ms, latency.p95Ms, latency.p99Ms);
+    } else {
+        appendText(buffer, "null");
+    }
+    appendText(buffer, ",\"history\":[");
+    for (size_t i = 0; i < run.history.size(); ++i) {
+        if (i > 0) buffer.push_back(',');
+        buffer.push_back('[');
+        appendHistoryPoint(buffer, run.history[i], ',');
+        buffer.push_back(']');
+    }
+    appendText(buffer, "]}\n");
+}
+
+bool RunExporter::flushBuffer(bool force) {
+    if (!force && buffer.size() < GameConstants::EXPORT_BUFFER_BYTES) return true;
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+    buffer.clear();
+    return ok;
+}
@@ -0,0 +1,256 @@
+#include "../include/RunJournal.h"
+#include "../include/Crc32.h"
+#include "../include/BinaryIO.h"
+#include "../include/MappedFile.h"
+#include "../include/ScoreTimeline.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char JOURNAL_MAGIC[4] = {'M', 'T', 'R', 'J'};
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr size_t HEADER_SIZE = 8;        // Magic, version
+    constexpr size_t FRAME_HEADER_SIZE = 8;  // BEGIN payload size or checkpoint count, CRC-32
+    constexpr size_t CHECKPOINT_SIZE = 28;   // Time, score, words per minute, accuracy, words, characters, mistakes
+    constexpr uint32_t MAX_BEGIN_PAYLOAD = 1u << 20;
+}
+
+RunJournal::RunJournal(const std::string& path) : path(path) {
+    writer = std::thread(&RunJournal::runWriter, this);
+}
+
+RunJournal::~RunJournal() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopRequested = true;
+    }
+    sleepCondition.notify_all();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+bool RunJournal::recover(RunRecord& out) {
+    std::error_code ec;
+    if (!fs::exists(path, ec)) return false;
+    MappedFile journal;
+    if (!journal.map(path)) return false;
+    const unsigned char* cursor = journal.data();
+    const unsigned char* end = journal.data() + journal.size();
+
+    uint32_t version, beginSize, checksum;
+    if (journal.size() < HEADER_SIZE || std::memcmp(cursor, JOURNAL_MAGIC, 4) != 0) {
+        fmt::print(stderr, "RunJournal: '{}' is not a run journal; ignoring it.\n", path);
+        return false;
+    }
+    cursor += 4;
+    get(cursor, end, version);
+    if (version != FORMAT_VERSION) {
+        fmt::print(stderr, "RunJournal: '{}' has unsupported version {}; ignoring it.\n", path, version);
+        return false;
+    }
+    if (!get(cursor, end, beginSize) || !get(cursor, end, checksum) || beginSize > MAX_BEGIN_PAYLOAD ||
+        beginSize > static_cast<size_t>(end - cursor) || crc32(cursor, beginSize) != checksum) {
+        return false; // Crashed while the journal was being created: nothing to recover
+    }
+
+    out = RunRecord{};
+    uint16_t wordSetLength;
+    const unsigned char* frameEnd = cursor + beginSize;
+    if (!get(cursor, frameEnd, out.startedAt) || !get(cursor, frameEnd, out.config.wordSpeedPercent) ||
+        !get(cursor, frameEnd, out.config.spawnRatePercent) || !get(cursor, frameEnd, out.config.flags) ||
+        !get(cursor, frameEnd, out.config.pseudoWordMode) || !get(cursor, frameEnd, wordSetLength) ||
+        static_cast<size_t>(frameEnd - cursor) < wordSetLength) {
+        return false;
+    }
+    out.config.wordSet.assign(reinterpret_cast<const char*>(cursor), wordSetLength);
+    cursor = frameEnd;
+
+    // Replaying the checkpoints through a timeline rebuilds the history the game would have archived.
+    ScoreTimeline timeline;
+    size_t checkpoints = 0;
+    uint32_t count;
+    while (get(cursor, end, count) && get(cursor, end, checksum)) {
+        if (count > static_cast<size_t>(end - cursor) / CHECKPOINT_SIZE ||
+            crc32(cursor, count * CHECKPOINT_SIZE) != checksum) {
+            break; // Torn by the crash
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            int32_t wordsTyped, charactersTyped, mistakesMade;
+            get(cursor, end, out.gameTime);
+            get(cursor, end, out.score);
+            get(cursor, end, out.stats.wordsPerMinute);
+            get(cursor, end, out.stats.accuracy);
+            get(cursor, end, wordsTyped);
+            get(cursor, end, charactersTyped);
+            get(cursor, end, mistakesMade);
+            out.stats.wordsTyped = wordsTyped;
+            out.stats.charactersTyped = charactersTyped;
+            out.stats.mistakesMade = mistakesMade;
+            timeline.record(out.gameTime, out.score);
+        }
+        checkpoints += count;
+    }
+    if (checkpoints == 0) return false;
+
+    timeline.copyPoints(out.history);
+    out.finishedAt = out.startedAt + static_cast<int64_t>(out.gameTime);
+    return true;
+}
+
+void RunJournal::discardRecovered() {
+    std::error_code ec;
+    fs::remove(path, ec);
+}
+
+uint64_t RunJournal::begin(const RunConfig& config, int64_t runStartedAt) {
+    {
+        std::lock_guard<std::mutex> lock(startMutex);
+        startedRun = ++currentRun;
+        startedAt = runStartedAt;
+        startedConfig = config;
+    }
+    runHasCheckpoint = false;
+    holding = false;
+    return currentRun;
+}
+
+void RunJournal::checkpoint(float gameTime, int score, const GameConstants::GameStats& stats) {
+    // Buckets are cut exactly as ScoreTimeline::record cuts them. Keeping the first and the last
+    // sample of each is enough for a replay to rebuild the same buckets.
+    Checkpoint sample{currentRun, gameTime, score, stats};
+    if (runHasCheckpoint && gameTime < bucketStartTime + GameConstants::SCORE_SAMPLE_INTERVAL) {
+        held = sample;
+        holding = true;
+        return;
+    }
+    if (holding) push(held);
+    push(sample);
+    runHasCheckpoint = true;
+    holding = false;
+    bucketStartTime = gameTime;
+}
+
+void RunJournal::push(const Checkpoint& checkpoint) {
+    if (!ring.push(checkpoint)) droppedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RunJournal::end(uint64_t runId) {
+    uint64_t ended = endedRun.load(std::memory_order_relaxed);
+    while (ended < runId && !endedRun.compare_exchange_weak(ended, runId, std::memory_order_release)) {
+    }
+}
+
+uint64_t RunJournal::getDroppedCount() const {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+void RunJournal::runWriter() {
+    pending.reserve(GameConstants::RUN_JOURNAL_RING_CAPACITY);
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(GameConstants::RUN_JOURNAL_FLUSH_MS),
+                                    [this] { return stopRequested; });
+            stopping = stopRequested;
+        }
+        pending.clear();
+        ring.drain([this](const Checkpoint& checkpoint) { pending.push_back(checkpoint); });
+        writePending();
+        if (fileRun != 0 && endedRun.load(std::memory_order_acquire) >= fileRun) {
+            closeJournal();
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+        if (stopping) break;
+    }
+    closeJournal(); // An unfinished run keeps its journal for recovery on the next start
+    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        fmt::print(stderr, "RunJournal: {} checkpoints were dropped because the writer fell behind.\n", dropped);
+    }
+}
+
+void RunJournal::writePending() {
+    size_t first = 0;
+    while (first < pending.size()) {
+        uint64_t run = pending[first].run;
+        size_t last = first;
+        while (last < pending.size() && pending[last].run == run) ++last;
+        if (run == fileRun || startJournal(run)) appendBlock(first, last);
+        first = last;
+    }
+}
+
+bool RunJournal::startJournal(uint64_t run) {
+    if (run == failedRun || run <= endedRun.load(std::memory_order_acquire)) return false;
+    block.clear();
+    {
+        std::lock_guard<std::mutex> lock(startMutex);
+        if (startedRun != run) return false; // Superseded by a newer run before its first flush
+        put(block, startedAt);
+        put(block, startedConfig.wordSpeedPercent);
+        put(block, startedConfig.spawnRatePercent);
+        put(block, startedConfig.flags);
+        put(block, startedConfig.pseudoWordMode);
+        auto wordSetLength = static_cast<uint16_t>(std::min<size_t>(startedConfig.wordSet.size(), UINT16_MAX));
+        put(block, wordSetLength);
+        block.insert(block.end(), startedConfig.wordSet.begin(), startedConfig.wordSet.begin() + wordSetLength);
+    }
+
+    // Truncating replaces the journal of the previous run, which has ended or been superseded.
+    closeJournal();
+    journalOut.open(path, std::ios::binary | std::ios::trunc);
+    auto beginSize = static_cast<uint32_t>(block.size());
+    uint32_t checksum = crc32(block.data(), block.size());
+    journalOut.write(JOURNAL_MAGIC, 4);
+    journalOut.write(reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+    journalOut.write(reinterpret_cast<const char*>(&beginSize), sizeof(beginSize));
+    journalOut.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    journalOut.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    journalOut.flush();
+    if (!journalOut) {
+        fmt::print(stderr, "RunJournal: Could not create '{}'; this run is not protected against crashes.\n", path);
+        closeJournal();
+        failedRun = run;
+        return false;
+    }
+    fileRun = run;
+    return true;
+}
+
+void RunJournal::appendBlock(size_t first, size_t last) {
+    block.assign(FRAME_HEADER_SIZE, 0);
+    for (size_t i = first; i < last; ++i) {
+        const Checkpoint& checkpoint = pending[i];
+        put(block, checkpoint.gameTime);
+        put(block, checkpoint.score);
+        put(block, checkpoint.stats.wordsPerMinute);
+        put(block, checkpoint.stats.accuracy);
+        put(block, static_cast<int32_t>(checkpoint.stats.wordsTyped));
+        put(block, static_cast<int32_t>(checkpoint.stats.charactersTyped));
+        put(block, static_cast<int32_t>(checkpoint.stats.mistakesMade));
+    }
+    auto count = static_cast<uint32_t>(last - first);
+    uint32_t checksum = crc32(block.data() + FRAME_HEADER_SIZE, block.size() - FRAME_HEADER_SIZE);
+    std::memcpy(block.data(), &count, 4);
+    std::memcpy(block.data() + 4, &checksum, 4);
+    journalOut.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+    journalOut.flush();
+    if (!journalOut) {
+        fmt::print(stderr, "RunJournal: Write to '{}' failed.\n", path);
+        journalOut.clear();
+    }
+}
+
+void RunJournal::closeJournal() {
+    if (journalOut.is_open()) journalOut.close();
+    journalOut.clear();
+    fileRun = 0;
+}
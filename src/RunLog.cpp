@@ -0,0 +1,478 @@
+#include "../include/RunLog.h"
+#include "../include/Crc32.h"
+#include "../include/BinaryIO.h"
+#include "../include/PersistenceWorker.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char LOG_MAGIC[4] = {'M', 'T', 'R', 'L'};
+    constexpr char INDEX_MAGIC[4] = {'M', 'T', 'R', 'I'};
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint32_t INDEX_VERSION = 2;        // 2: entries carry the run's configuration hash
+    constexpr uint64_t LOG_HEADER_SIZE = 8;      // Magic, version
+    constexpr uint64_t INDEX_HEADER_SIZE = 16;   // Magic, version, covered log bytes
+    constexpr uint64_t RECORD_HEADER_SIZE = 12;  // Type, payload size, CRC-32 of the payload
+    constexpr uint32_t RECORD_RAW_RUN = 1;    // History as raw 8-byte points, configuration after it
+    constexpr uint32_t RECORD_NAME = 2;
+    constexpr uint32_t RECORD_PACKED_RUN = 3; // Configuration, then the ScoreHistoryCodec blocks
+    constexpr uint32_t RECORD_MEASURED_RUN = 4; // Configuration, input latency, then the ScoreHistoryCodec blocks
+    constexpr uint32_t RECORD_TIMED_RUN = 5;    // Configuration, input latency, start time, then the ScoreHistoryCodec blocks
+    constexpr uint32_t MAX_RECORD_PAYLOAD = 16u << 20; // Anything larger is garbage, not a record
+
+    static_assert(sizeof(RunLog::IndexEntry) == 24, "Index entries are written as raw 24-byte structs");
+
+    // Fixed part of a RUN payload, ending with the number of history points. Both run record
+    // types share it.
+    constexpr size_t RUN_FIXED_SIZE = 8 + 4 + 4 + 4 + 4 + 4 + 4 + 4 + 4;
+    constexpr size_t RAW_POINT_SIZE = 8;
+
+    bool isRun(uint32_t type) {
+        return type == RECORD_RAW_RUN || type == RECORD_PACKED_RUN || type == RECORD_MEASURED_RUN ||
+               type == RECORD_TIMED_RUN;
+    }
+
+    // Reads a configuration and leaves 'cursor' after it. Raw runs logged before configurations
+    // existed end right after their history and get the default ("unrecorded") configuration.
+    bool readRunConfig(const unsigned char*& cursor, const unsigned char* end, RunConfig& config) {
+        config = RunConfig{};
+        uint16_t nameLength;
+        if (!get(cursor, end, config.wordSpeedPercent) || !get(cursor, end, config.spawnRatePercent) ||
+            !get(cursor, end, config.flags) || !get(cursor, end, config.pseudoWordMode) ||
+            !get(cursor, end, nameLength) || nameLength > end - cursor) {
+            config = RunConfig{};
+            return false;
+        }
+        config.wordSet.assign(reinterpret_cast<const char*>(cursor), nameLength);
+        cursor += nameLength;
+        return true;
+    }
+
+    // Runs logged before latency was measured read as zero samples.
+    bool readInputLatency(const unsigned char*& cursor, const unsigned char* end, InputLatencySummary& latency) {
+        latency = InputLatencySummary{};
+        if (!get(cursor, end, latency.samples) || !get(cursor, end, latency.p50Ms) ||
+            !get(cursor, end, latency.p95Ms) || !get(cursor, end, latency.p99Ms)) {
+            latency = InputLatencySummary{};
+            return false;
+        }
+        return true;
+    }
+
+    // Splits a RUN payload (at least RUN_FIXED_SIZE bytes) into its history, configuration, input
+    // latency and start time.
+    bool locateHistory(uint32_t type, const unsigned char* payload, uint32_t payloadSize,
+                       ScoreHistoryCodec::Decoder& decoder, RunConfig& config, InputLatencySummary& latency,
+                       int64_t& startedAt) {
+        const unsigned char* cursor = payload + RUN_FIXED_SIZE;
+        const unsigned char* end = payload + payloadSize;
+        uint32_t historyCount;
+        std::memcpy(&historyCount, cursor - 4, sizeof(historyCount));
+        latency = InputLatencySummary{};
+        startedAt = 0;
+        if (type != RECORD_RAW_RUN) {
+            if (!readRunConfig(cursor, end, config)) return false;
+            if (type != RECORD_PACKED_RUN && !readInputLatency(cursor, end, latency)) return false;
+            if (type == RECORD_TIMED_RUN && !get(cursor, end, startedAt)) return false;
+            decoder = ScoreHistoryCodec::Decoder::packed(cursor, static_cast<size_t>(end - cursor));
+            return true;
+        }
+        if (historyCount > static_cast<size_t>(end - cursor) / RAW_POINT_SIZE) return false;
+        decoder = ScoreHistoryCodec::Decoder::raw(cursor, historyCount);
+        cursor += static_cast<size_t>(historyCount) * RAW_POINT_SIZE;
+        readRunConfig(cursor, end, config);
+        return true;
+    }
+}
+
+uint32_t RunConfig::hash() const {
+    // FNV-1a over the fields in their serialized form.
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) { h ^= bytes[i]; h *= 16777619u; }
+    };
+    mix(&wordSpeedPercent, sizeof(wordSpeedPercent));
+    mix(&spawnRatePercent, sizeof(spawnRatePercent));
+    mix(&flags, sizeof(flags));
+    mix(&pseudoWordMode, sizeof(pseudoWordMode));
+    mix(wordSet.data(), wordSet.size());
+    return h;
+}
+
+std::string RunConfig::label() const {
+    if (wordSet.empty()) return "Unrecorded settings";
+    std::string text = (flags & PARAGRAPH_MODE) ? "Paragraph" : fmt::format("Speed {}% / Spawn {}%", wordSpeedPercent, spawnRatePercent);
+    if (!(flags & PARAGRAPH_MODE) && (flags & LINKED_WORDS)) text += " / Linked";
+    if (flags & FREE_TYPING) text += " / Free typing";
+    if (flags & WEAKNESS_TRAINING) text += " / Training";
+    if (pseudoWordMode != 0 && pseudoWordMode < GameConstants::PSEUDO_WORD_MODE_NAMES.size()) {
+        text += " / Pseudo " + GameConstants::PSEUDO_WORD_MODE_NAMES[pseudoWordMode];
+    }
+    return text + " / " + wordSet;
+}
+
+RunLog::RunLog(const std::string& logPath, const std::string& indexPath)
+        : logPath(logPath), indexPath(indexPath), logSize(0), coveredBytes(LOG_HEADER_SIZE), committedBytes(0), writable(false) {}
+
+bool RunLog::open() {
+    std::error_code ec;
+    if (!fs::exists(logPath, ec) || fs::file_size(logPath, ec) == 0) {
+        std::ofstream create(logPath, std::ios::binary | std::ios::trunc);
+        create.write(LOG_MAGIC, 4);
+        create.write(reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+        if (!create) {
+            fmt::print(stderr, "RunLog: Could not create '{}'.\n", logPath);
+            return false;
+        }
+    }
+
+    if (!logMap.map(logPath) || logMap.size() < LOG_HEADER_SIZE || std::memcmp(logMap.data(), LOG_MAGIC, 4) != 0) {
+        fmt::print(stderr, "RunLog: '{}' is not a run log; runs will not be saved.\n", logPath);
+        return false;
+    }
+    uint32_t version;
+    std::memcpy(&version, logMap.data() + 4, sizeof(version));
+    if (version != FORMAT_VERSION) {
+        fmt::print(stderr, "RunLog: '{}' has unsupported version {}.\n", logPath, version);
+        return false;
+    }
+    logSize = logMap.size();
+
+    bool indexValid = loadIndex();
+    size_t entriesBefore = entries.size();
+    uint64_t validEnd = scanLog(coveredBytes);
+    if (validEnd < logSize) {
+        fmt::print(stderr, "RunLog: Dropping {} bytes of incomplete data at the end of '{}'.\n", logSize - validEnd, logPath);
+        logMap.unmap();
+        fs::resize_file(logPath, validEnd, ec);
+        logSize = validEnd;
+        logMap.map(logPath);
+    }
+    // Rewriting the index only happens on repair; regular saves append to it.
+    if (!indexValid || entries.size() != entriesBefore || coveredBytes != logSize) {
+        coveredBytes = logSize;
+        writeIndexFile();
+    }
+
+    committedBytes = logSize;
+
+    logOut.open(logPath, std::ios::binary | std::ios::app);
+    indexFile.open(indexPath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!logOut.is_open() || !indexFile.is_open()) {
+        fmt::print(stderr, "RunLog: Could not open '{}' for appending.\n", logOut.is_open() ? indexPath : logPath);
+        return false;
+    }
+    writable = true;
+    fmt::print("RunLog: {} runs in '{}'.\n", entries.size(), logPath);
+    return true;
+}
+
+bool RunLog::openReadOnly() {
+    if (!logMap.map(logPath) || logMap.size() < LOG_HEADER_SIZE || std::memcmp(logMap.data(), LOG_MAGIC, 4) != 0) {
+        fmt::print(stderr, "RunLog: '{}' is not a run log.\n", logPath);
+        return false;
+    }
+    uint32_t version;
+    std::memcpy(&version, logMap.data() + 4, sizeof(version));
+    if (version != FORMAT_VERSION) {
+        fmt::print(stderr, "RunLog: '{}' has unsupported version {}.\n", logPath, version);
+        return false;
+    }
+    logSize = logMap.size();
+    loadIndex();
+    logSize = scanLog(coveredBytes); // A torn record at the end is ignored, not cut off
+    committedBytes = logSize;
+    return true;
+}
+
+bool RunLog::loadIndex() {
+    entries.clear();
+    coveredBytes = LOG_HEADER_SIZE;
+
+    MappedFile indexMap;
+    if (!indexMap.map(indexPath)) return false;
+    const unsigned char* cursor = indexMap.data();
+    const unsigned char* end = cursor + indexMap.size();
+    char magic[4];
+    uint32_t version;
+    uint64_t covered;
+    if (indexMap.size() < INDEX_HEADER_SIZE || (indexMap.size() - INDEX_HEADER_SIZE) % sizeof(IndexEntry) != 0) return false;
+    get(cursor, end, magic);
+    get(cursor, end, version);
+    get(cursor, end, covered);
+    if (std::memcmp(magic, INDEX_MAGIC, 4) != 0 || version != INDEX_VERSION || covered > logSize || covered < LOG_HEADER_SIZE) {
+        return false;
+    }
+
+    entries.resize((indexMap.size() - INDEX_HEADER_SIZE) / sizeof(IndexEntry));
+    if (!entries.empty()) std::memcpy(entries.data(), cursor, entries.size() * sizeof(IndexEntry));
+    // Entries past the covered prefix were appended by a save that did not finish; the scan re-adds them.
+    while (!entries.empty() && entries.back().runOffset >= covered) entries.pop_back();
+    for (IndexEntry& entry : entries) {
+        if (entry.nameOffset >= covered) entry.nameOffset = 0;
+    }
+    coveredBytes = covered;
+    return true;
+}
+
+uint64_t RunLog::scanLog(uint64_t from) {
+    const unsigned char* base = logMap.data();
+    uint64_t offset = from;
+    while (logSize - offset >= RECORD_HEADER_SIZE) {
+        uint32_t type, payloadSize, checksum;
+        std::memcpy(&type, base + offset, 4);
+        std::memcpy(&payloadSize, base + offset + 4, 4);
+        std::memcpy(&checksum, base + offset + 8, 4);
+        if (payloadSize > MAX_RECORD_PAYLOAD || logSize - offset - RECORD_HEADER_SIZE < payloadSize) break;
+        const unsigned char* payload = base + offset + RECORD_HEADER_SIZE;
+        if (crc32(payload, payloadSize) != checksum) break;
+
+        const unsigned char* cursor = payload;
+        const unsigned char* end = payload + payloadSize;
+        if (isRun(type) && payloadSize >= RUN_FIXED_SIZE) {
+            int32_t score;
+            std::memcpy(&score, payload + 8, sizeof(score));
+            RunConfig config;
+            InputLatencySummary latency;
+            int64_t startedAt;
+            ScoreHistoryCodec::Decoder history;
+            locateHistory(type, payload, payloadSize, history, config, latency, startedAt);
+            entries.push_back(IndexEntry{offset, 0, score, config.hash()});
+        } else if (type == RECORD_NAME) {
+            uint64_t runId;
+            if (get(cursor, end, runId)) {
+                if (IndexEntry* entry = findEntry(runId)) entry->nameOffset = offset;
+            }
+        }
+        // Unknown record types are skipped, so newer logs stay readable.
+        offset += RECORD_HEADER_SIZE + payloadSize;
+    }
+    return offset;
+}
+
+bool RunLog::writeIndexFile() {
+    std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+    out.write(INDEX_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(&INDEX_VERSION), sizeof(INDEX_VERSION));
+    out.write(reinterpret_cast<const char*>(&coveredBytes), sizeof(coveredBytes));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+    if (!out) {
+        fmt::print(stderr, "RunLog: Could not write index '{}'.\n", indexPath);
+        return false;
+    }
+    return true;
+}
+
+uint64_t RunLog::stageRecord(uint32_t type, const std::vector<unsigned char>& payload) {
+    uint32_t payloadSize = static_cast<uint32_t>(payload.size());
+    uint32_t checksum = crc32(payload.data(), payload.size());
+    put(stagedLog, type);
+    put(stagedLog, payloadSize);
+    put(stagedLog, checksum);
+    stagedLog.insert(stagedLog.end(), payload.begin(), payload.end());
+    uint64_t offset = logSize;
+    logSize += RECORD_HEADER_SIZE + payloadSize;
+    return offset;
+}
+
+bool RunLog::commit() {
+    std::vector<std::pair<size_t, IndexEntry>> slots;
+    uint64_t committedSize;
+    {
+        std::lock_guard<std::mutex> lock(stageMutex);
+        if (stagedLog.empty()) return true;
+        commitBuffer.swap(stagedLog);
+        stagedLog.clear();
+        for (size_t slot : stagedIndexSlots) slots.emplace_back(slot, entries[slot]);
+        stagedIndexSlots.clear();
+        committedSize = logSize;
+    }
+
+    logOut.write(reinterpret_cast<const char*>(commitBuffer.data()), static_cast<std::streamsize>(commitBuffer.size()));
+    logOut.flush();
+    // Synced before the caller ends the run's journal, so a crash cannot lose both copies.
+    if (!logOut || !PersistenceWorker::syncFile(logPath)) {
+        // Ids already handed out assume these bytes landed; stop logging rather than misnumber later runs.
+        fmt::print(stderr, "RunLog: Write to '{}' failed; further runs will not be saved.\n", logPath);
+        writable = false;
+        return false;
+    }
+    // Readers on other threads may map the log from here on; before this the mapping could end
+    // partway into the records just written.
+    committedBytes = committedSize;
+    for (const auto& [slot, entry] : slots) {
+        indexFile.seekp(static_cast<std::streamoff>(INDEX_HEADER_SIZE + slot * sizeof(IndexEntry)));
+        indexFile.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    writeCoveredBytes(committedSize);
+    return true;
+}
+
+void RunLog::writeCoveredBytes(uint64_t covered) {
+    // Written last, so a crash in between leaves the index describing a shorter, consistent prefix.
+    coveredBytes = covered;
+    indexFile.seekp(8);
+    indexFile.write(reinterpret_cast<const char*>(&coveredBytes), sizeof(coveredBytes));
+    indexFile.flush();
+}
+
+uint64_t RunLog::appendRun(const RunRecord& run) {
+    if (!writable) return 0;
+    scratch.clear();
+    put(scratch, run.finishedAt);
+    put(scratch, run.score);
+    put(scratch, run.gameTime);
+    put(scratch, run.stats.wordsPerMinute);
+    put(scratch, run.stats.accuracy);
+    put(scratch, static_cast<int32_t>(run.stats.wordsTyped));
+    put(scratch, static_cast<int32_t>(run.stats.charactersTyped));
+    put(scratch, static_cast<int32_t>(run.stats.mistakesMade));
+    put(scratch, static_cast<uint32_t>(run.history.size()));
+    put(scratch, run.config.wordSpeedPercent);
+    put(scratch, run.config.spawnRatePercent);
+    put(scratch, run.config.flags);
+    put(scratch, run.config.pseudoWordMode);
+    auto wordSetLength = static_cast<uint16_t>(std::min<size_t>(run.config.wordSet.size(), UINT16_MAX));
+    put(scratch, wordSetLength);
+    scratch.insert(scratch.end(), run.config.wordSet.begin(), run.config.wordSet.begin() + wordSetLength);
+    put(scratch, run.inputLatency.samples);
+    put(scratch, run.inputLatency.p50Ms);
+    put(scratch, run.inputLatency.p95Ms);
+    put(scratch, run.inputLatency.p99Ms);
+    put(scratch, run.startedAt);
+    ScoreHistoryCodec::encode(run.history, scratch);
+
+    std::lock_guard<std::mutex> lock(stageMutex);
+    uint64_t offset = stageRecord(RECORD_TIMED_RUN, scratch);
+    entries.push_back(IndexEntry{offset, 0, run.score, run.config.hash()});
+    stagedIndexSlots.push_back(entries.size() - 1);
+    return offset;
+}
+
+bool RunLog::nameRun(uint64_t runId, const std::string& name) {
+    if (!writable) return false;
+    std::lock_guard<std::mutex> lock(stageMutex);
+    IndexEntry* entry = findEntry(runId);
+    if (!entry) return false;
+
+    scratch.clear();
+    put(scratch, runId);
+    put(scratch, static_cast<uint16_t>(std::min<size_t>(name.size(), UINT16_MAX)));
+    scratch.insert(scratch.end(), name.begin(), name.begin() + std::min<size_t>(name.size(), UINT16_MAX));
+    entry->nameOffset = stageRecord(RECORD_NAME, scratch);
+    stagedIndexSlots.push_back(static_cast<size_t>(entry - entries.data()));
+    return true;
+}
+
+const std::vector<RunLog::IndexEntry>& RunLog::getEntries() const {
+    return entries;
+}
+
+RunLog::IndexEntry* RunLog::findEntry(uint64_t runId) {
+    auto it = std::lower_bound(entries.begin(), entries.end(), runId,
+                               [](const IndexEntry& entry, uint64_t id) { return entry.runOffset < id; });
+    return (it != entries.end() && it->runOffset == runId) ? &*it : nullptr;
+}
+
+const unsigned char* RunLog::recordPayload(uint64_t offset, uint32_t& type, uint32_t& payloadSize, bool verify) {
+    // Records still being written by commit() are not readable yet.
+    uint64_t committed = committedBytes;
+    if (offset + RECORD_HEADER_SIZE > committed) return nullptr;
+    if (offset + RECORD_HEADER_SIZE > logMap.size() && !logMap.map(logPath)) return nullptr;
+    if (offset + RECORD_HEADER_SIZE > logMap.size()) return nullptr;
+
+    uint32_t checksum;
+    std::memcpy(&type, logMap.data() + offset, 4);
+    std::memcpy(&payloadSize, logMap.data() + offset + 4, 4);
+    std::memcpy(&checksum, logMap.data() + offset + 8, 4);
+    uint64_t recordEnd = offset + RECORD_HEADER_SIZE + payloadSize;
+    if (recordEnd > committed) return nullptr;
+    // Committed after the last mapping, possibly while it was being taken; remap to see all of it.
+    if (recordEnd > logMap.size() && !logMap.map(logPath)) return nullptr;
+    if (recordEnd > logMap.size()) return nullptr;
+
+    const unsigned char* base = logMap.data() + offset;
+    if (verify && crc32(base + RECORD_HEADER_SIZE, payloadSize) != checksum) return nullptr;
+    return base + RECORD_HEADER_SIZE;
+}
+
+bool RunLog::readRun(uint64_t runId, RunRecord& out) {
+    uint32_t type, payloadSize;
+    const unsigned char* payload = recordPayload(runId, type, payloadSize);
+    if (!payload || !isRun(type)) return false;
+    const unsigned char* cursor = payload;
+    const unsigned char* end = payload + payloadSize;
+
+    int32_t wordsTyped, charactersTyped, mistakesMade;
+    uint32_t historyCount;
+    bool ok = get(cursor, end, out.finishedAt) && get(cursor, end, out.score) && get(cursor, end, out.gameTime) &&
+              get(cursor, end, out.stats.wordsPerMinute) && get(cursor, end, out.stats.accuracy) &&
+              get(cursor, end, wordsTyped) && get(cursor, end, charactersTyped) && get(cursor, end, mistakesMade) &&
+              get(cursor, end, historyCount);
+    ScoreHistoryCodec::Decoder history;
+    if (!ok || !locateHistory(type, payload, payloadSize, history, out.config, out.inputLatency, out.startedAt)) return false;
+    out.stats.wordsTyped = wordsTyped;
+    out.stats.charactersTyped = charactersTyped;
+    out.stats.mistakesMade = mistakesMade;
+
+    // The count only sizes the buffer; a damaged count cannot make it exceed the record.
+    out.history.clear();
+    out.history.reserve(std::min<size_t>(historyCount, payloadSize));
+    ScorePoint point;
+    while (history.next(point)) out.history.push_back(point);
+    return !history.failed();
+}
+
+bool RunLog::openHistory(uint64_t runId, ScoreHistoryCodec::Decoder& decoder) {
+    uint32_t type, payloadSize;
+    const unsigned char* payload = recordPayload(runId, type, payloadSize, false);
+    // Raw histories have no block checksums of their own.
+    if (payload && type == RECORD_RAW_RUN) payload = recordPayload(runId, type, payloadSize);
+    if (!payload || !isRun(type) || payloadSize < RUN_FIXED_SIZE) return false;
+    RunConfig config;
+    InputLatencySummary latency;
+    int64_t startedAt;
+    return locateHistory(type, payload, payloadSize, decoder, config, latency, startedAt);
+}
+
+bool RunLog::containsRun(int64_t startedAt, const RunConfig& config) {
+    uint32_t configHash = config.hash();
+    uint64_t committed = committedBytes;
+    RunConfig runConfig;
+    InputLatencySummary latency;
+    int64_t runStartedAt;
+    ScoreHistoryCodec::Decoder history;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->runOffset >= committed) continue;
+        uint32_t type, payloadSize;
+        const unsigned char* payload = recordPayload(it->runOffset, type, payloadSize);
+        if (!payload || !isRun(type) || payloadSize < RUN_FIXED_SIZE) continue;
+        int64_t finishedAt;
+        std::memcpy(&finishedAt, payload, sizeof(finishedAt));
+        if (finishedAt < startedAt) break; // Runs are logged in the order they finished
+        if (it->configHash == configHash &&
+            locateHistory(type, payload, payloadSize, history, runConfig, latency, runStartedAt) &&
+            runStartedAt == startedAt) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RunLog::readName(uint64_t nameOffset, std::string& out) {
+    uint32_t type, payloadSize;
+    const unsigned char* cursor = recordPayload(nameOffset, type, payloadSize);
+    if (!cursor || type != RECORD_NAME) return false;
+    const unsigned char* end = cursor + payloadSize;
+    uint64_t runId;
+    uint16_t length;
+    if (!get(cursor, end, runId) || !get(cursor, end, length) || length > end - cursor) return false;
+    out.assign(reinterpret_cast<const char*>(cursor), length);
+    return true;
+}
@@ -0,0 +1,112 @@
+#include "../include/ScoreHistoryCodec.h"
+#include "../include/Crc32.h"
+#include "../include/Varint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr size_t BLOCK_POINTS = 256;
+    constexpr size_t BLOCK_HEADER_SIZE = 2 + 4 + 4; // Point count, encoded size, CRC-32
+    constexpr size_t RAW_POINT_SIZE = 8;
+
+    template <typename T>
+    void putRaw(unsigned char* at, T value) {
+        std::memcpy(at, &value, sizeof(T));
+    }
+}
+
+namespace ScoreHistoryCodec {
+    void encode(const std::vector<ScorePoint>& points, std::vector<unsigned char>& out) {
+        for (size_t first = 0; first < points.size(); first += BLOCK_POINTS) {
+            size_t count = std::min(BLOCK_POINTS, points.size() - first);
+            size_t headerAt = out.size();
+            out.resize(out.size() + BLOCK_HEADER_SIZE);
+            size_t bodyAt = out.size();
+
+            int64_t previousTime = 0, previousDelta = 0, previousScore = 0;
+            for (size_t i = first; i < first + count; ++i) {
+                auto time = static_cast<int64_t>(std::llround(static_cast<double>(points[i].timeStamp) * 1000.0));
+                int64_t delta = time - previousTime;
+                putVarint(out, zigzag(delta - previousDelta));
+                putVarint(out, zigzag(static_cast<int64_t>(points[i].score) - previousScore));
+                previousTime = time;
+                previousDelta = delta;
+                previousScore = points[i].score;
+            }
+
+            auto bodySize = static_cast<uint32_t>(out.size() - bodyAt);
+            putRaw(out.data() + headerAt, static_cast<uint16_t>(count));
+            putRaw(out.data() + headerAt + 2, bodySize);
+            putRaw(out.data() + headerAt + 6, crc32(out.data() + bodyAt, bodySize));
+        }
+    }
+
+    Decoder Decoder::packed(const unsigned char* data, size_t size) {
+        Decoder decoder;
+        decoder.cursor = data;
+        decoder.end = data + size;
+        decoder.blockEnd = data;
+        return decoder;
+    }
+
+    Decoder Decoder::raw(const unsigned char* data, uint32_t pointCount) {
+        Decoder decoder;
+        decoder.cursor = data;
+        decoder.end = data + static_cast<size_t>(pointCount) * RAW_POINT_SIZE;
+        decoder.remainingRaw = pointCount;
+        decoder.isRaw = true;
+        return decoder;
+    }
+
+    bool Decoder::startBlock() {
+        uint16_t count;
+        uint32_t size, checksum;
+        if (static_cast<size_t>(end - cursor) < BLOCK_HEADER_SIZE) return false;
+        std::memcpy(&count, cursor, 2);
+        std::memcpy(&size, cursor + 2, 4);
+        std::memcpy(&checksum, cursor + 6, 4);
+        cursor += BLOCK_HEADER_SIZE;
+        if (count == 0 || size > static_cast<size_t>(end - cursor) || crc32(cursor, size) != checksum) return false;
+        blockEnd = cursor + size;
+        remainingBlock = count;
+        timeMillis = timeDelta = score = 0;
+        return true;
+    }
+
+    bool Decoder::next(ScorePoint& point) {
+        if (damaged) return false;
+        if (isRaw) {
+            if (remainingRaw == 0) return false;
+            int32_t rawScore;
+            std::memcpy(&point.timeStamp, cursor, 4);
+            std::memcpy(&rawScore, cursor + 4, 4);
+            point.score = rawScore;
+            cursor += RAW_POINT_SIZE;
+            --remainingRaw;
+            return true;
+        }
+
+        if (remainingBlock == 0) {
+            // Leftover bytes in a finished block mean its count and contents disagree.
+            if (cursor != blockEnd) damaged = true;
+            if (damaged || cursor == end) return false;
+            if (!startBlock()) {
+                damaged = true;
+                return false;
+            }
+        }
+        uint64_t timeBits, scoreBits;
+        if (!getVarint(cursor, blockEnd, timeBits) || !getVarint(cursor, blockEnd, scoreBits)) {
+            damaged = true;
+            return false;
+        }
+        timeDelta += unzigzag(timeBits);
+        timeMillis += timeDelta;
+        score += unzigzag(scoreBits);
+        point.timeStamp = static_cast<float>(static_cast<double>(timeMillis) / 1000.0);
+        point.score = static_cast<int>(score);
+        --remainingBlock;
+        return true;
+    }
+}
@@ -0,0 +1,86 @@
+#include "../include/ScoreTimeline.h"
+#include <algorithm>
+
+static_assert(GameConstants::SCORE_TIMELINE_LEVEL_CAPACITY % GameConstants::SCORE_TIMELINE_FACTOR == 0 &&
+              GameConstants::SCORE_TIMELINE_LEVEL_CAPACITY % 2 == 0, "Levels must fold and halve evenly");
+
+ScoreTimeline::ScoreTimeline() {
+    for (Level& level : levels) {
+        level.buckets.resize(GameConstants::SCORE_TIMELINE_LEVEL_CAPACITY);
+    }
+}
+
+void ScoreTimeline::clear() {
+    for (Level& level : levels) {
+        level.head = 0;
+        level.count = 0;
+    }
+    hasCurrent = false;
+}
+
+void ScoreTimeline::record(float time, int score) {
+    if (hasCurrent && time < current.startTime + GameConstants::SCORE_SAMPLE_INTERVAL) {
+        merge(current, ScoreBucket{time, time, score, score, score, 1, static_cast<double>(score)});
+        return;
+    }
+    if (hasCurrent) push(0, current);
+    current = ScoreBucket{time, time, score, score, score, 1, static_cast<double>(score)};
+    hasCurrent = true;
+}
+
+bool ScoreTimeline::empty() const {
+    return !hasCurrent;
+}
+
+size_t ScoreTimeline::getBucketCount() const {
+    size_t total = hasCurrent ? 1 : 0;
+    for (const Level& level : levels) total += level.count;
+    return total;
+}
+
+void ScoreTimeline::merge(ScoreBucket& into, const ScoreBucket& next) {
+    into.endTime = next.endTime;
+    into.minScore = std::min(into.minScore, next.minScore);
+    into.maxScore = std::max(into.maxScore, next.maxScore);
+    into.lastScore = next.lastScore;
+    into.count += next.count;
+    into.scoreSum += next.scoreSum;
+}
+
+void ScoreTimeline::push(size_t levelIndex, const ScoreBucket& bucket) {
+    Level& level = levels[levelIndex];
+    size_t capacity = level.buckets.size();
+    if (level.count == capacity) {
+        if (levelIndex + 1 < levels.size()) {
+            // Fold the oldest buckets into one bucket of the next level.
+            ScoreBucket folded = level.buckets[level.head];
+            for (size_t i = 1; i < GameConstants::SCORE_TIMELINE_FACTOR; ++i) {
+                merge(folded, level.buckets[(level.head + i) % capacity]);
+            }
+            level.head = (level.head + GameConstants::SCORE_TIMELINE_FACTOR) % capacity;
+            level.count -= GameConstants::SCORE_TIMELINE_FACTOR;
+            push(levelIndex + 1, folded);
+        } else {
+            // Coarsest level: halve the resolution in place.
+            std::rotate(level.buckets.begin(), level.buckets.begin() + static_cast<std::ptrdiff_t>(level.head), level.buckets.end());
+            level.head = 0;
+            for (size_t i = 0; i < capacity / 2; ++i) {
+                level.buckets[i] = level.buckets[2 * i];
+                merge(level.buckets[i], level.buckets[2 * i + 1]);
+            }
+            level.count = capacity / 2;
+        }
+    }
+    level.buckets[(level.head + level.count) % capacity] = bucket;
+    ++level.count;
+}
+
+void ScoreTimeline::copyBuckets(std::vector<ScoreBucket>& out) const {
+    out.clear();
+    forEachBucket([&out](const ScoreBucket& bucket) { out.push_back(bucket); });
+}
+
+void ScoreTimeline::copyPoints(std::vector<ScorePoint>& out) const {
+    out.clear();
+    forEachBucket([&out](const ScoreBucket& bucket) { out.push_back(ScorePoint{bucket.endTime, bucket.lastScore}); });
+}
@@ -1,167 +1,294 @@
 #include "../include/SettingsManager.h"
 #include "../include/FontManager.h"
+#include "../include/PersistenceWorker.h"
 #include <fstream>
 #include <fmt/core.h>
-#include <sstream>
+#include <array>
+#include <chrono>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+#include <type_traits>
 
-SettingsManager::SettingsManager()
-        : wordSpeedMultiplier(1.0f),
-          spawnRateMultiplier(1.0f),
-          highlightTyping(true),
-          currentFontSize(GameConstants::DEFAULT_FONT_SIZE),
-          currentInputStyle(GameConstants::InputDisplayStyle::UNDER_CURSOR),
-          useLinkedWordsEnabled(true),
-          randomizeFontsEnabled(false),
-          explicitlySelectedFontName("PixelTCG.ttf"), // Default
-          randomizeWordSetsEnabled(false) {}
+namespace {
+    // Version 1 was one value per line in a fixed order, without keys; version 2 is key=value.
+    constexpr int SETTINGS_VERSION = 2;
 
-void SettingsManager::loadSettings(const std::string& filePath, FontManager& fontManager, std::shared_ptr<sf::Font>& currentFontRef) {
-    std::ifstream file(filePath);
-    if (file.is_open()) {
-        std::string line;
-
-        // Helper for robust reading
-        auto readLineAndParse = [&](auto& var, const std::string& varName) {
-            if (std::getline(file, line)) {
-                std::stringstream ss(line);
-                if (!(ss >> var)) {
-                    fmt::print(stderr, "Warning: Failed to parse '{}' from settings, using default.\n", varName);
-                }
-            } else {
-                fmt::print(stderr, "Warning: Missing line for '{}' in settings, using default.\n", varName);
-            }
-        };
-
-        auto readBool = [&](bool& var, const std::string& varName){
-            int tempInt;
-            if (std::getline(file, line)) {
-                std::stringstream ss(line);
-                if (!(ss >> tempInt) || (tempInt !=0 && tempInt !=1) ) {
-                    fmt::print(stderr, "Warning: Failed to parse bool '{}' from settings, using default.\n", varName);
-                } else {
-                    var = (tempInt == 1);
-                }
-            } else {
-                fmt::print(stderr, "Warning: Missing line for bool '{}' in settings, using default.\n", varName);
-            }
-        };
+    std::string_view trim(std::string_view text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) return {};
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Value syntax, shared by both versions.
+    bool parseValue(std::string_view text, float& out) {
+        std::string buffer(text);
+        char* end = nullptr;
+        float value = std::strtof(buffer.c_str(), &end);
+        if (buffer.empty() || *end != '\0') return false;
+        out = value;
+        return true;
+    }
 
+    bool parseValue(std::string_view text, bool& out) {
+        if (text == "1" || text == "true") out = true;
+        else if (text == "0" || text == "false") out = false;
+        else return false;
+        return true;
+    }
 
-        readLineAndParse(wordSpeedMultiplier, "wordSpeedMultiplier");
-        readLineAndParse(spawnRateMultiplier, "spawnRateMultiplier");
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, bool> parseValue(std::string_view text, T& out) {
+        T value;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) return false;
+        out = value;
+        return true;
+    }
 
-        readBool(highlightTyping, "highlightTyping");
-        readLineAndParse(currentFontSize, "currentFontSize");
+    template <typename Enum, size_t Count>
+    bool parseEnum(std::string_view text, Enum& out, const std::array<std::string, Count>&) {
+        int value;
+        if (!parseValue(text, value) || value < 0 || value >= static_cast<int>(Count)) return false;
+        out = static_cast<Enum>(value);
+        return true;
+    }
 
-        int inputStyleInt = static_cast<int>(GameConstants::InputDisplayStyle::UNDER_CURSOR); // Default
-        readLineAndParse(inputStyleInt, "inputStyleInt");
-        if (inputStyleInt >=0 && inputStyleInt < GameConstants::INPUT_DISPLAY_NAMES.size()) {
-            currentInputStyle = static_cast<GameConstants::InputDisplayStyle>(inputStyleInt);
-        } else {
-            fmt::print(stderr, "Warning: Invalid input style from settings, using default.\n");
-        }
+    bool parseValue(std::string_view text, GameConstants::InputDisplayStyle& out) {
+        return parseEnum(text, out, GameConstants::INPUT_DISPLAY_NAMES);
+    }
 
+    bool parseValue(std::string_view text, GameConstants::PseudoWordMode& out) {
+        return parseEnum(text, out, GameConstants::PSEUDO_WORD_MODE_NAMES);
+    }
 
-        std::string fontNameFromFile;
-        if (std::getline(file, fontNameFromFile) && !fontNameFromFile.empty()) {
-            currentFontRef = fontManager.getFont(fontNameFromFile);
-            if (!currentFontRef) {
-                fmt::print(stderr, "Warning: Font '{}' not found from settings, using default font.\n", fontNameFromFile);
-                currentFontRef = fontManager.getDefaultFont();
-            }
-        } else {
-            fmt::print(stderr, "Warning: Failed to read font name from settings or name is empty, using default.\n");
-            currentFontRef = fontManager.getDefaultFont();
+    bool parseValue(std::string_view text, std::string& out) {
+        if (text.empty()) return false;
+        out.assign(text);
+        return true;
+    }
+
+    // Sets are space-separated and may be empty.
+    template <typename T>
+    bool parseValue(std::string_view text, std::set<T>& out) {
+        std::set<T> values;
+        while (!(text = trim(text)).empty()) {
+            size_t space = text.find(' ');
+            T value;
+            if (!parseValue(text.substr(0, space), value)) return false;
+            values.insert(std::move(value));
+            text = space == std::string_view::npos ? std::string_view{} : text.substr(space);
         }
+        out.swap(values);
+        return true;
+    }
 
-        readBool(randomizeFontsEnabled, "randomizeFontsEnabled");
+    void writeValue(std::string& out, float value) { out += fmt::format("{}", value); }
+    void writeValue(std::string& out, bool value) { out += value ? '1' : '0'; }
+    void writeValue(std::string& out, const std::string& value) { out += value; }
 
-        if (std::getline(file, line)) {
-            if (!line.empty()) {
-                explicitlySelectedFontName = line;
-            } else {
-                fmt::print("Warning: explicitlySelectedFontName line empty in settings, using default '{}'.\n", explicitlySelectedFontName);
-            }
-        } else {
-            fmt::print("Warning: Missing line for explicitlySelectedFontName in settings, using default '{}'.\n", explicitlySelectedFontName);
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>> writeValue(std::string& out, T value) {
+        if constexpr (std::is_enum_v<T>) out += std::to_string(static_cast<int>(value));
+        else out += std::to_string(value);
+    }
+
+    template <typename T>
+    void writeValue(std::string& out, const std::set<T>& values) {
+        for (const T& value : values) {
+            if (&value != &*values.begin()) out += ' ';
+            writeValue(out, value);
         }
+    }
 
+    // The field table: one row per persisted member drives loading, saving and migration.
+    struct SettingField {
+        std::string_view key;
+        bool (*parse)(SettingsManager&, std::string_view);
+        void (*write)(const SettingsManager&, std::string&);
+    };
 
-        readBool(randomizeWordSetsEnabled, "randomizeWordSetsEnabled");
+    template <auto Member>
+    bool parseField(SettingsManager& settings, std::string_view text) { return parseValue(text, settings.*Member); }
 
-        randomizedFontNames.clear();
-        if (std::getline(file, line)) {
-            std::stringstream ssFonts(line);
-            std::string name;
-            while (ssFonts >> name) {
-                randomizedFontNames.insert(name);
-            }
-        }  else {
-            fmt::print("Warning: Missing line for randomized font names in settings.\n");
-        }
+    template <auto Member>
+    void writeField(const SettingsManager& settings, std::string& out) { writeValue(out, settings.*Member); }
 
-        // Load randomized word sets (indices)
-        randomizedWordSetIndices.clear();
-        if (std::getline(file, line)) {
-            std::stringstream ssSets(line);
-            size_t index;
-            while (ssSets >> index) {
-                randomizedWordSetIndices.insert(index);
-            }
-        } else {
-            fmt::print("Warning: Missing line for randomized word set indices in settings.\n");
+    template <auto Member>
+    constexpr SettingField field(std::string_view key) { return SettingField{key, &parseField<Member>, &writeField<Member>}; }
+
+    constexpr std::string_view ACTIVE_FONT_KEY = "activeFont"; // Font in use when saved; resolved against loaded fonts
+    constexpr std::string_view VERSION_KEY = "version";
+
+    constexpr std::array<SettingField, 16> SETTING_FIELDS = {{
+            field<&SettingsManager::wordSpeedMultiplier>("wordSpeed"),
+            field<&SettingsManager::spawnRateMultiplier>("spawnRate"),
+            field<&SettingsManager::highlightTyping>("highlightTyping"),
+            field<&SettingsManager::currentFontSize>("fontSize"),
+            field<&SettingsManager::currentInputStyle>("inputStyle"),
+            field<&SettingsManager::randomizeFontsEnabled>("randomizeFonts"),
+            field<&SettingsManager::explicitlySelectedFontName>("font"),
+            field<&SettingsManager::randomizeWordSetsEnabled>("randomizeWordSets"),
+            field<&SettingsManager::randomizedFontNames>("randomizedFonts"),
+            field<&SettingsManager::randomizedWordSetIndices>("randomizedWordSets"),
+            field<&SettingsManager::weaknessTrainingEnabled>("weaknessTraining"),
+            field<&SettingsManager::pseudoWordMode>("pseudoWordMode"),
+            field<&SettingsManager::paragraphModeEnabled>("paragraphMode"),
+            field<&SettingsManager::freeTypingEnabled>("freeTyping"),
+            field<&SettingsManager::leaderboardCapacity>("leaderboardCapacity"),
+            field<&SettingsManager::useLinkedWordsEnabled>("linkedWords"),
+    }};
+
+    // Keys of the version 1 lines, in file order. Migration reads them as key=value pairs.
+    constexpr std::array<std::string_view, 16> VERSION_1_LINES = {
+            "wordSpeed", "spawnRate", "highlightTyping", "fontSize", "inputStyle", ACTIVE_FONT_KEY,
+            "randomizeFonts", "font", "randomizeWordSets", "randomizedFonts", "randomizedWordSets",
+            "weaknessTraining", "pseudoWordMode", "paragraphMode", "freeTyping", "leaderboardCapacity"
+    };
+
+    const SettingField* findField(std::string_view key) {
+        for (const SettingField& candidate : SETTING_FIELDS) {
+            if (candidate.key == key) return &candidate;
         }
+        return nullptr;
+    }
+}
 
-        file.close();
+SettingsManager::SettingsManager()
+        : wordSpeedMultiplier(1.0f),
+          spawnRateMultiplier(1.0f),
+          highlightTyping(true),
+          currentFontSize(GameConstants::DEFAULT_FONT_SIZE),
+          currentInputStyle(GameConstants::InputDisplayStyle::UNDER_CURSOR),
+          useLinkedWordsEnabled(true),
+          randomizeFontsEnabled(false),
+          explicitlySelectedFontName("PixelTCG.ttf"), // Default
+          randomizeWordSetsEnabled(false),
+          weaknessTrainingEnabled(false),
+          pseudoWordMode(GameConstants::PseudoWordMode::OFF),
+          paragraphModeEnabled(false),
+          freeTypingEnabled(false),
+          leaderboardCapacity(GameConstants::DEFAULT_LEADERBOARD_CAPACITY) {}
 
-        // After loading all, if randomizeFontsEnabled is OFF, ensure currentFontRef matches explicitlySelectedFontName
-        if (!randomizeFontsEnabled) {
-            currentFontRef = fontManager.getFont(explicitlySelectedFontName);
-            if(!currentFontRef) currentFontRef = fontManager.getDefaultFont();
+void SettingsManager::loadSettings(const std::string& filePath, FontManager& fontManager, std::shared_ptr<sf::Font>& currentFontRef) {
+    auto loadStart = std::chrono::steady_clock::now();
+    std::string contents;
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            fmt::print("Settings file '{}' not found. Using default settings.\n", filePath);
+            currentFontRef = fontManager.getDefaultFont();
+            return;
         }
+        file.seekg(0, std::ios::end);
+        contents.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
 
+    std::string activeFontName;
+    int version = parseSettings(contents, activeFontName);
 
-    } else {
-        fmt::print("Settings file '{}' not found. Using default settings.\n", filePath);
+    currentFontRef = activeFontName.empty() ? nullptr : fontManager.getFont(activeFontName);
+    if (!currentFontRef) {
+        if (!activeFontName.empty()) {
+            fmt::print(stderr, "Warning: Font '{}' not found from settings, using default font.\n", activeFontName);
+        }
         currentFontRef = fontManager.getDefaultFont();
     }
+    // If randomizeFontsEnabled is OFF, ensure currentFontRef matches explicitlySelectedFontName
+    if (!randomizeFontsEnabled) {
+        currentFontRef = fontManager.getFont(explicitlySelectedFontName);
+        if(!currentFontRef) currentFontRef = fontManager.getDefaultFont();
+    }
+
+    auto loadMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count();
+    fmt::print("Settings: Loaded '{}' (format {}) in {} us.\n", filePath, version, loadMicroseconds);
+    if (version < SETTINGS_VERSION) {
+        fmt::print("Settings: '{}' will be upgraded to format {} on the next save.\n", filePath, SETTINGS_VERSION);
+    }
 }
 
-void SettingsManager::saveSettings(const std::string& filePath, const std::shared_ptr<sf::Font>& currentFont, const FontManager& fontManager) {
-    std::ofstream file(filePath);
-    if (file.is_open()) {
-        std::string activeFontName = "PixelTCG.ttf"; // Default
-        for (const auto& [name, fontPtr] : fontManager.getAvailableFonts()) {
-            if (fontPtr == currentFont) {
-                activeFontName = name;
-                break;
-            }
+int SettingsManager::parseSettings(std::string_view contents, std::string& activeFontName) {
+    // Version 1 files have no keys or comments at all; their first line is a bare number.
+    std::string_view firstLine = trim(contents.substr(0, contents.find('\n')));
+    int version = !firstLine.empty() && firstLine.front() != '#' && firstLine.find('=') == std::string_view::npos ? 1 : 0;
+
+    size_t lineNumber = 0;
+    while (!contents.empty()) {
+        size_t newline = contents.find('\n');
+        std::string_view line = contents.substr(0, newline);
+        contents = newline == std::string_view::npos ? std::string_view{} : contents.substr(newline + 1);
+
+        std::string_view key;
+        std::string_view value;
+        if (version == 1) {
+            if (lineNumber >= VERSION_1_LINES.size()) break;
+            key = VERSION_1_LINES[lineNumber++];
+            value = trim(line);
+        } else {
+            line = trim(line);
+            size_t equals = line.find('=');
+            if (line.empty() || line.front() == '#' || equals == std::string_view::npos) continue;
+            key = trim(line.substr(0, equals));
+            value = trim(line.substr(equals + 1));
         }
 
-        file << wordSpeedMultiplier << "\n"
-             << spawnRateMultiplier << "\n"
-             << (highlightTyping ? 1 : 0) << "\n"
-             << currentFontSize << "\n"
-             << static_cast<int>(currentInputStyle) << "\n"
-             << activeFontName << "\n" // Font that was active when settings were saved (could be random if randomize ON)
-             << (randomizeFontsEnabled ? 1 : 0) << "\n"
-             << explicitlySelectedFontName << "\n" // User's choice for non-random mode
-             << (randomizeWordSetsEnabled ? 1 : 0) << "\n";
-
-        for (const auto& name : randomizedFontNames) {
-            file << name << " ";
+        if (key == VERSION_KEY) {
+            if (!parseValue(value, version)) version = SETTINGS_VERSION;
+            if (version > SETTINGS_VERSION) {
+                fmt::print(stderr, "Warning: Settings format {} is newer than this build ({}); unknown keys are ignored.\n", version, SETTINGS_VERSION);
+            }
+        } else if (key == ACTIVE_FONT_KEY) {
+            activeFontName.assign(value);
+        } else if (const SettingField* setting = findField(key)) {
+            if (!setting->parse(*this, value)) {
+                fmt::print(stderr, "Warning: Invalid value '{}' for setting '{}', using default.\n", value, key);
+            }
+        } else if (version <= SETTINGS_VERSION) {
+            fmt::print(stderr, "Warning: Ignoring unknown setting '{}'.\n", key);
         }
-        file << "\n";
+    }
+    if (version == 1 && lineNumber < VERSION_1_LINES.size()) {
+        fmt::print(stderr, "Warning: Settings file ends after {} lines; missing settings use defaults.\n", lineNumber);
+    }
 
-        for (const auto& index : randomizedWordSetIndices) {
-            file << index << " ";
+    if (leaderboardCapacity < 1 || leaderboardCapacity > GameConstants::MAX_LEADERBOARD_CAPACITY) {
+        fmt::print(stderr, "Warning: Leaderboard capacity {} out of range, using default.\n", leaderboardCapacity);
+        leaderboardCapacity = GameConstants::DEFAULT_LEADERBOARD_CAPACITY;
+    }
+    return version == 0 ? SETTINGS_VERSION : version;
+}
+
+void SettingsManager::saveSettings(PersistenceWorker& persistence, const std::string& filePath, const std::shared_ptr<sf::Font>& currentFont, const FontManager& fontManager) const {
+    std::string activeFontName = "PixelTCG.ttf"; // Default
+    for (const auto& [name, fontPtr] : fontManager.getAvailableFonts()) {
+        if (fontPtr == currentFont) {
+            activeFontName = name;
+            break;
         }
-        file << "\n";
+    }
+    // The copy is the immutable snapshot; later changes on the UI thread do not reach it.
+    persistence.saveFile(filePath, [snapshot = *this, activeFontName] {
+        return snapshot.serialize(activeFontName);
+    });
+}
 
-        file.close();
-    } else {
-        fmt::print(stderr, "Error: Could not open settings file '{}' for saving.\n", filePath);
+std::string SettingsManager::serialize(const std::string& activeFontName) const {
+    std::string out = fmt::format("# Monkey Typer settings\n{}={}\n{}={}\n", VERSION_KEY, SETTINGS_VERSION, ACTIVE_FONT_KEY, activeFontName);
+    for (const SettingField& setting : SETTING_FIELDS) {
+        out += setting.key;
+        out += '=';
+        setting.write(*this, out);
+        out += '\n';
     }
+    return out;
+}
+
+std::string SettingsManager::profilePath(const std::string& profileName) {
+    if (profileName.empty()) return "../util/settings.cfg";
+    return "../util/profiles/" + profileName + ".cfg";
 }
 
 float SettingsManager::getWordSpeedMultiplier() const { return wordSpeedMultiplier; }
@@ -174,6 +301,11 @@ bool SettingsManager::randomizeFonts() const { return randomizeFontsEnabled; }
 const std::set<std::string>& SettingsManager::getRandomizedFontNames() const { return randomizedFontNames; }
 const std::set<size_t>& SettingsManager::getRandomizedWordSetIndices() const { return randomizedWordSetIndices; }
 bool SettingsManager::randomizeWordSets() const { return randomizeWordSetsEnabled; }
+bool SettingsManager::weaknessTraining() const { return weaknessTrainingEnabled; }
+GameConstants::PseudoWordMode SettingsManager::getPseudoWordMode() const { return pseudoWordMode; }
+bool SettingsManager::paragraphMode() const { return paragraphModeEnabled; }
+bool SettingsManager::freeTyping() const { return freeTypingEnabled; }
+size_t SettingsManager::getLeaderboardCapacity() const { return leaderboardCapacity; }
 
 
 void SettingsManager::setWordSpeedMultiplier(float val) { wordSpeedMultiplier = val; }
@@ -184,6 +316,11 @@ void SettingsManager::setCurrentInputStyle(GameConstants::InputDisplayStyle val)
 void SettingsManager::setUseLinkedWords(bool val) { useLinkedWordsEnabled = val; }
 void SettingsManager::setRandomizeFonts(bool val) { randomizeFontsEnabled = val; }
 void SettingsManager::setRandomizeWordSets(bool val) { randomizeWordSetsEnabled = val; }
+void SettingsManager::setWeaknessTraining(bool val) { weaknessTrainingEnabled = val; }
+void SettingsManager::setPseudoWordMode(GameConstants::PseudoWordMode val) { pseudoWordMode = val; }
+void SettingsManager::setParagraphMode(bool val) { paragraphModeEnabled = val; }
+void SettingsManager::setFreeTyping(bool val) { freeTypingEnabled = val; }
+void SettingsManager::setLeaderboardCapacity(size_t val) { leaderboardCapacity = val; }
 
 void SettingsManager::toggleRandomizedFont(const std::string& fontName) {
     if (randomizedFontNames.count(fontName)) {
@@ -201,4 +338,14 @@ void SettingsManager::toggleRandomizedWordSet(size_t setIndex) {
     }
 }
 void SettingsManager::clearRandomizedFonts() { randomizedFontNames.clear(); }
-void SettingsManager::clearRandomizedWordSets() { randomizedWordSetIndices.clear(); }
\ No newline at end of file
+void SettingsManager::clearRandomizedWordSets() { randomizedWordSetIndices.clear(); }
+
+void SettingsManager::remapRandomizedWordSets(const std::vector<std::ptrdiff_t>& indexRemap) {
+    std::set<size_t> remapped;
+    for (size_t index : randomizedWordSetIndices) {
+        if (index < indexRemap.size() && indexRemap[index] >= 0) {
+            remapped.insert(static_cast<size_t>(indexRemap[index]));
+        }
+    }
+    randomizedWordSetIndices.swap(remapped);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "../include/StreamingWordSource.h"
+#include "../include/Constants.h"
+#include "../include/WordListCleaner.h"
+#include <fmt/core.h>
+#include <fstream>
+#include <cctype>
+
+StreamingWordSource::StreamingWordSource(const std::string& filePath, size_t reservoirCapacity)
+        : filePath(filePath), capacity(reservoirCapacity > 0 ? reservoirCapacity : 1),
+          stopRequested(false), wordsScanned(0), scanComplete(false), failed(false) {}
+
+StreamingWordSource::~StreamingWordSource() {
+    stopRequested = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void StreamingWordSource::start() {
+    if (worker.joinable()) return;
+    worker = std::thread(&StreamingWordSource::run, this);
+}
+
+bool StreamingWordSource::drawWord(std::mt19937& randomGen, std::string& out) const {
+    auto snapshot = std::atomic_load(&published);
+    if (!snapshot || snapshot->empty()) return false;
+    std::uniform_int_distribution<size_t> dist(0, snapshot->size() - 1);
+    out = (*snapshot)[dist(randomGen)];
+    return true;
+}
+
+std::shared_ptr<const std::vector<std::string>> StreamingWordSource::getSnapshot() const {
+    return std::atomic_load(&published);
+}
+
+const std::string& StreamingWordSource::getFilePath() const { return filePath; }
+uint64_t StreamingWordSource::getWordsScanned() const { return wordsScanned.load(std::memory_order_relaxed); }
+bool StreamingWordSource::isScanComplete() const { return scanComplete.load(); }
+bool StreamingWordSource::hasFailed() const { return failed.load(); }
+
+void StreamingWordSource::publish(const std::vector<std::string>& reservoir, size_t filled) {
+    auto snapshot = std::make_shared<const std::vector<std::string>>(reservoir.begin(), reservoir.begin() + filled);
+    std::atomic_store(&published, std::shared_ptr<const std::vector<std::string>>(std::move(snapshot)));
+}
+
+void StreamingWordSource::run() {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        fmt::print(stderr, "StreamingWordSource: Could not open '{}'.\n", filePath);
+        failed = true;
+        return;
+    }
+
+    // One pass draws a uniform sample of the whole file. The partial reservoir is published
+    // periodically so play can start before the scan completes. The file is read in fixed chunks
+    // and over-long tokens are skipped rather than buffered, so memory stays bounded even for a
+    // file without whitespace. A changed file is not rescanned here: the dictionary watcher makes
+    // WordDatabaseManager start a new source for it.
+    std::mt19937_64 scanRandom(std::random_device{}());
+    std::vector<std::string> reservoir(capacity);
+    std::vector<char> chunk(GameConstants::STREAMING_READ_CHUNK_BYTES);
+    const size_t maxTokenBytes = 2 * GameConstants::MAX_WORD_LENGTH; // Room for punctuation normalizeToken trims
+    uint64_t seen = 0;
+    std::string token;
+    bool discardToken = false;
+
+    auto addToken = [&]() {
+        // Same per-word cleaning as in-memory sets; dedup is not possible without holding the file.
+        if (!WordListCleaner::normalizeToken(token) || token.size() > GameConstants::MAX_WORD_LENGTH) return;
+        if (seen < capacity) {
+            reservoir[seen] = token;
+        } else {
+            std::uniform_int_distribution<uint64_t> slot(0, seen);
+            uint64_t j = slot(scanRandom);
+            if (j < capacity) reservoir[j] = token;
+        }
+        ++seen;
+        wordsScanned.fetch_add(1, std::memory_order_relaxed);
+        if (seen == capacity || seen % GameConstants::STREAMING_PUBLISH_INTERVAL == 0) {
+            publish(reservoir, static_cast<size_t>(std::min<uint64_t>(seen, capacity)));
+        }
+    };
+
+    while (!stopRequested) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::streamsize bytesRead = file.gcount();
+        for (std::streamsize i = 0; i < bytesRead; ++i) {
+            char c = chunk[static_cast<size_t>(i)];
+            if (!std::isspace(static_cast<unsigned char>(c))) {
+                if (discardToken) continue;
+                if (token.size() == maxTokenBytes) {
+                    token.clear();
+                    discardToken = true;
+                    continue;
+                }
+                token += c;
+                continue;
+            }
+            if (!token.empty()) {
+                addToken();
+                token.clear();
+            }
+            discardToken = false;
+        }
+        if (bytesRead < static_cast<std::streamsize>(chunk.size())) break;
+    }
+    if (stopRequested) return;
+    if (!token.empty()) addToken();
+
+    if (seen == 0) {
+        fmt::print(stderr, "StreamingWordSource: '{}' contains no words.\n", filePath);
+        failed = true;
+        return;
+    }
+    publish(reservoir, static_cast<size_t>(std::min<uint64_t>(seen, capacity)));
+    scanComplete = true;
+    fmt::print("StreamingWordSource: Finished scanning '{}' ({} words).\n", filePath, seen);
+}
@@ -0,0 +1,175 @@
+#include "../include/TextStreamSource.h"
+#include "../include/Constants.h"
+#include <fmt/core.h>
+#include <fstream>
+#include <random>
+
+namespace {
+    // Maps the typographic punctuation common in books to ASCII. Returns the number of bytes
+    // consumed from a UTF-8 sequence starting at 'p' and the replacement, or 0 if unknown.
+    size_t asciiForUtf8(const char* p, const char* end, char& replacement) {
+        if (end - p < 3 || static_cast<unsigned char>(p[0]) != 0xE2 || static_cast<unsigned char>(p[1]) != 0x80) return 0;
+        switch (static_cast<unsigned char>(p[2])) {
+            case 0x98: case 0x99: replacement = '\''; return 3; // ‘ ’
+            case 0x9C: case 0x9D: replacement = '"'; return 3;  // “ ”
+            case 0x93: case 0x94: replacement = '-'; return 3;  // – —
+            default: return 0;
+        }
+    }
+
+    // Rewrites 'token' into something the player can type; returns false to skip it.
+    bool makeTypeable(std::string& token) {
+        std::string out;
+        out.reserve(token.size());
+        const char* p = token.data();
+        const char* end = p + token.size();
+        while (p < end) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c >= 32 && c <= 126) {
+                out += static_cast<char>(c);
+                ++p;
+                continue;
+            }
+            char replacement;
+            size_t consumed = asciiForUtf8(p, end, replacement);
+            if (consumed == 0) return false;
+            out += replacement;
+            p += consumed;
+        }
+        if (out.empty() || out.size() > GameConstants::MAX_WORD_LENGTH) return false;
+        token.swap(out);
+        return true;
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+    }
+}
+
+TextStreamSource::TextStreamSource(const std::string& filePath)
+        : filePath(filePath), stopRequested(false), failed(false) {}
+
+TextStreamSource::~TextStreamSource() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
+    }
+    spaceAvailable.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void TextStreamSource::start(uint64_t seed) {
+    if (worker.joinable()) return;
+    worker = std::thread(&TextStreamSource::run, this, seed);
+}
+
+size_t TextStreamSource::takeWords(std::vector<std::string>& out, size_t maxWords) {
+    std::unique_lock<std::mutex> lock(queueMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return 0;
+    size_t taken = 0;
+    while (taken < maxWords && !queue.empty()) {
+        out.push_back(std::move(queue.front()));
+        queue.pop_front();
+        ++taken;
+    }
+    lock.unlock();
+    if (taken > 0) spaceAvailable.notify_one();
+    return taken;
+}
+
+bool TextStreamSource::hasFailed() const {
+    return failed;
+}
+
+const std::string& TextStreamSource::getFilePath() const {
+    return filePath;
+}
+
+bool TextStreamSource::enqueue(std::vector<std::string>& words) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    for (auto& word : words) {
+        spaceAvailable.wait(lock, [this] { return stopRequested || queue.size() < GameConstants::TEXT_STREAM_QUEUE_WORDS; });
+        if (stopRequested) return false;
+        queue.push_back(std::move(word));
+    }
+    words.clear();
+    return true;
+}
+
+void TextStreamSource::run(uint64_t seed) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        fmt::print(stderr, "TextStreamSource: Could not open '{}'.\n", filePath);
+        failed = true;
+        return;
+    }
+
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    std::streamoff startOffset = 0;
+    if (fileSize > 0) {
+        std::mt19937_64 random(seed);
+        startOffset = static_cast<std::streamoff>(random() % static_cast<uint64_t>(fileSize));
+    }
+    file.seekg(startOffset);
+
+    std::vector<char> chunk(GameConstants::TEXT_STREAM_CHUNK_BYTES);
+    std::vector<std::string> batch;
+    // A typeable word has at most MAX_WORD_LENGTH characters of up to three UTF-8 bytes each.
+    const size_t maxTokenBytes = GameConstants::MAX_WORD_LENGTH * 3;
+    std::string token;
+    bool discardToken = startOffset > 0; // We probably landed mid-word
+    bool wrapped = false;
+    uint64_t wordsSinceStart = 0;
+
+    while (!stopRequested) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        std::streamsize bytesRead = file.gcount();
+
+        for (std::streamsize i = 0; i < bytesRead; ++i) {
+            char c = chunk[static_cast<size_t>(i)];
+            if (!isSpace(c)) {
+                if (discardToken) continue;
+                if (token.size() == maxTokenBytes) {
+                    // Too long to type; skip the rest instead of buffering it (e.g. a file without spaces).
+                    token.clear();
+                    discardToken = true;
+                    continue;
+                }
+                token += c; // A token spanning two chunks simply keeps growing here
+                continue;
+            }
+            if (!token.empty()) {
+                if (makeTypeable(token)) {
+                    batch.push_back(std::move(token));
+                    ++wordsSinceStart;
+                }
+                token.clear();
+            }
+            discardToken = false;
+        }
+        if (!batch.empty() && !enqueue(batch)) return;
+
+        if (bytesRead < static_cast<std::streamsize>(chunk.size())) {
+            // End of file: finish the last token, then wrap around to the beginning.
+            if (!token.empty() && makeTypeable(token)) {
+                batch.push_back(std::move(token));
+                ++wordsSinceStart;
+            }
+            token.clear();
+            discardToken = false;
+            if (!batch.empty() && !enqueue(batch)) return;
+
+            if (wrapped && wordsSinceStart == 0) {
+                fmt::print(stderr, "TextStreamSource: '{}' contains no typeable text.\n", filePath);
+                failed = true;
+                return;
+            }
+            file.clear();
+            file.seekg(0);
+            wrapped = true;
+        }
+    }
+}
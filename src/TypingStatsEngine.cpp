@@ -0,0 +1,115 @@
+#include "../include/TypingStatsEngine.h"
+#include <algorithm>
+
+namespace {
+    constexpr uint64_t SLOT_MICROS = static_cast<uint64_t>(GameConstants::TYPING_STATS_SLOT_MS) * 1000;
+    constexpr size_t SLOT_MASK = GameConstants::TYPING_STATS_SLOTS - 1;
+    static_assert((GameConstants::TYPING_STATS_SLOTS & SLOT_MASK) == 0, "TYPING_STATS_SLOTS must be a power of two");
+
+    float wordsPerMinute(uint32_t keys, float minutes) {
+        return minutes > 0.f ? keys / 5.0f / minutes : 0.f;
+    }
+}
+
+TypingStatsEngine::TypingStatsEngine() {
+    for (size_t i = 0; i < WINDOW_COUNT; ++i) {
+        windows[i].slots = static_cast<uint64_t>(GameConstants::TYPING_STATS_WINDOW_SECONDS[i]) * 1000 /
+                           GameConstants::TYPING_STATS_SLOT_MS;
+        // A slot must still be in the ring when it leaves the window.
+        if (windows[i].slots >= GameConstants::TYPING_STATS_SLOTS) windows[i].slots = GameConstants::TYPING_STATS_SLOTS - 1;
+    }
+}
+
+void TypingStatsEngine::begin(uint64_t micros) {
+    slots.fill(Slot{});
+    for (WindowSums& window : windows) {
+        window.keys = 0;
+        window.correctKeys = 0;
+    }
+    startMicros = micros;
+    nowMicros = micros;
+    currentSlot = 0;
+    typedKeys = 0;
+    correctKeys = 0;
+    peak = 0.f;
+}
+
+void TypingStatsEngine::keyTyped(uint64_t micros, bool correct) {
+    advance(micros);
+    Slot& slot = slots[currentSlot & SLOT_MASK];
+    ++slot.keys;
+    ++typedKeys;
+    for (WindowSums& window : windows) ++window.keys;
+    if (correct) {
+        ++slot.correctKeys;
+        ++correctKeys;
+        for (WindowSums& window : windows) ++window.correctKeys;
+    }
+}
+
+void TypingStatsEngine::advance(uint64_t micros) {
+    if (micros <= nowMicros) return; // Keys are stamped before the frame that reads them
+    nowMicros = micros;
+    uint64_t targetSlot = (micros - startMicros) / SLOT_MICROS;
+    if (targetSlot - currentSlot >= GameConstants::TYPING_STATS_SLOTS) {
+        // Idle for longer than the ring: every window is empty.
+        slots.fill(Slot{});
+        for (WindowSums& window : windows) {
+            window.keys = 0;
+            window.correctKeys = 0;
+        }
+        currentSlot = targetSlot;
+    }
+    while (currentSlot < targetSlot) {
+        ++currentSlot;
+        for (WindowSums& window : windows) {
+            if (currentSlot < window.slots) continue;
+            const Slot& leaving = slots[(currentSlot - window.slots) & SLOT_MASK];
+            window.keys -= leaving.keys;
+            window.correctKeys -= leaving.correctKeys;
+        }
+        slots[currentSlot & SLOT_MASK] = Slot{};
+    }
+    if (currentSlot + 1 >= windows[INSTANT].slots) {
+        peak = std::max(peak, netWpm(INSTANT));
+    }
+}
+
+float TypingStatsEngine::windowMinutes(const WindowSums& window) const {
+    // The window ends now and starts at a slot boundary, or at the start of the run if that is later.
+    uint64_t elapsed = nowMicros - startMicros;
+    uint64_t covered = std::min(elapsed, (window.slots - 1) * SLOT_MICROS + (elapsed - currentSlot * SLOT_MICROS));
+    return static_cast<float>(covered / 60.0e6);
+}
+
+float TypingStatsEngine::netWpm(Window window) const {
+    return wordsPerMinute(windows[window].correctKeys, windowMinutes(windows[window]));
+}
+
+float TypingStatsEngine::rawWpm(Window window) const {
+    return wordsPerMinute(windows[window].keys, windowMinutes(windows[window]));
+}
+
+float TypingStatsEngine::runNetWpm() const {
+    return wordsPerMinute(correctKeys, static_cast<float>((nowMicros - startMicros) / 60.0e6));
+}
+
+float TypingStatsEngine::runRawWpm() const {
+    return wordsPerMinute(typedKeys, static_cast<float>((nowMicros - startMicros) / 60.0e6));
+}
+
+float TypingStatsEngine::peakWpm() const {
+    return peak;
+}
+
+float TypingStatsEngine::accuracy() const {
+    return typedKeys > 0 ? correctKeys * 100.0f / typedKeys : 100.0f;
+}
+
+uint32_t TypingStatsEngine::getTypedKeys() const {
+    return typedKeys;
+}
+
+uint32_t TypingStatsEngine::getCorrectKeys() const {
+    return correctKeys;
+}
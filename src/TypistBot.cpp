@@ -0,0 +1,194 @@
+#include "../include/TypistBot.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TypistBot::TypistBot(const Profile& profile, uint32_t seed)
+        : profile(profile), randomGen(seed) {
+    this->profile.wordsPerMinute = std::max(1.f, profile.wordsPerMinute);
+    this->profile.errorRate = std::clamp(profile.errorRate, 0.f, 1.f);
+    this->profile.reactionTime = std::max(0.f, profile.reactionTime);
+}
+
+void TypistBot::reset() {
+    untilNextKey = 0.f;
+    aimed = false;
+    freeTargetId = 0;
+    freeInput.clear();
+}
+
+const TypistBot::Profile& TypistBot::getProfile() const {
+    return profile;
+}
+
+bool TypistBot::update(const GameSession& session, float deltaTime, sf::Event& event, float& lateBy) {
+    untilNextKey -= deltaTime;
+    if (untilNextKey > 0.f || session.isOver()) {
+        return false;
+    }
+    // Keys overdue by more than a frame are not caught up; a frame carries at most one key.
+    untilNextKey = std::max(untilNextKey, -deltaTime);
+    lateBy = -untilNextKey;
+
+    Delay delay = Delay::NONE;
+    sf::Uint32 key = chooseKey(session, delay);
+    switch (delay) {
+        case Delay::NONE:
+            untilNextKey = 0.f;
+            break;
+        case Delay::KEY:
+            untilNextKey += sample(60.f / (profile.wordsPerMinute * 5.f), 0.3f);
+            break;
+        case Delay::REACTION:
+            untilNextKey += sample(profile.reactionTime, 0.25f);
+            break;
+    }
+    if (key == 0) {
+        return false;
+    }
+    event.type = sf::Event::TextEntered;
+    event.text.unicode = key;
+    return true;
+}
+
+sf::Uint32 TypistBot::chooseKey(const GameSession& session, Delay& delay) {
+    if (session.isFreeTyping()) {
+        return chooseFreeTypingKey(session, delay);
+    }
+
+    for (const auto& word : session.getActiveWords()) {
+        if (!word || !word->isBeingActivelyTyped() || word->isComplete()) continue;
+        aimed = false;
+        if (word->hasTypingError()) {
+            delay = Delay::KEY;
+            return 8;
+        }
+        const std::string& text = word->getText();
+        size_t typed = word->getCurrentInput().size();
+        if (typed < text.size()) {
+            return typeNext(text[typed], delay);
+        }
+    }
+
+    // Nothing selected: find a word, take a reaction time to start it, then type its first key.
+    const Word* target = pickTarget(session);
+    if (!target) {
+        aimed = false;
+        return 0;
+    }
+    if (!aimed) {
+        aimed = true;
+        delay = Delay::REACTION;
+        return 0;
+    }
+    aimed = false;
+    return typeNext(target->getText()[0], delay);
+}
+
+sf::Uint32 TypistBot::chooseFreeTypingKey(const GameSession& session, Delay& delay) {
+    const Word* target = nullptr;
+    if (freeTargetId != 0) {
+        for (const auto& word : session.getActiveWords()) {
+            if (word && word->getId() == freeTargetId && !word->isComplete()) {
+                target = word.get();
+                break;
+            }
+        }
+    }
+
+    if (!target) {
+        freeTargetId = 0;
+        if (!freeInput.empty()) {
+            // The word left (or was completed by another match); clear what was typed towards it.
+            freeInput.pop_back();
+            delay = Delay::KEY;
+            return 8;
+        }
+        target = pickTarget(session);
+        if (!target) {
+            aimed = false;
+            return 0;
+        }
+        if (!aimed) {
+            aimed = true;
+            delay = Delay::REACTION;
+            return 0;
+        }
+        aimed = false;
+        freeTargetId = target->getId();
+    }
+
+    const std::string& text = target->getText();
+    if (text.compare(0, freeInput.size(), freeInput) != 0) {
+        freeInput.pop_back();
+        delay = Delay::KEY;
+        return 8;
+    }
+    sf::Uint32 key = typeNext(text[freeInput.size()], delay);
+    freeInput += static_cast<char>(key);
+    if (freeInput == text) {
+        // This key completes the word and the session starts a new stream.
+        freeTargetId = 0;
+        freeInput.clear();
+    }
+    return key;
+}
+
+sf::Uint32 TypistBot::typeNext(char expected, Delay& delay) {
+    if (std::uniform_real_distribution<float>(0.f, 1.f)(randomGen) < profile.errorRate) {
+        // Some other lowercase letter; noticing it takes a reaction time.
+        char wrong = static_cast<char>('a' + std::uniform_int_distribution<int>(0, 25)(randomGen));
+        if (wrong == expected) wrong = wrong == 'z' ? 'a' : static_cast<char>(wrong + 1);
+        delay = Delay::REACTION;
+        return static_cast<unsigned char>(wrong);
+    }
+    delay = Delay::KEY;
+    return static_cast<unsigned char>(expected);
+}
+
+const Word* TypistBot::pickTarget(const GameSession& session) {
+    const Word* best = nullptr;
+    float bestValue = std::numeric_limits<float>::max();
+    size_t candidates = 0;
+    for (const auto& word : session.getActiveWords()) {
+        if (!word || word->isComplete() || word->getText().empty()) continue;
+        candidates++;
+        float value = 0.f;
+        switch (profile.targeting) {
+            case Targeting::NEAREST_ESCAPE: {
+                sf::FloatRect bounds = word->getTypingBounds();
+                float speed = word->getSpeed();
+                if (speed > 0.f) {
+                    value = (GameConstants::WINDOW_WIDTH - bounds.left) / speed;
+                } else if (speed < 0.f) {
+                    value = (bounds.left + bounds.width) / -speed;
+                } else {
+                    value = std::numeric_limits<float>::max() / 2; // Paragraph words never escape
+                }
+                break;
+            }
+            case Targeting::OLDEST:
+                value = static_cast<float>(word->getId());
+                break;
+            case Targeting::SHORTEST:
+                value = static_cast<float>(word->getText().size());
+                break;
+            case Targeting::RANDOM:
+                // Reservoir sampling: the n-th candidate replaces the choice with probability 1/n.
+                if (std::uniform_int_distribution<size_t>(1, candidates)(randomGen) == 1) best = word.get();
+                continue;
+        }
+        if (!best || value < bestValue) {
+            best = word.get();
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+float TypistBot::sample(float mean, float sigma) {
+    if (mean <= 0.f) return 0.f;
+    // Log-normal with the given mean: mu = ln(mean) - sigma^2 / 2.
+    std::lognormal_distribution<float> distribution(std::log(mean) - sigma * sigma / 2.f, sigma);
+    return distribution(randomGen);
+}
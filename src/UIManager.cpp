@@ -4,6 +4,7 @@
 #include "../include/SettingsManager.h"
 #include "../include/HighScoreManager.h"
 #include "../include/WordDatabaseManager.h"
+#include "../include/StreamingWordSource.h"
 #include <fmt/core.h>
 #include <random>
 #include <algorithm>
@@ -30,6 +31,17 @@ void UIManager::initUI() {
     gameTimeStatsTextDisplay.setFillColor(sf::Color(180, 180, 180));
     gameTimeStatsTextDisplay.setPosition(sf::Vector2f(10.f, 50.f));
 
+    latencyOverlayDisplay.setFont(*currentFont);
+    latencyOverlayDisplay.setCharacterSize(18);
+    latencyOverlayDisplay.setFillColor(sf::Color(120, 200, 255));
+    latencyOverlayDisplay.setPosition(sf::Vector2f(10.f, 80.f));
+
+    attractBannerDisplay.setFont(*currentFont);
+    attractBannerDisplay.setCharacterSize(36);
+    attractBannerDisplay.setFillColor(sf::Color(255, 200, 80));
+    attractBannerDisplay.setString("DEMO - press any key");
+    attractBannerDisplay.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - attractBannerDisplay.getLocalBounds().width / 2.0f, 20.f));
+
     gameOverHeaderText.setFont(*currentFont);
     gameOverHeaderText.setCharacterSize(50);
     gameOverHeaderText.setFillColor(sf::Color::Red);
@@ -62,6 +74,9 @@ void UIManager::updateFonts() {
 
     scoreTextDisplay.setFont(*currentFont);
     gameTimeStatsTextDisplay.setFont(*currentFont);
+    latencyOverlayDisplay.setFont(*currentFont);
+    attractBannerDisplay.setFont(*currentFont);
+    attractBannerDisplay.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - attractBannerDisplay.getLocalBounds().width / 2.0f, 20.f));
     gameOverHeaderText.setFont(*currentFont);
     finalScoreText.setFont(*currentFont);
 
@@ -76,7 +91,7 @@ void UIManager::createMenuButtons() {
     menuButtons.clear();
     auto font = game.getCurrentFont();
     if (!font) font = fontManager.getDefaultFont();
-    const std::vector<std::string> labels = {"Start Game", "High Scores", "Settings", "Exit"};
+    const std::vector<std::string> labels = {"Start Game", "High Scores", "Statistics", "Settings", "Exit"};
     for (size_t i = 0; i < labels.size(); ++i) {
         sf::Vector2f textDesiredPos(GameConstants::WINDOW_WIDTH / 2.0f, 250.0f + i * 80.0f);
         Button button(labels[i], *font, 40, sf::Vector2f(0,0) );
@@ -136,14 +151,20 @@ void UIManager::createSettingsButtons() {
             settingsManager.randomizeFontsEnabled ? "Edit Randomized Fonts" : "",
             fmt::format("Randomize Word Sets: {}", settingsManager.randomizeWordSets() ? "ON" : "OFF"),
             settingsManager.randomizeWordSets() ? "Edit Randomized Word Sets" : "",
+            fmt::format("Weakness Training: {}", settingsManager.weaknessTraining() ? "ON" : "OFF"),
+            fmt::format("Game Mode: {}", settingsManager.paragraphMode() ? "Paragraph" : "Words"),
+            fmt::format("Free Typing: {}", settingsManager.freeTyping() ? "ON" : "OFF"),
+            fmt::format("Pseudo-words: {}", GameConstants::PSEUDO_WORD_MODE_NAMES[static_cast<int>(settingsManager.getPseudoWordMode())]),
             "Select Font",
             "Select Word Sets",
             "Back"
     };
 
-    const float buttonLayoutSpacing = 60.0f;
     const float startButtonY = 120.0f;
-    const unsigned int buttonFontSize = 32;
+    size_t visibleButtonCount = std::count_if(settingLabels.begin(), settingLabels.end(), [](const std::string& l) { return !l.empty(); });
+    // Shrink spacing (and font with it) once the list no longer fits below the title.
+    const float buttonLayoutSpacing = std::min(60.0f, (GameConstants::WINDOW_HEIGHT - startButtonY - 40.0f) / std::max<size_t>(1, visibleButtonCount));
+    const unsigned int buttonFontSize = std::min(32u, static_cast<unsigned int>(buttonLayoutSpacing * 0.55f));
     float currentButtonY = startButtonY;
 
     for (const auto& label : settingLabels) {
@@ -166,25 +187,10 @@ void UIManager::createHighScoresButtons() {
     auto font = game.getCurrentFont();
     if (!font) font = fontManager.getDefaultFont();
 
-    Button backButtonPrototype("Back", *font, 30, sf::Vector2f(0,0));
-    Button graphButtonPrototype("View Graph", *font, 30, sf::Vector2f(0,0));
-
-    float backButtonWidth = backButtonPrototype.getGlobalBounds().width;
-    float graphButtonWidth = graphButtonPrototype.getGlobalBounds().width;
-    float hsNavButtonSpacing = 40.f;
-    float totalHsNavWidth = backButtonWidth + graphButtonWidth + hsNavButtonSpacing;
-    float hsNavStartX = (GameConstants::WINDOW_WIDTH - totalHsNavWidth) / 2.f;
-    float hsNavY = GameConstants::WINDOW_HEIGHT - 80.0f;
-
-    Button actualBackButton("Back", *font, 30, sf::Vector2f(0,0));
-    sf::FloatRect backTextLocalBounds = actualBackButton.text.getLocalBounds();
-    actualBackButton.setPosition(sf::Vector2f(hsNavStartX + backButtonWidth / 2.f - backTextLocalBounds.width / 2.f, hsNavY));
-    highScoresNavigationButtons.push_back(actualBackButton);
-
-    Button actualGraphButton("View Graph", *font, 30, sf::Vector2f(0,0));
-    sf::FloatRect graphTextLocalBounds = actualGraphButton.text.getLocalBounds();
-    actualGraphButton.setPosition(sf::Vector2f(hsNavStartX + backButtonWidth + hsNavButtonSpacing + graphButtonWidth / 2.f - graphTextLocalBounds.width / 2.f, hsNavY));
-    highScoresNavigationButtons.push_back(actualGraphButton);
+    // Positions are final only once renderHighScores lays the row out under the panel.
+    for (const char* label : {"Back", "View Graph", "Export"}) {
+        highScoresNavigationButtons.emplace_back(label, *font, 30, sf::Vector2f(0,0));
+    }
 }
 
 
@@ -220,6 +226,13 @@ void UIManager::createFontSelectionRelatedButtons() {
             graphBackButtonTextDesiredPos.x - currentTextLocalBoundsGraph.width / 2.0f,
             graphBackButtonTextDesiredPos.y
     ));
+
+    statsViewBackButton = Button("Back", *font, 30, sf::Vector2f(0,0));
+    sf::FloatRect currentTextLocalBoundsStats = statsViewBackButton.text.getLocalBounds();
+    statsViewBackButton.setPosition(sf::Vector2f(
+            graphBackButtonTextDesiredPos.x - currentTextLocalBoundsStats.width / 2.0f,
+            graphBackButtonTextDesiredPos.y
+    ));
 }
 
 void UIManager::update(const sf::Vector2f& mousePos, float deltaTime) {
@@ -252,6 +265,9 @@ void UIManager::update(const sf::Vector2f& mousePos, float deltaTime) {
         case MonkeyTyperGame::GameState::GRAPH_VIEW:
             graphViewBackButton.update(mousePos);
             break;
+        case MonkeyTyperGame::GameState::STATS_VIEW:
+            statsViewBackButton.update(mousePos);
+            break;
         default:
             break;
     }
@@ -265,12 +281,13 @@ void UIManager::processMenuEvent(sf::Event& event) {
                 switch (i) {
                     case 0: game.startGame(); break;
                     case 1: game.setGameState(MonkeyTyperGame::GameState::HIGH_SCORES); selectedScoreIndex = -1; break;
-                    case 2:
+                    case 2: openStatsView(); break;
+                    case 3:
                         game.setGameState(MonkeyTyperGame::GameState::SETTINGS);
                         for (auto& anim : settingsAnimations) anim.reset();
                         refreshSettingsButtons();
                         break;
-                    case 3: window.close(); break;
+                    case 4: window.close(); break;
                 }
                 return;
             }
@@ -351,9 +368,10 @@ void UIManager::processHighScoresEvent(sf::Event& event) {
         float headerRegionHeight = 20.0f + 40.0f;
         float listContentStartYPos = localHsPanelDefinition.getPosition().y + headerRegionHeight + 10.f;
 
-        const auto& scores = highScoreManager.getHighScores();
-        for (size_t i = 0; i < scores.size(); ++i) {
+        size_t scoreCount = highScoreManager.getHighScoreCount(selectedPartition);
+        for (size_t i = 0; i < scoreCount; ++i) {
             float yPos = listContentStartYPos + i * 40.0f;
+            if (yPos > localHsPanelDefinition.getPosition().y + localHsPanelDefinition.getSize().y) break; // Only visible rows are clickable
             sf::FloatRect scoreItemRect(
                     localHsPanelDefinition.getPosition().x + 20.f,
                     yPos - 5.0f,
@@ -369,18 +387,31 @@ void UIManager::processHighScoresEvent(sf::Event& event) {
         if (!highScoresNavigationButtons.empty() && highScoresNavigationButtons[0].contains(mousePos)) {
             game.setGameState(MonkeyTyperGame::GameState::MENU);
             selectedScoreIndex = -1;
+            exportMessage.clear();
+            return;
+        }
+        if (highScoresNavigationButtons.size() > 2 && highScoresNavigationButtons[2].contains(mousePos)) {
+            exportMessage = fmt::format("Exporting all runs to {}.csv and .jsonl", game.exportRuns());
             return;
         }
         if (highScoresNavigationButtons.size() > 1 && selectedScoreIndex >= 0 &&
-            static_cast<size_t>(selectedScoreIndex) < scores.size() &&
+            static_cast<size_t>(selectedScoreIndex) < scoreCount &&
             highScoresNavigationButtons[1].contains(mousePos)) {
-            if (!highScoreManager.getScoreHistory(selectedScoreIndex).empty()) {
+            if (!highScoreManager.getScoreHistory(selectedPartition, selectedScoreIndex).empty()) {
                 game.setGameState(MonkeyTyperGame::GameState::GRAPH_VIEW);
             }
             return;
         }
     }
     if (event.type == sf::Event::KeyPressed) {
+        // Left/Right switch between configuration leaderboards; they are all kept in memory.
+        size_t partitionCount = highScoreManager.getPartitionCount();
+        if (event.key.code == sf::Keyboard::Left || event.key.code == sf::Keyboard::Right) {
+            selectedPartition = event.key.code == sf::Keyboard::Right ? (selectedPartition + 1) % partitionCount
+                                                                       : (selectedPartition + partitionCount - 1) % partitionCount;
+            selectedScoreIndex = -1;
+            return;
+        }
         game.setGameState(MonkeyTyperGame::GameState::MENU);
         selectedScoreIndex = -1;
     }
@@ -398,7 +429,7 @@ void UIManager::processSettingsEvent(sf::Event& event) {
 
                 if (buttonText == "Back") {
                     game.setGameState(MonkeyTyperGame::GameState::MENU);
-                    settingsManager.saveSettings("../util/settings.cfg", game.getCurrentFont(), fontManager);
+                    settingsManager.saveSettings(game.getPersistenceWorker(), game.getSettingsPath(), game.getCurrentFont(), fontManager);
                 } else if (buttonText == "Select Word Sets") {
                     game.setGameState(MonkeyTyperGame::GameState::WORD_SET_SELECTION);
                 } else if (buttonText == "Select Font") {
@@ -413,7 +444,7 @@ void UIManager::processSettingsEvent(sf::Event& event) {
                     settingsManager.setSpawnRateMultiplier(cr > 2.01f ? 0.25f : cr);
                 } else if (buttonText.find("Font Size:") == 0) {
                     unsigned int cfs = settingsManager.getCurrentFontSize() + 2;
-                    settingsManager.setCurrentFontSize(cfs > 40 ? 16 : cfs);
+                    settingsManager.setCurrentFontSize(cfs > GameConstants::MAX_FONT_SIZE ? 16 : cfs);
                     game.updateCurrentFontDependentObjects();
                     updateFonts();
                 } else if (buttonText.find("Highlight Typing:") == 0) {
@@ -451,6 +482,15 @@ void UIManager::processSettingsEvent(sf::Event& event) {
                             wordDBManager.setCurrentWordSetByIndex(0);
                         }
                     }
+                } else if (buttonText.find("Weakness Training:") == 0) {
+                    settingsManager.setWeaknessTraining(!settingsManager.weaknessTraining());
+                } else if (buttonText.find("Game Mode:") == 0) {
+                    settingsManager.setParagraphMode(!settingsManager.paragraphMode());
+                } else if (buttonText.find("Free Typing:") == 0) {
+                    settingsManager.setFreeTyping(!settingsManager.freeTyping());
+                } else if (buttonText.find("Pseudo-words:") == 0) {
+                    int nextMode = (static_cast<int>(settingsManager.getPseudoWordMode()) + 1) % static_cast<int>(GameConstants::PSEUDO_WORD_MODE_NAMES.size());
+                    settingsManager.setPseudoWordMode(static_cast<GameConstants::PseudoWordMode>(nextMode));
                 } else if (buttonText == "Edit Randomized Word Sets" && settingsManager.randomizeWordSets()) {
                     game.setGameState(MonkeyTyperGame::GameState::WORD_SET_SELECTION);
                 }else {
@@ -581,6 +621,27 @@ void UIManager::processGraphViewEvent(sf::Event& event) {
     }
 }
 
+void UIManager::openStatsView() {
+    KeystrokeAnalytics& analytics = game.getKeystrokeAnalytics();
+    analytics.refresh(game.getPersistenceWorker());
+    for (size_t length = 1; length <= 3; ++length) {
+        analytics.rankSlowest(length, GameConstants::STATS_RANKED_ROWS, GameConstants::STATS_MIN_SAMPLES, slowestKeys[length - 1]);
+    }
+    game.setGameState(MonkeyTyperGame::GameState::STATS_VIEW);
+}
+
+void UIManager::processStatsViewEvent(sf::Event& event) {
+    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+        sf::Vector2f mousePos = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
+        if (statsViewBackButton.contains(mousePos)) {
+            game.setGameState(MonkeyTyperGame::GameState::MENU);
+        }
+    }
+    if (event.type == sf::Event::KeyPressed) {
+        game.setGameState(MonkeyTyperGame::GameState::MENU);
+    }
+}
+
 void UIManager::renderMenu() {
     sf::RectangleShape bg(sf::Vector2f(GameConstants::WINDOW_WIDTH, GameConstants::WINDOW_HEIGHT));
     bg.setFillColor(sf::Color(30, 30, 50));
@@ -599,7 +660,7 @@ void UIManager::renderMenu() {
     }
 }
 
-void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int finalScoreVal, const std::deque<ScorePoint>& scoreHistory, const std::shared_ptr<sf::Font>& currentFontRef) {
+void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int finalScoreVal, const ScoreTimeline& scoreTimeline, const std::shared_ptr<sf::Font>& currentFontRef) {
     auto currentFont = currentFontRef;
     if (!currentFont) currentFont = fontManager.getDefaultFont();
 
@@ -638,7 +699,7 @@ void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int fi
         highScoreDisplayText.setString("NEW HIGH SCORE!");
         highScoreDisplayText.setFillColor(sf::Color(255, 215, 0));
     } else {
-        int topOverallScore = highScoreManager.getHighScores().empty() ? 0 : highScoreManager.getHighScores()[0].second;
+        int topOverallScore = highScoreManager.getHighScoreCount(LeaderboardStore::OVERALL) == 0 ? 0 : highScoreManager.getHighScore(LeaderboardStore::OVERALL, 0).score;
         highScoreDisplayText.setString(fmt::format("Overall High: {}", topOverallScore));
         highScoreDisplayText.setFillColor(sf::Color::White);
     }
@@ -652,7 +713,8 @@ void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int fi
             statsDisplayPanel.getSize().x / 2.0f - 30.0f,
             200.0f
     );
-    renderScoreGraph(scoreHistory, graphRenderArea, currentFont, "This Game's Progress");
+    scoreTimeline.copyBuckets(graphBuckets);
+    renderScoreGraph(graphBuckets, graphRenderArea, currentFont, "This Game's Progress");
 
     const float statsTextStartX = statsDisplayPanel.getPosition().x + statsDisplayPanel.getSize().x / 2.0f + 10.0f;
     const float statsTextStartY = graphRenderArea.top;
@@ -661,6 +723,8 @@ void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int fi
 
     std::vector<std::pair<std::string, std::string>> statsToDisplayList = {
             {"Words/min", fmt::format("{:.1f}", gameStats.wordsPerMinute)},
+            {"Raw WPM", fmt::format("{:.1f}", gameStats.rawWordsPerMinute)},
+            {"Peak WPM", fmt::format("{:.1f}", gameStats.peakWordsPerMinute)},
             {"Accuracy", fmt::format("{:.1f}%", gameStats.accuracy)},
             {"Completed", fmt::format("{} words", gameStats.wordsTyped)},
             {"Typed", fmt::format("{} chars", gameStats.charactersTyped)},
@@ -735,7 +799,7 @@ void UIManager::renderGameOver(const GameConstants::GameStats& gameStats, int fi
     }
 }
 
-void UIManager::renderScoreGraph(const std::deque<ScorePoint>& scoreHistory, const sf::FloatRect& graphBounds, const std::shared_ptr<sf::Font>& currentFontRef, const std::string& titleStr) {
+void UIManager::renderScoreGraph(const std::vector<ScoreBucket>& scoreHistory, const sf::FloatRect& graphBounds, const std::shared_ptr<sf::Font>& currentFontRef, const std::string& titleStr) {
     auto currentFont = currentFontRef;
     if (!currentFont) currentFont = fontManager.getDefaultFont();
     if (scoreHistory.empty()) return;
@@ -762,7 +826,7 @@ void UIManager::renderScoreGraph(const std::deque<ScorePoint>& scoreHistory, con
     window.draw(xAxis);
 
     float maxScoreVal = 0;
-    for (const auto& point : scoreHistory) maxScoreVal = std::max(maxScoreVal, static_cast<float>(point.score));
+    for (const auto& bucket : scoreHistory) maxScoreVal = std::max(maxScoreVal, static_cast<float>(bucket.maxScore));
     if (maxScoreVal < 1.f) maxScoreVal = 1.f;
 
     int numGridLinesY = 5;
@@ -793,8 +857,8 @@ void UIManager::renderScoreGraph(const std::deque<ScorePoint>& scoreHistory, con
                                             graphBounds.top + graphBounds.height / 2 + yAxisTitleTextLocalBounds.width / 2));
     window.draw(yAxisTitleText);
 
-    float firstTimestamp = scoreHistory.front().timeStamp;
-    float lastTimestamp = scoreHistory.back().timeStamp;
+    float firstTimestamp = scoreHistory.front().startTime;
+    float lastTimestamp = scoreHistory.back().endTime;
     float timeRange = lastTimestamp - firstTimestamp;
     if (timeRange < 0.1f) timeRange = 0.1f;
 
@@ -831,16 +895,24 @@ void UIManager::renderScoreGraph(const std::deque<ScorePoint>& scoreHistory, con
 
 
     if (scoreHistory.size() >= 2) {
+        auto plotY = [&](int scoreValue) {
+            float yPlot = graphBounds.top + graphBounds.height - (static_cast<float>(scoreValue) / maxScoreVal) * graphBounds.height;
+            return std::max(graphBounds.top, std::min(yPlot, graphBounds.top + graphBounds.height));
+        };
         sf::VertexArray lines(sf::LineStrip, scoreHistory.size());
+        sf::VertexArray ranges(sf::Lines);
         for (size_t i = 0; i < scoreHistory.size(); ++i) {
-            const auto& point = scoreHistory[i];
-            float xRatio = (timeRange > 0.001f) ? ((point.timeStamp - firstTimestamp) / timeRange) : (scoreHistory.size() > 1 ? static_cast<float>(i) / (scoreHistory.size()-1) : 0.5f);
+            const auto& bucket = scoreHistory[i];
+            float xRatio = (timeRange > 0.001f) ? ((bucket.endTime - firstTimestamp) / timeRange) : (scoreHistory.size() > 1 ? static_cast<float>(i) / (scoreHistory.size()-1) : 0.5f);
             float x = graphBounds.left + xRatio * graphBounds.width;
-            float yPlot = graphBounds.top + graphBounds.height - (static_cast<float>(point.score) / maxScoreVal) * graphBounds.height;
-            yPlot = std::max(graphBounds.top, std::min(yPlot, graphBounds.top + graphBounds.height));
-            lines[i].position = sf::Vector2f(x, yPlot);
+            lines[i].position = sf::Vector2f(x, plotY(bucket.lastScore));
             lines[i].color = sf::Color(100, 255, 100, 220);
+            if (bucket.minScore != bucket.maxScore) {
+                ranges.append(sf::Vertex(sf::Vector2f(x, plotY(bucket.minScore)), sf::Color(100, 255, 100, 70)));
+                ranges.append(sf::Vertex(sf::Vector2f(x, plotY(bucket.maxScore)), sf::Color(100, 255, 100, 70)));
+            }
         }
+        window.draw(ranges);
         window.draw(lines);
 
         for(size_t i=0; i<scoreHistory.size(); ++i) {
@@ -880,11 +952,21 @@ void UIManager::renderHighScores() {
     hsContentPanel.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - hsContentPanel.getSize().x / 2.0f, 150.0f));
     window.draw(hsContentPanel);
 
-    const auto& scores = highScoreManager.getHighScores();
+    if (selectedPartition >= highScoreManager.getPartitionCount()) selectedPartition = LeaderboardStore::OVERALL;
+    std::string partitionHeader = highScoreManager.getPartitionCount() > 1
+            ? fmt::format("<  {}  >", highScoreManager.getPartitionLabel(selectedPartition))
+            : highScoreManager.getPartitionLabel(selectedPartition);
+    sf::Text partitionText(partitionHeader, *currentFont, 22);
+    partitionText.setFillColor(sf::Color(200, 200, 255));
+    sf::FloatRect partitionTextLocalBounds = partitionText.getLocalBounds();
+    partitionText.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - partitionTextLocalBounds.width / 2.0f, 118.0f));
+    window.draw(partitionText);
+
+    size_t scoreCount = highScoreManager.getHighScoreCount(selectedPartition);
     float headerY = hsContentPanel.getPosition().y + 20.0f;
     float listStartY = headerY + 70.0f;
 
-    if (scores.empty()) {
+    if (scoreCount == 0) {
         sf::Text noScoresText("No high scores yet!", *currentFont, 40);
         sf::FloatRect noScoresTextLocalBounds = noScoresText.getLocalBounds();
         noScoresText.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - noScoresTextLocalBounds.width / 2.0f,
@@ -912,7 +994,8 @@ void UIManager::renderHighScores() {
         headerContentLine.setPosition(sf::Vector2f(hsContentPanel.getPosition().x + 20.f, headerY + 40.0f));
         window.draw(headerContentLine);
 
-        for (size_t i = 0; i < scores.size(); ++i) {
+        for (size_t i = 0; i < scoreCount; ++i) {
+            const Leaderboard::Entry& scoreEntry = highScoreManager.getHighScore(selectedPartition, i);
             float yPos = listStartY + i * 40.0f;
             float navButtonHeight = highScoresNavigationButtons.empty() ? 0.f : highScoresNavigationButtons[0].getGlobalBounds().height;
             if (yPos + 20.f > hsContentPanel.getPosition().y + hsContentPanel.getSize().y - (navButtonHeight + 20.f) ) break;
@@ -935,22 +1018,22 @@ void UIManager::renderHighScores() {
             rankDisplayText.setPosition(sf::Vector2f(headers[0].second, yPos));
             window.draw(rankDisplayText);
 
-            sf::Text nameDisplayTextItem(scores[i].first, *currentFont, 24);
+            sf::Text nameDisplayTextItem(scoreEntry.name, *currentFont, 24);
             nameDisplayTextItem.setFillColor(itemTextColor);
-            std::string currentDisplayNameStr = scores[i].first;
+            std::string currentDisplayNameStr = scoreEntry.name;
             float nameColumnActualWidth = headers[2].second - headers[1].second - 50.f;
             nameDisplayTextItem.setString(currentDisplayNameStr);
             while(nameDisplayTextItem.getLocalBounds().width > nameColumnActualWidth && currentDisplayNameStr.length() > 5){
                 currentDisplayNameStr.pop_back();
                 nameDisplayTextItem.setString(currentDisplayNameStr + "..");
             }
-            if(currentDisplayNameStr.empty() && !scores[i].first.empty()){
-                nameDisplayTextItem.setString(scores[i].first.substr(0, std::max(0, (int)nameColumnActualWidth / 12)) + "..");
+            if(currentDisplayNameStr.empty() && !scoreEntry.name.empty()){
+                nameDisplayTextItem.setString(scoreEntry.name.substr(0, std::max(0, (int)nameColumnActualWidth / 12)) + "..");
             }
             nameDisplayTextItem.setPosition(sf::Vector2f(headers[1].second, yPos));
             window.draw(nameDisplayTextItem);
 
-            sf::Text scoreValDisplayText(fmt::format("{}", scores[i].second), *currentFont, 24);
+            sf::Text scoreValDisplayText(fmt::format("{}", scoreEntry.score), *currentFont, 24);
             scoreValDisplayText.setFillColor(itemTextColor);
             sf::FloatRect currentScoreTextLocalBounds = scoreValDisplayText.getLocalBounds();
             scoreValDisplayText.setPosition(sf::Vector2f(headers[2].second + 100.f - currentScoreTextLocalBounds.width, yPos));
@@ -966,22 +1049,23 @@ void UIManager::renderHighScores() {
             commonNavY = GameConstants::WINDOW_HEIGHT - navButtonHeight - 10.f;
         }
 
-        if (highScoresNavigationButtons.size() > 1) {
-            Button& graphBtnRef = highScoresNavigationButtons[1];
-            float backBtnNavWidth = backBtnRef.getGlobalBounds().width;
-            float graphBtnNavWidth = graphBtnRef.getGlobalBounds().width;
-            float navSpacing = 20.f;
-            float totalNavLayoutWidth = backBtnNavWidth + graphBtnNavWidth + navSpacing;
-            float navLayoutStartX = (GameConstants::WINDOW_WIDTH - totalNavLayoutWidth) / 2.f;
-
-            sf::FloatRect backBtnTextLocalBounds = backBtnRef.text.getLocalBounds();
-            backBtnRef.setPosition(sf::Vector2f(navLayoutStartX + backBtnNavWidth/2.f - backBtnTextLocalBounds.width/2.f, commonNavY));
+        float navSpacing = 20.f;
+        float totalNavLayoutWidth = navSpacing * (highScoresNavigationButtons.size() - 1);
+        for (const auto& button : highScoresNavigationButtons) totalNavLayoutWidth += button.getGlobalBounds().width;
+        float navButtonX = (GameConstants::WINDOW_WIDTH - totalNavLayoutWidth) / 2.f;
+        for (auto& button : highScoresNavigationButtons) {
+            float navButtonWidth = button.getGlobalBounds().width;
+            sf::FloatRect navButtonTextLocalBounds = button.text.getLocalBounds();
+            button.setPosition(sf::Vector2f(navButtonX + navButtonWidth/2.f - navButtonTextLocalBounds.width/2.f, commonNavY));
+            navButtonX += navButtonWidth + navSpacing;
+        }
 
-            sf::FloatRect graphBtnTextLocalBounds = graphBtnRef.text.getLocalBounds();
-            graphBtnRef.setPosition(sf::Vector2f(navLayoutStartX + backBtnNavWidth + navSpacing + graphBtnNavWidth/2.f - graphBtnTextLocalBounds.width/2.f, commonNavY));
-        } else {
-            sf::FloatRect backBtnTextLocalBounds = backBtnRef.text.getLocalBounds();
-            backBtnRef.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH/2.f - backBtnTextLocalBounds.width/2.f, commonNavY));
+        if (!exportMessage.empty()) {
+            sf::Text exportMessageText(exportMessage, *currentFont, 18);
+            exportMessageText.setFillColor(sf::Color(180,180,180));
+            sf::FloatRect exportMessageLocalBounds = exportMessageText.getLocalBounds();
+            exportMessageText.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH/2.f - exportMessageLocalBounds.width/2.f, commonNavY - 28.f));
+            window.draw(exportMessageText);
         }
     }
     for(const auto& button : highScoresNavigationButtons) button.draw(window);
@@ -1135,7 +1219,7 @@ void UIManager::renderFontSelection() {
     }
     fontScreenBackButton.draw(window);
 
-    sf::Text screenHint("Drop .ttf/.otf in 'fonts' folder and restart.", *uiFont, 20);
+    sf::Text screenHint("Drop .ttf/.otf in 'fonts' folder; they load automatically.", *uiFont, 20);
     screenHint.setFillColor(sf::Color(150,150,150));
     sf::FloatRect screenHintLocalBounds = screenHint.getLocalBounds();
     screenHint.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - screenHintLocalBounds.width / 2.0f, GameConstants::WINDOW_HEIGHT - 50.0f));
@@ -1263,12 +1347,39 @@ void UIManager::renderWordSetSelection() {
         setItemNameText.setPosition(sf::Vector2f(localScreenPanel.getPosition().x + 50.f, yPos));
 
         std::string sampleWordsString;
-        for(size_t k=0; k < std::min((size_t)3, wordSet.size()); ++k) {
+        auto streamedSample = wordDBManager.isStreamingSet(setIdx) ? wordDBManager.getStreamingSource(setIdx)->getSnapshot() : nullptr;
+        const auto& sampleSource = streamedSample ? *streamedSample : wordSet;
+        for(size_t k=0; k < std::min((size_t)3, sampleSource.size()); ++k) {
             if (k > 0) sampleWordsString += ", ";
-            sampleWordsString += wordSet[k];
+            sampleWordsString += sampleSource[k];
             if (sampleWordsString.length() > 35) { sampleWordsString += "..."; break;}
         }
-        if (wordSet.empty()) sampleWordsString = "[Empty Set]";
+        if (wordDBManager.isStreamingSet(setIdx)) {
+            sampleWordsString = sampleSource.empty() ? "[Streaming, scanning...]" : "[Streaming] " + sampleWordsString;
+        } else if (wordSet.empty()) {
+            sampleWordsString = "[Empty Set]";
+        }
+
+        // Cleaning statistics and a small word-length histogram between the name and sample columns.
+        if (const WordSetStats* stats = wordDBManager.getWordSetStats(setIdx)) {
+            sf::Text statsText(fmt::format("{} words / {} read", stats->uniqueWords, stats->tokensRead), *uiFont, 16);
+            statsText.setFillColor(sf::Color(170, 170, 190));
+            statsText.setPosition(sf::Vector2f(localScreenPanel.getPosition().x + 380.f, yPos + 4.f));
+            window.draw(statsText);
+
+            size_t tallestBucket = *std::max_element(stats->lengthHistogram.begin(), stats->lengthHistogram.end());
+            const float histogramX = localScreenPanel.getPosition().x + 620.f;
+            const float histogramHeight = 28.f;
+            const float barWidth = 5.f;
+            for (size_t bucket = 0; tallestBucket > 0 && bucket < stats->lengthHistogram.size(); ++bucket) {
+                float barHeight = histogramHeight * static_cast<float>(stats->lengthHistogram[bucket]) / static_cast<float>(tallestBucket);
+                if (barHeight <= 0.f) continue;
+                sf::RectangleShape bar(sf::Vector2f(barWidth - 1.f, barHeight));
+                bar.setFillColor(sf::Color(110, 160, 220));
+                bar.setPosition(sf::Vector2f(histogramX + bucket * barWidth, yPos + histogramHeight - barHeight + 2.f));
+                window.draw(bar);
+            }
+        }
 
         sf::Text setSampleDisplayText(sampleWordsString, *uiFont, 20);
         setSampleDisplayText.setPosition(sf::Vector2f(localScreenPanel.getPosition().x + localScreenPanel.getSize().x / 2.f + 20.f, yPos));
@@ -1305,12 +1416,12 @@ void UIManager::renderGraphView() {
     localScreenPanel.setOutlineThickness(3);
     localScreenPanel.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH * (1.f - 0.9f) / 2.f, 100.0f));
 
-    if (selectedScoreIndex >= 0 && static_cast<size_t>(selectedScoreIndex) < highScoreManager.getHighScores().size()) {
+    if (selectedScoreIndex >= 0 && static_cast<size_t>(selectedScoreIndex) < highScoreManager.getHighScoreCount(selectedPartition)) {
         window.draw(localScreenPanel);
-        const auto& scoreEntry = highScoreManager.getHighScores()[selectedScoreIndex];
-        const auto& history = highScoreManager.getScoreHistory(selectedScoreIndex);
+        const Leaderboard::Entry& scoreEntry = highScoreManager.getHighScore(selectedPartition, selectedScoreIndex);
+        const auto& history = highScoreManager.getScoreHistory(selectedPartition, selectedScoreIndex);
 
-        sf::Text playerInfoText(fmt::format("Player: {}  |  Final Score: {}", scoreEntry.first, scoreEntry.second), *uiFont, 28);
+        sf::Text playerInfoText(fmt::format("Player: {}  |  Final Score: {}", scoreEntry.name, scoreEntry.score), *uiFont, 28);
         playerInfoText.setFillColor(sf::Color(200,200,255));
         sf::FloatRect playerInfoLocalBounds = playerInfoText.getLocalBounds();
         playerInfoText.setPosition(sf::Vector2f(localScreenPanel.getPosition().x + localScreenPanel.getSize().x / 2.f - playerInfoLocalBounds.width / 2.f,
@@ -1324,7 +1435,11 @@ void UIManager::renderGraphView() {
                     localScreenPanel.getSize().x - 120.0f,
                     localScreenPanel.getSize().y * 0.5f - 80.0f
             );
-            renderScoreGraph(std::deque<ScorePoint>(history.begin(), history.end()), graphDisplayArea, uiFont, "Score Over Time");
+            graphBuckets.clear();
+            for (const ScorePoint& point : history) {
+                graphBuckets.push_back(ScoreBucket{point.timeStamp, point.timeStamp, point.score, point.score, point.score, 1, static_cast<double>(point.score)});
+            }
+            renderScoreGraph(graphBuckets, graphDisplayArea, uiFont, "Score Over Time");
 
             sf::Text keyMetricsTitle("Key Metrics:", *uiFont, 24);
             keyMetricsTitle.setFillColor(sf::Color::Cyan);
@@ -1402,4 +1517,131 @@ void UIManager::renderGraphView() {
         ));
     }
     graphViewBackButton.draw(window);
-}
\ No newline at end of file
+}
+
+void UIManager::renderStatsView() {
+    auto uiFont = game.getCurrentFont();
+    if(!uiFont) uiFont = fontManager.getDefaultFont();
+    const KeystrokeAnalytics& analytics = game.getKeystrokeAnalytics();
+    sf::RectangleShape bg(sf::Vector2f(GameConstants::WINDOW_WIDTH, GameConstants::WINDOW_HEIGHT));
+    bg.setFillColor(sf::Color(40, 30, 30)); window.draw(bg);
+
+    sf::Text screenTitle("Typing Statistics", *uiFont, 56);
+    screenTitle.setFillColor(sf::Color::Yellow);
+    sf::FloatRect screenTitleLocalBounds = screenTitle.getLocalBounds();
+    screenTitle.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH / 2.0f - screenTitleLocalBounds.width / 2.0f, 30.0f));
+    window.draw(screenTitle);
+
+    sf::RectangleShape localScreenPanel;
+    localScreenPanel.setSize(sf::Vector2f(GameConstants::WINDOW_WIDTH * 0.9f, GameConstants::WINDOW_HEIGHT * 0.75f));
+    localScreenPanel.setFillColor(sf::Color(25, 25, 35, 230));
+    localScreenPanel.setOutlineColor(sf::Color(100, 100, 120, 150));
+    localScreenPanel.setOutlineThickness(3);
+    localScreenPanel.setPosition(sf::Vector2f(GameConstants::WINDOW_WIDTH * (1.f - 0.9f) / 2.f, 100.0f));
+    window.draw(localScreenPanel);
+    const float panelLeft = localScreenPanel.getPosition().x;
+    const float panelTop = localScreenPanel.getPosition().y;
+    const float panelWidth = localScreenPanel.getSize().x;
+
+    const LatencyStats& overall = analytics.getOverall();
+    if (overall.keys == 0) {
+        sf::Text noData("No keystrokes recorded yet.", *uiFont, 24);
+        sf::FloatRect noDataLocalBounds = noData.getLocalBounds();
+        noData.setPosition(sf::Vector2f(panelLeft + panelWidth / 2.f - noDataLocalBounds.width / 2.f,
+                                        panelTop + localScreenPanel.getSize().y / 2.0f));
+        window.draw(noData);
+    } else {
+        const auto& runs = analytics.getRuns();
+        float trend = analytics.getTrendMsPerRun(GameConstants::STATS_TREND_RUNS);
+        sf::Text summaryText(fmt::format("Keys: {}  |  Mean: {:.0f} ms  |  Median: {:.0f} ms  |  Errors: {:.1f}%  |  Runs: {}  |  Trend: {}{:.1f} ms/run",
+                                         overall.keys, overall.meanMs(), overall.percentileMs(0.5f), overall.errorRate() * 100.f,
+                                         runs.size(), trend >= 0.f ? "+" : "", trend), *uiFont, 22);
+        summaryText.setFillColor(sf::Color(200,200,255));
+        sf::FloatRect summaryLocalBounds = summaryText.getLocalBounds();
+        summaryText.setPosition(sf::Vector2f(panelLeft + panelWidth / 2.f - summaryLocalBounds.width / 2.f, panelTop + 20.f));
+        window.draw(summaryText);
+
+        // Slowest characters, bigrams and trigrams side by side.
+        const std::array<std::string, 3> columnTitles = {"Slowest Keys", "Slowest Bigrams", "Slowest Trigrams"};
+        const float columnWidth = (panelWidth - 80.f) / 3.f;
+        for (size_t column = 0; column < 3; ++column) {
+            float columnX = panelLeft + 40.f + column * columnWidth;
+            sf::Text columnTitle(columnTitles[column], *uiFont, 24);
+            columnTitle.setFillColor(sf::Color::Cyan);
+            columnTitle.setPosition(sf::Vector2f(columnX, panelTop + 70.f));
+            window.draw(columnTitle);
+
+            sf::Text header("keys   median    p90    err    n", *uiFont, 16);
+            header.setFillColor(sf::Color(150,150,150));
+            header.setPosition(sf::Vector2f(columnX, panelTop + 105.f));
+            window.draw(header);
+
+            const auto& ranked = slowestKeys[column];
+            if (ranked.empty()) {
+                sf::Text notEnough(fmt::format("Not enough samples (min {})", GameConstants::STATS_MIN_SAMPLES), *uiFont, 18);
+                notEnough.setFillColor(sf::Color(150,150,150));
+                notEnough.setPosition(sf::Vector2f(columnX, panelTop + 130.f));
+                window.draw(notEnough);
+            }
+            for (size_t row = 0; row < ranked.size(); ++row) {
+                const LatencyStats& stats = ranked[row].stats;
+                std::string keys = ranked[row].keys;
+                std::replace(keys.begin(), keys.end(), ' ', '_');
+                sf::Text rowText(fmt::format("{:<5} {:>5.0f} ms {:>5.0f} ms {:>5.1f}% {:>5}", keys, stats.percentileMs(0.5f),
+                                             stats.percentileMs(0.9f), stats.errorRate() * 100.f, stats.samples), *uiFont, 18);
+                rowText.setFillColor(row == 0 ? sf::Color(255, 140, 140) : sf::Color::White);
+                rowText.setPosition(sf::Vector2f(columnX, panelTop + 130.f + row * 24.f));
+                window.draw(rowText);
+            }
+        }
+
+        // Mean latency of the most recent runs.
+        sf::FloatRect chartArea(panelLeft + 60.f, panelTop + 390.f, panelWidth - 120.f, localScreenPanel.getSize().y - 470.f);
+        sf::RectangleShape chartBg(sf::Vector2f(chartArea.width, chartArea.height));
+        chartBg.setPosition(chartArea.left, chartArea.top);
+        chartBg.setFillColor(sf::Color(40, 40, 50));
+        chartBg.setOutlineColor(sf::Color(100, 100, 120));
+        chartBg.setOutlineThickness(1);
+        window.draw(chartBg);
+
+        sf::Text chartTitle("Mean Latency per Run", *uiFont, 18);
+        chartTitle.setFillColor(sf::Color(180,180,180));
+        chartTitle.setPosition(sf::Vector2f(chartArea.left, chartArea.top - 26.f));
+        window.draw(chartTitle);
+
+        std::vector<float> runMeans;
+        size_t firstRun = runs.size() > GameConstants::STATS_CHART_RUNS ? runs.size() - GameConstants::STATS_CHART_RUNS : 0;
+        for (size_t i = firstRun; i < runs.size(); ++i) {
+            if (runs[i].samples > 0) runMeans.push_back(runs[i].meanMs());
+        }
+        if (runMeans.size() >= 2) {
+            float maxMean = *std::max_element(runMeans.begin(), runMeans.end());
+            if (maxMean < 1.f) maxMean = 1.f;
+            sf::VertexArray line(sf::LineStrip, runMeans.size());
+            for (size_t i = 0; i < runMeans.size(); ++i) {
+                float x = chartArea.left + chartArea.width * i / (runMeans.size() - 1);
+                float y = chartArea.top + chartArea.height * (1.f - runMeans[i] / (maxMean * 1.1f));
+                line[i].position = sf::Vector2f(x, y);
+                line[i].color = sf::Color(100, 200, 255);
+            }
+            window.draw(line);
+
+            sf::Text maxLabel(fmt::format("{:.0f} ms", maxMean), *uiFont, 14);
+            maxLabel.setFillColor(sf::Color(150,150,150));
+            maxLabel.setPosition(sf::Vector2f(chartArea.left + 5.f, chartArea.top + 5.f));
+            window.draw(maxLabel);
+        } else {
+            sf::Text fewRuns("Finish a few runs to see the trend.", *uiFont, 18);
+            fewRuns.setFillColor(sf::Color(150,150,150));
+            fewRuns.setPosition(sf::Vector2f(chartArea.left + 20.f, chartArea.top + chartArea.height / 2.f - 10.f));
+            window.draw(fewRuns);
+        }
+    }
+
+    sf::FloatRect svBackButtonGlobalBounds = statsViewBackButton.getGlobalBounds();
+    statsViewBackButton.setPosition(sf::Vector2f(
+            panelLeft + panelWidth / 2.f - svBackButtonGlobalBounds.width / 2.f,
+            panelTop + localScreenPanel.getSize().y - svBackButtonGlobalBounds.height - 15.f
+    ));
+    statsViewBackButton.draw(window);
+}
@@ -0,0 +1,144 @@
+#include "../include/WeaknessTrainer.h"
+#include "../include/Constants.h"
+#include <fmt/core.h>
+#include <cctype>
+
+namespace {
+    constexpr double RENORMALIZE_THRESHOLD = 1e6;
+}
+
+WeaknessTrainer::WeaknessTrainer() : decayIncrement(1.0) {
+    featureSampler.reset(FEATURE_COUNT);
+}
+
+int WeaknessTrainer::featureForChar(char c) {
+    int lower = std::tolower(static_cast<unsigned char>(c));
+    if (lower < 'a' || lower > 'z') return -1;
+    return lower - 'a';
+}
+
+int WeaknessTrainer::featureForBigram(char a, char b) {
+    int first = featureForChar(a);
+    int second = featureForChar(b);
+    if (first < 0 || second < 0) return -1;
+    return LETTER_COUNT + first * LETTER_COUNT + second;
+}
+
+void WeaknessTrainer::rebuildIndex(const std::vector<const std::vector<std::string>*>& sources) {
+    words.clear();
+    wordLookup.clear();
+    size_t totalWords = 0;
+    for (const auto* source : sources) {
+        if (source) totalWords += source->size();
+    }
+    words.reserve(totalWords);
+    for (const auto* source : sources) {
+        if (!source) continue;
+        words.insert(words.end(), source->begin(), source->end());
+    }
+    wordLookup.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        wordLookup.emplace(words[i], static_cast<uint32_t>(i));
+    }
+
+    // Two passes over the pool: count distinct features per word, then scatter word ids.
+    // 'lastSeen' deduplicates repeated features within one word without a per-word set.
+    std::vector<uint32_t> lastSeen(FEATURE_COUNT, UINT32_MAX);
+    std::vector<uint32_t> counts(FEATURE_COUNT + 1, 0);
+    auto forEachFeature = [&](uint32_t wordIndex, auto&& visit) {
+        const std::string& w = words[wordIndex];
+        for (size_t i = 0; i < w.size(); ++i) {
+            int f = featureForChar(w[i]);
+            if (f >= 0 && lastSeen[f] != wordIndex) { lastSeen[f] = wordIndex; visit(f); }
+            if (i > 0) {
+                int b = featureForBigram(w[i - 1], w[i]);
+                if (b >= 0 && lastSeen[b] != wordIndex) { lastSeen[b] = wordIndex; visit(b); }
+            }
+        }
+    };
+
+    for (uint32_t i = 0; i < words.size(); ++i) {
+        forEachFeature(i, [&](int f) { counts[f + 1]++; });
+    }
+    postingOffsets.assign(FEATURE_COUNT + 1, 0);
+    for (int f = 0; f < FEATURE_COUNT; ++f) {
+        postingOffsets[f + 1] = postingOffsets[f] + counts[f + 1];
+    }
+    postingWords.assign(postingOffsets[FEATURE_COUNT], 0);
+    std::vector<uint32_t> cursor(postingOffsets.begin(), postingOffsets.end() - 1);
+    std::fill(lastSeen.begin(), lastSeen.end(), UINT32_MAX);
+    for (uint32_t i = 0; i < words.size(); ++i) {
+        forEachFeature(i, [&](int f) { postingWords[cursor[f]++] = i; });
+    }
+
+    wordSampler.reset(words.size());
+    fmt::print("WeaknessTrainer: Indexed {} words ({} postings).\n", words.size(), postingWords.size());
+}
+
+void WeaknessTrainer::recordKeystroke(const std::string& wordText, char expected, char previous, bool mistake) {
+    advanceDecay();
+    if (!mistake) return;
+
+    bumpFeature(featureForChar(expected));
+    if (previous != 0) {
+        bumpFeature(featureForBigram(previous, expected));
+    }
+
+    auto it = wordLookup.find(wordText);
+    if (it != wordLookup.end()) {
+        wordSampler.add(it->second, decayIncrement);
+    }
+}
+
+void WeaknessTrainer::bumpFeature(int feature) {
+    if (feature < 0) return;
+    // Features without any word in the pool can never be drilled; keep them out of the sampler.
+    if (!postingOffsets.empty() && postingOffsets[feature] == postingOffsets[feature + 1]) return;
+    featureSampler.add(static_cast<size_t>(feature), decayIncrement);
+}
+
+void WeaknessTrainer::advanceDecay() {
+    decayIncrement /= GameConstants::TRAINING_WEIGHT_DECAY;
+    if (decayIncrement > RENORMALIZE_THRESHOLD) {
+        featureSampler.scale(1.0 / decayIncrement);
+        wordSampler.scale(1.0 / decayIncrement);
+        decayIncrement = 1.0;
+    }
+}
+
+bool WeaknessTrainer::hasWeaknesses() const {
+    // A single fresh mistake carries weight 'decayIncrement'; compare in those units.
+    return featureSampler.total() + wordSampler.total() >= decayIncrement * 0.5;
+}
+
+const std::string* WeaknessTrainer::sampleWord(std::mt19937& rng) const {
+    if (words.empty()) return nullptr;
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<size_t> anyWord(0, words.size() - 1);
+
+    if (!hasWeaknesses() || unit(rng) >= GameConstants::TRAINING_DRILL_PROBABILITY) {
+        return &words[anyWord(rng)];
+    }
+
+    double featureMass = featureSampler.total();
+    double wordMass = wordSampler.total();
+    double pick = unit(rng) * (featureMass + wordMass);
+
+    if (pick < featureMass) {
+        size_t feature = featureSampler.sample(pick);
+        uint32_t begin = postingOffsets[feature];
+        uint32_t end = postingOffsets[feature + 1];
+        if (end > begin) {
+            std::uniform_int_distribution<uint32_t> inList(begin, end - 1);
+            return &words[postingWords[inList(rng)]];
+        }
+    } else if (wordMass > 0.0) {
+        return &words[wordSampler.sample(pick - featureMass)];
+    }
+    return &words[anyWord(rng)];
+}
+
+size_t WeaknessTrainer::getIndexedWordCount() const {
+    return words.size();
+}
@@ -0,0 +1,85 @@
+#include "../include/WeightedSampler.h"
+#include <algorithm>
+
+WeightedSampler::WeightedSampler() : highestPowerOfTwo(0), totalWeight(0.0) {}
+
+void WeightedSampler::reset(size_t count) {
+    weights.assign(count, 0.0);
+    tree.assign(count + 1, 0.0);
+    totalWeight = 0.0;
+    highestPowerOfTwo = 1;
+    while (highestPowerOfTwo <= count) highestPowerOfTwo <<= 1;
+    highestPowerOfTwo >>= 1;
+}
+
+void WeightedSampler::assign(const std::vector<double>& newWeights) {
+    reset(newWeights.size());
+    for (size_t i = 0; i < newWeights.size(); ++i) {
+        weights[i] = std::max(0.0, newWeights[i]);
+    }
+    rebuildTree();
+}
+
+void WeightedSampler::add(size_t index, double delta) {
+    if (index >= weights.size()) return;
+    set(index, weights[index] + delta);
+}
+
+void WeightedSampler::set(size_t index, double weight) {
+    if (index >= weights.size()) return;
+    weight = std::max(0.0, weight);
+    double delta = weight - weights[index];
+    if (delta == 0.0) return;
+    weights[index] = weight;
+    totalWeight += delta;
+    for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1)) {
+        tree[i] += delta;
+    }
+}
+
+void WeightedSampler::scale(double factor) {
+    for (auto& w : weights) w *= factor;
+    rebuildTree();
+}
+
+double WeightedSampler::weight(size_t index) const {
+    return index < weights.size() ? weights[index] : 0.0;
+}
+
+double WeightedSampler::total() const {
+    return std::max(0.0, totalWeight);
+}
+
+size_t WeightedSampler::size() const {
+    return weights.size();
+}
+
+size_t WeightedSampler::sample(double target) const {
+    if (weights.empty()) return 0;
+
+    // Binary lifting: descend the implicit tree, skipping whole blocks whose sum lies below target.
+    size_t pos = 0;
+    for (size_t step = highestPowerOfTwo; step > 0; step >>= 1) {
+        size_t next = pos + step;
+        if (next < tree.size() && tree[next] <= target) {
+            pos = next;
+            target -= tree[next];
+        }
+    }
+
+    // Floating point drift can land on the very end or on an empty slot; step back to a live entry.
+    if (pos >= weights.size()) pos = weights.size() - 1;
+    while (pos > 0 && weights[pos] <= 0.0) --pos;
+    return pos;
+}
+
+void WeightedSampler::rebuildTree() {
+    std::fill(tree.begin(), tree.end(), 0.0);
+    totalWeight = 0.0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        tree[i + 1] += weights[i];
+        totalWeight += weights[i];
+        size_t parent = (i + 1) + ((i + 1) & (~(i + 1) + 1));
+        if (parent < tree.size()) tree[parent] += tree[i + 1];
+    }
+}
@@ -1,16 +1,87 @@
 #include "../include/Word.h"
 #include "../include/Constants.h"
 #include "../include/LinkedWord.h"
+#include "../include/GlyphMetrics.h"
+#include <algorithm>
+
+namespace {
+    // Makes 'shown', which holds text[shownBegin, shownEnd), hold text[begin, end). Typing moves
+    // one end of a span by one character, which costs one insertion or erasure. Returns false if
+    // the span did not change.
+    bool syncSpan(sf::String& shown, size_t& shownBegin, size_t& shownEnd, const std::string& text, size_t begin, size_t end) {
+        if (begin == shownBegin && end == shownEnd) return false;
+        if (begin != shownBegin) {
+            shown.clear();
+            shownBegin = begin;
+            shownEnd = begin;
+        }
+        if (end < shownEnd) {
+            shown.erase(end - begin, shownEnd - end);
+        }
+        for (size_t i = shownEnd; i < end; ++i) {
+            shown += sf::String(static_cast<sf::Uint32>(static_cast<unsigned char>(text[i])));
+        }
+        shownEnd = end;
+        return true;
+    }
+}
 
 Word::Word(const std::string& text, const sf::Font& font, float speed, const sf::Vector2f& position,
            unsigned int fontSize)
-        : text(text), originalText(text), speed(speed), position(position),
-          typedCorrectly(false), mistakesCount(0) {
+        : speed(speed), position(position), typedCorrectly(false), mistakesCount(0),
+          metrics(nullptr), textWidth(0.f) {
+    // Sized for the longest word up front, so the pool can reuse this word for any other.
+    this->text.reserve(GameConstants::MAX_WORD_LENGTH);
+    originalText.reserve(GameConstants::MAX_WORD_LENGTH);
+    currentInput.reserve(GameConstants::MAX_WORD_LENGTH);
+    positionMistakes.reserve(GameConstants::MAX_WORD_LENGTH);
+    prefixWidths.reserve(GameConstants::MAX_WORD_LENGTH + 1);
+    reserveTextString(sfText);
+    reserveTextString(matchedText);
+    reserveTextString(errorText);
+    matchedString = stringBuffer;
+    errorString = stringBuffer;
+    matchedText.setFillColor(GameConstants::COMPLETED_COLOR);
+    errorText.setFillColor(sf::Color(255, 80, 80));
+    reset(text, font, speed, position, fontSize);
+}
+
+void Word::reset(const std::string& newText, const sf::Font& font, float newSpeed, const sf::Vector2f& newPosition,
+                 unsigned int fontSize) {
+    // Assignments below reuse the capacity of strings, vectors and sf::Text vertex arrays,
+    // so a recycled word reinitializes without touching the heap in the common case.
+    text = newText;
+    originalText = newText;
+    currentInput.clear();
+    speed = newSpeed;
+    position = newPosition;
+    typedCorrectly = false;
+    mistakesCount = 0;
+    currentWordIndex = 0;
+    lastTypedKey = TypedKey{};
+    isActiveTypingTarget = false;
+    metrics = &GlyphMetrics::get(font, fontSize);
+    measurePrefixes();
+
     sfText.setFont(font);
     sfText.setCharacterSize(fontSize);
     sfText.setFillColor(GameConstants::DEFAULT_TEXT_COLOR);
-    sfText.setString(text);
+    setTextString(sfText, text);
     sfText.setPosition(position);
+
+    positionMistakes.assign(text.size(), 0);
+    matchedLength = 0;
+    showTypingProgress = false;
+    matchedWidth = 0.f;
+    matchedString.clear();
+    errorString.clear();
+    matchedShownEnd = errorShownBegin = errorShownEnd = 0;
+    matchedText.setString(matchedString);
+    errorText.setString(errorString);
+    matchedText.setFont(font);
+    matchedText.setCharacterSize(fontSize);
+    errorText.setFont(font);
+    errorText.setCharacterSize(fontSize);
 }
 
 bool Word::isLinked() const { return false; }
@@ -21,13 +92,16 @@ const std::vector<sf::Vector2f>& Word::getLinkPoints() const {
 }
 
 void Word::update(float deltaTime) {
-    position.x += speed * deltaTime;
-    sfText.setPosition(position);
+    setPosition(sf::Vector2f(position.x + speed * deltaTime, position.y));
     updateColorBasedOnPosition();
 }
 
 void Word::draw(sf::RenderWindow& window) const {
     window.draw(sfText);
+    if (showTypingProgress && !typedCorrectly) {
+        if (matchedLength > 0) window.draw(matchedText);
+        if (hasTypingError()) window.draw(errorText);
+    }
 }
 
 bool Word::isOutOfBoundsRight() const {
@@ -38,7 +112,7 @@ bool Word::isOutOfBoundsRight() const {
 bool Word::isOutOfBounds() const {
     // For general cleanup - word is completely off either side
     return (position.x > GameConstants::WINDOW_WIDTH) ||
-           (position.x + sfText.getLocalBounds().width < 0);
+           (position.x + textWidth < 0);
 }
 
 void Word::processInput(sf::Uint32 unicode, bool highlightTyping) {
@@ -49,39 +123,33 @@ void Word::processInput(sf::Uint32 unicode, bool highlightTyping) {
     }
 
     if (typedCorrectly) return;
+    lastTypedKey = TypedKey{};
 
     if (unicode == 8) { // Backspace
-        if (!currentInput.empty()) {
-            currentInput.pop_back();
-        }
+        popBackCurrentInput();
     } else if (unicode == 27) { // Esc
         resetTyping();
     }else if (unicode >= 32 && unicode <= 126) { // Printable ASCII
         if (currentInput.length() < text.length()) {
-            currentInput += static_cast<char>(unicode);
-        }
-    }
-
-    bool matches = true;
-    for (size_t i = 0; i < currentInput.length(); ++i) {
-        if (i >= text.length() || currentInput[i] != text[i]) {
-            matches = false;
-            break;
+            size_t typedPos = currentInput.length();
+            appendToCurrentInput(static_cast<char>(unicode));
+            lastTypedKey.expected = text[typedPos];
+            lastTypedKey.previous = typedPos > 0 ? text[typedPos - 1] : 0;
+            lastTypedKey.mistake = currentInput[typedPos] != text[typedPos];
         }
     }
 
-    if (matches) {
-        if (currentInput.length() == text.length()) {
-            typedCorrectly = true;
-        }
-    } else {
+    if (hasTypingError()) {
         mistakesCount++;
+    } else if (matchedLength == text.length()) {
+        typedCorrectly = true;
     }
 
     updateTextColor(highlightTyping);
 }
 
 void Word::updateTextColor(bool highlightTyping) {
+    showTypingProgress = highlightTyping;
     if (typedCorrectly) {
         sfText.setFillColor(GameConstants::COMPLETED_COLOR);
     } else if (isBeingTyped() && highlightTyping) {
@@ -89,11 +157,24 @@ void Word::updateTextColor(bool highlightTyping) {
     } else {
         updateColorBasedOnPosition();
     }
-    sfText.setString(text);
 }
 
 const std::string& Word::getText() const { return text; }
 
+sf::FloatRect Word::getTypingBounds() const {
+    return sf::FloatRect(position.x, position.y + metrics->getTextTop(), textWidth, metrics->getTextHeight());
+}
+
+float Word::getTextWidth() const { return textWidth; }
+
+size_t Word::getMatchedLength() const { return matchedLength; }
+
+bool Word::hasTypingError() const { return matchedLength < currentInput.length(); }
+
+int Word::getMistakesAtPosition(size_t index) const {
+    return index < positionMistakes.size() ? positionMistakes[index] : 0;
+}
+
 bool Word::isBeingTyped() const {
     return !typedCorrectly && currentInput.length() > 0;
 }
@@ -110,9 +191,22 @@ float Word::getSpeed() const { return speed; }
 
 int Word::getMistakesCount() const { return mistakesCount; }
 
+const TypedKey& Word::getLastTypedKey() const { return lastTypedKey; }
+
 void Word::setText(const std::string& newText) {
     text = newText;
-    sfText.setString(newText);
+    measurePrefixes();
+    setTextString(sfText, newText);
+    positionMistakes.assign(text.size(), 0);
+    // A new target text invalidates the incremental state; rebuild it once.
+    matchedString.clear();
+    errorString.clear();
+    matchedShownEnd = errorShownBegin = errorShownEnd = 0;
+    matchedLength = 0;
+    while (matchedLength < currentInput.length() && matchedLength < text.length() && currentInput[matchedLength] == text[matchedLength]) {
+        ++matchedLength;
+    }
+    refreshTypingOverlay();
 }
 
 const sf::Text& Word::getSfText() const { return sfText; }
@@ -128,6 +222,10 @@ void Word::setSpeed(float value) { speed = value; }
 void Word::setPosition(const sf::Vector2f& value) {
     position = value;
     sfText.setPosition(position);
+    if (!currentInput.empty()) {
+        matchedText.setPosition(position);
+        errorText.setPosition(position.x + matchedWidth, position.y);
+    }
 }
 
 size_t Word::getCurrentWordIndex() const { return currentWordIndex; }
@@ -136,11 +234,73 @@ void Word::setCurrentWordIndex(size_t value) { currentWordIndex = value; }
 
 void Word::incrementMistakesCount() { mistakesCount++; }
 
-void Word::clearCurrentInput() { currentInput.clear(); }
+void Word::clearCurrentInput() {
+    currentInput.clear();
+    matchedLength = 0;
+    refreshTypingOverlay();
+}
+
+void Word::appendToCurrentInput(char c) {
+    size_t typedPos = currentInput.length();
+    currentInput += c;
+    bool correct = typedPos < text.length() && c == text[typedPos];
+    if (correct && matchedLength == typedPos) {
+        matchedLength++;
+    } else if (!correct && typedPos < positionMistakes.size() && positionMistakes[typedPos] < 255) {
+        positionMistakes[typedPos]++;
+    }
+    refreshTypingOverlay();
+}
 
-void Word::appendToCurrentInput(char c) { currentInput += c; }
+void Word::popBackCurrentInput() {
+    if (currentInput.empty()) return;
+    currentInput.pop_back();
+    matchedLength = std::min(matchedLength, currentInput.length());
+    refreshTypingOverlay();
+}
 
-void Word::popBackCurrentInput() { if (!currentInput.empty()) currentInput.pop_back(); }
+void Word::setTextString(sf::Text& target, const std::string& value) {
+    stringBuffer.clear();
+    for (char c : value) {
+        stringBuffer += sf::String(static_cast<sf::Uint32>(static_cast<unsigned char>(c)));
+    }
+    target.setString(stringBuffer);
+}
+
+void Word::reserveTextString(sf::Text& target) {
+    static const std::string longestWord(GameConstants::MAX_WORD_LENGTH, ' ');
+    setTextString(target, longestWord);
+}
+
+void Word::measurePrefixes() {
+    // Same arithmetic as GlyphMetrics::measure, keeping every intermediate width.
+    prefixWidths.resize(text.size() + 1);
+    prefixWidths[0] = 0.f;
+    for (size_t i = 0; i < text.size(); ++i) {
+        float kerning = i > 0 ? metrics->kerning(text[i - 1], text[i]) : 0.f;
+        prefixWidths[i + 1] = prefixWidths[i] + kerning + metrics->advance(text[i]);
+    }
+    textWidth = prefixWidths.back();
+}
+
+void Word::refreshTypingOverlay() {
+    // Only the small overlay strings change; sfText keeps its geometry.
+    if (currentInput.empty()) {
+        matchedWidth = 0.f;
+        return;
+    }
+    matchedWidth = prefixWidths[matchedLength];
+    size_t matchedBegin = 0;
+    if (syncSpan(matchedString, matchedBegin, matchedShownEnd, text, 0, matchedLength)) {
+        matchedText.setString(matchedString);
+    }
+    size_t errorEnd = std::max(matchedLength, std::min(currentInput.length(), text.length()));
+    if (syncSpan(errorString, errorShownBegin, errorShownEnd, text, matchedLength, errorEnd)) {
+        errorText.setString(errorString);
+    }
+    matchedText.setPosition(position);
+    errorText.setPosition(position.x + matchedWidth, position.y);
+}
 
 void Word::updateColorBasedOnPosition() {
     if (speed > 0) {
@@ -1,35 +1,75 @@
 #include "../include/WordDatabaseManager.h"
+#include "../include/StreamingWordSource.h"
+#include "../include/DirectoryWatcher.h"
+#include "../include/MarkovWordGenerator.h"
+#include "../include/Constants.h"
 #include <fmt/core.h>
 #include <filesystem>
 #include <fstream>
-#include <algorithm> // std::find
+#include <algorithm> // std::find, std::remove_if
+#include <future>
+#include <chrono>
+#include <thread>
+#include <atomic>
 
 namespace fs = std::filesystem;
 
-WordDatabaseManager::WordDatabaseManager() : randomGenerator(std::random_device{}()) {}
+namespace {
+    const std::string noWordDrawn = "error"; // Returned when there is nothing to draw from
+}
+
+WordDatabaseManager::WordDatabaseManager() : currentSetIndex(0), randomGenerator(std::random_device{}()), usingDefaultWords(false) {
+    drawnWord.reserve(GameConstants::MAX_WORD_LENGTH);
+}
+
+WordDatabaseManager::~WordDatabaseManager() = default;
 
 void WordDatabaseManager::loadWordSets(const std::string& dictionaryDirectory) {
     wordSets.clear();
     wordSetNames.clear();
-    currentWordDatabase.clear();
+    streamingSources.clear();
+    wordSetStats.clear();
+    generators.clear();
+    currentSetIndex = 0;
 
     try {
         if (fs::exists(dictionaryDirectory) && fs::is_directory(dictionaryDirectory)) {
+            std::vector<fs::path> files;
             for (const auto& entry : fs::directory_iterator(dictionaryDirectory)) {
                 if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                    std::vector<std::string> words;
-                    std::ifstream file(entry.path());
-                    if (file.is_open()) {
-                        std::string word;
-                        while (file >> word) {
-                            words.push_back(word);
-                        }
-                        if (!words.empty()) {
-                            wordSets.push_back(words);
-                            wordSetNames.push_back(entry.path().filename().string());
-                            fmt::print("Loaded word set: {}\n", entry.path().filename().string());
-                        }
-                    }
+                    files.push_back(entry.path());
+                }
+            }
+
+            // Read and clean files in parallel; results are collected in directory order.
+            std::vector<PendingWordSetUpdate> loaded(files.size());
+            std::atomic<size_t> nextFile(0);
+            auto loadWorker = [&]() {
+                for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+                    loaded[i].removed = !readWordSetFile(files[i].string(), loaded[i]);
+                }
+            };
+            size_t workerCount = std::min<size_t>(files.size(), std::max(1u, std::thread::hardware_concurrency()));
+            std::vector<std::future<void>> workers;
+            for (size_t w = 1; w < workerCount; ++w) {
+                workers.push_back(std::async(std::launch::async, loadWorker));
+            }
+            loadWorker();
+            for (auto& worker : workers) worker.get();
+
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (loaded[i].removed) continue;
+                const WordSetStats& stats = loaded[i].stats;
+                wordSets.push_back(std::move(loaded[i].words));
+                wordSetNames.push_back(files[i].filename().string());
+                streamingSources.push_back(std::move(loaded[i].stream));
+                wordSetStats.push_back(stats);
+                generators.push_back(std::move(loaded[i].generator));
+                if (streamingSources.back()) {
+                    fmt::print("Loaded word set: {}\n", wordSetNames.back());
+                } else {
+                    fmt::print("Loaded word set: {} ({} words; dropped {} duplicate, {} invalid, {} too long)\n",
+                               wordSetNames.back(), stats.uniqueWords, stats.duplicatesRemoved, stats.invalidRemoved, stats.tooLongRemoved);
                 }
             }
         } else {
@@ -40,17 +80,200 @@ void WordDatabaseManager::loadWordSets(const std::string& dictionaryDirectory) {
         fmt::print(stderr, "Error loading word sets from '{}': {}\n", dictionaryDirectory, e.what());
     }
 
+    usingDefaultWords = false;
     if (wordSets.empty()) {
-        // Default words if no files found or all files were empty
-        currentWordDatabase = {"hello", "world", "game", "typing", "monkey"};
-        wordSets.push_back(currentWordDatabase);
-        wordSetNames.push_back("default.txt");
+        useDefaultWords();
         fmt::print("No word sets found or all were empty. Using default words.\n");
-    } else {
-        currentWordDatabase = wordSets[0]; // Default to the first loaded set
     }
 }
 
+void WordDatabaseManager::useDefaultWords() {
+    // Default words if no files found or all files were empty
+    std::vector<std::string> words = {"hello", "world", "game", "typing", "monkey"};
+    WordSetStats stats;
+    stats.tokensRead = words.size();
+    WordListCleaner::cleanWords(words, stats);
+    wordSets.push_back(std::move(words));
+    wordSetNames.push_back("default.txt");
+    streamingSources.push_back(nullptr);
+    wordSetStats.push_back(stats);
+    generators.push_back(nullptr);
+    currentSetIndex = wordSets.size() - 1;
+    usingDefaultWords = true;
+}
+
+bool WordDatabaseManager::readWordSetFile(const std::string& path, PendingWordSetUpdate& result) {
+    std::error_code ec;
+    auto fileSize = fs::file_size(path, ec);
+    if (ec) return false;
+
+    if (fileSize >= GameConstants::STREAMING_DICTIONARY_THRESHOLD_BYTES) {
+        result.stream = std::make_unique<StreamingWordSource>(path, GameConstants::STREAMING_RESERVOIR_SIZE);
+        result.stream->start();
+        fmt::print("Streaming word set: {} ({} MB)\n", fs::path(path).filename().string(), fileSize / (1024 * 1024));
+        return true;
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::string word;
+    while (file >> word) {
+        result.words.push_back(std::move(word));
+    }
+    result.stats.tokensRead = result.words.size();
+    WordListCleaner::cleanWords(result.words, result.stats);
+    if (result.words.empty()) return false;
+
+    result.generator = loadOrTrainGenerator(path, result.words);
+    return true;
+}
+
+std::unique_ptr<MarkovWordGenerator> WordDatabaseManager::loadOrTrainGenerator(const std::string& dictionaryPath, const std::vector<std::string>& words) {
+    if (words.size() < GameConstants::MARKOV_MIN_TRAINING_WORDS) return nullptr;
+
+    // FNV-1a over the cleaned words: the cached model is reused only for identical contents.
+    uint64_t stamp = 14695981039346656037ull;
+    for (const auto& word : words) {
+        for (char c : word) { stamp = (stamp ^ static_cast<unsigned char>(c)) * 1099511628211ull; }
+        stamp = (stamp ^ 0xFFu) * 1099511628211ull;
+    }
+
+    std::string modelPath = fs::path(dictionaryPath).replace_extension(".markov").string();
+    auto generator = std::make_unique<MarkovWordGenerator>();
+    if (generator->load(modelPath, stamp)) {
+        return generator;
+    }
+    if (!generator->train(words)) return nullptr;
+    if (!generator->save(modelPath, stamp)) {
+        fmt::print(stderr, "Could not save word model '{}'.\n", modelPath);
+    }
+    return generator;
+}
+
+void WordDatabaseManager::startWatching(const std::string& dictionaryDirectory) {
+    if (watcher) return;
+    watchedDirectory = dictionaryDirectory;
+    watcher = std::make_unique<DirectoryWatcher>(dictionaryDirectory, [this](const std::string& fileName, bool removed) {
+        onDictionaryFileChanged(fileName, removed);
+    });
+    watcher->start();
+}
+
+void WordDatabaseManager::onDictionaryFileChanged(const std::string& fileName, bool removed) {
+    // Runs on the watcher thread: do the parsing here, publish the finished set under the lock.
+    if (fs::path(fileName).extension() != ".txt") return;
+
+    PendingWordSetUpdate update;
+    update.name = fileName;
+    update.removed = removed;
+    if (!removed) {
+        if (!readWordSetFile((fs::path(watchedDirectory) / fileName).string(), update)) {
+            update.removed = true; // Emptied or unreadable files drop out of the list
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingUpdates.push_back(std::move(update));
+}
+
+bool WordDatabaseManager::applyPendingUpdates(std::vector<std::ptrdiff_t>& indexRemap) {
+    indexRemap.clear();
+    std::vector<PendingWordSetUpdate> updates;
+    {
+        std::unique_lock<std::mutex> lock(pendingMutex, std::try_to_lock);
+        if (!lock.owns_lock() || pendingUpdates.empty()) return false;
+        updates.swap(pendingUpdates);
+    }
+
+    // Replaced and removed sets are destroyed on a background thread: freeing a large set takes a
+    // while, and destroying a streaming source joins its scanner.
+    RetiredWordSets retired;
+    std::vector<bool> removedSets(wordSets.size(), false);
+    for (auto& update : updates) {
+        auto it = std::find(wordSetNames.begin(), wordSetNames.end(), update.name);
+        size_t index = static_cast<size_t>(std::distance(wordSetNames.begin(), it));
+        if (update.removed) {
+            if (it != wordSetNames.end()) {
+                removedSets[index] = true;
+                fmt::print("Word set removed: {}\n", update.name);
+            }
+            continue;
+        }
+
+        if (it != wordSetNames.end()) {
+            // Words already on screen own their text, so replacing the set under them is safe.
+            wordSets[index].swap(update.words);
+            retired.words.push_back(std::move(update.words));
+            retired.streams.push_back(std::move(streamingSources[index]));
+            streamingSources[index] = std::move(update.stream);
+            wordSetStats[index] = update.stats;
+            retired.generators.push_back(std::move(generators[index]));
+            generators[index] = std::move(update.generator);
+            removedSets[index] = false;
+            fmt::print("Word set reloaded: {}\n", update.name);
+        } else {
+            wordSets.push_back(std::move(update.words));
+            wordSetNames.push_back(update.name);
+            streamingSources.push_back(std::move(update.stream));
+            wordSetStats.push_back(update.stats);
+            generators.push_back(std::move(update.generator));
+            removedSets.push_back(false);
+            fmt::print("Word set added: {}\n", update.name);
+        }
+    }
+
+    // A real dictionary replaces the built-in fallback set.
+    if (usingDefaultWords && wordSets.size() > 1) {
+        auto it = std::find(wordSetNames.begin(), wordSetNames.end(), "default.txt");
+        if (it != wordSetNames.end()) removedSets[std::distance(wordSetNames.begin(), it)] = true;
+        usingDefaultWords = false;
+    }
+
+    if (std::find(removedSets.begin(), removedSets.end(), true) != removedSets.end()) {
+        indexRemap.assign(removedSets.size(), -1);
+        size_t writeIndex = 0;
+        for (size_t readIndex = 0; readIndex < removedSets.size(); ++readIndex) {
+            if (removedSets[readIndex]) {
+                retired.words.push_back(std::move(wordSets[readIndex]));
+                retired.streams.push_back(std::move(streamingSources[readIndex]));
+                retired.generators.push_back(std::move(generators[readIndex]));
+                continue;
+            }
+            indexRemap[readIndex] = static_cast<std::ptrdiff_t>(writeIndex);
+            if (writeIndex != readIndex) {
+                wordSets[writeIndex] = std::move(wordSets[readIndex]);
+                wordSetNames[writeIndex] = std::move(wordSetNames[readIndex]);
+                streamingSources[writeIndex] = std::move(streamingSources[readIndex]);
+                wordSetStats[writeIndex] = wordSetStats[readIndex];
+                generators[writeIndex] = std::move(generators[readIndex]);
+            }
+            ++writeIndex;
+        }
+        wordSets.resize(writeIndex);
+        wordSetNames.resize(writeIndex);
+        streamingSources.resize(writeIndex);
+        wordSetStats.resize(writeIndex);
+        generators.resize(writeIndex);
+
+        if (currentSetIndex < indexRemap.size() && indexRemap[currentSetIndex] >= 0) {
+            currentSetIndex = static_cast<size_t>(indexRemap[currentSetIndex]);
+        } else {
+            currentSetIndex = 0;
+        }
+        if (wordSets.empty()) {
+            useDefaultWords();
+        }
+    }
+
+    retirements.erase(std::remove_if(retirements.begin(), retirements.end(), [](const std::future<void>& retirement) {
+        return retirement.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), retirements.end());
+    retirements.push_back(std::async(std::launch::async, [retired = std::move(retired)]() mutable {
+        RetiredWordSets destroyedHere = std::move(retired);
+    }));
+    return true;
+}
+
 const std::vector<std::vector<std::string>>& WordDatabaseManager::getAllWordSets() const {
     return wordSets;
 }
@@ -64,22 +287,22 @@ void WordDatabaseManager::setCurrentWordSet(const std::string& setName) {
     if (it != wordSetNames.end()) {
         size_t index = std::distance(wordSetNames.begin(), it);
         if (index < wordSets.size()) {
-            currentWordDatabase = wordSets[index];
+            currentSetIndex = index;
             return;
         }
     }
 
     if (!wordSets.empty()) {
-        currentWordDatabase = wordSets[0];
+        currentSetIndex = 0;
     }
 }
 
 void WordDatabaseManager::setCurrentWordSetByIndex(size_t index) {
     if (index < wordSets.size()) {
-        currentWordDatabase = wordSets[index];
+        currentSetIndex = index;
         fmt::print("WordDatabaseManager: Set current word set to index {}, name: {}\n", index, (index < wordSetNames.size() ? wordSetNames[index] : "N/A"));
     } else if (!wordSets.empty()) {
-        currentWordDatabase = wordSets[0];
+        currentSetIndex = 0;
         fmt::print("WordDatabaseManager: Index {} out of bounds, defaulting to set 0\n", index);
     } else {
         fmt::print("WordDatabaseManager: No word sets loaded, cannot set by index.\n");
@@ -94,7 +317,14 @@ const std::vector<std::string>* WordDatabaseManager::getWordSetByIndexPtr(size_t
     return nullptr;
 }
 
-std::string WordDatabaseManager::getRandomWordFromSet(size_t setIndex) const {
+const std::string& WordDatabaseManager::getRandomWordFromSet(size_t setIndex) const {
+    if (const StreamingWordSource* source = getStreamingSource(setIndex)) {
+        if (source->drawWord(randomGenerator, drawnWord)) {
+            return drawnWord;
+        }
+        // Scanner has not published yet; fall through to the in-memory current set.
+    }
+
     const std::vector<std::string>* selectedSet = getWordSetByIndexPtr(setIndex);
 
     if (selectedSet && !selectedSet->empty()) {
@@ -102,21 +332,60 @@ std::string WordDatabaseManager::getRandomWordFromSet(size_t setIndex) const {
         return (*selectedSet)[dist(randomGenerator)];
     }
 
-    if (!currentWordDatabase.empty()){
-        std::uniform_int_distribution<size_t> dist(0, currentWordDatabase.size() - 1);
-        return currentWordDatabase[dist(randomGenerator)];
+    const std::vector<std::string>& currentWords = getCurrentWordDatabase();
+    if (!currentWords.empty()){
+        std::uniform_int_distribution<size_t> dist(0, currentWords.size() - 1);
+        return currentWords[dist(randomGenerator)];
     }
-    return "error";
+    return noWordDrawn;
 }
 
-std::string WordDatabaseManager::getRandomWord() const {
-    if (currentWordDatabase.empty()) {
-        return "error";
+const std::string& WordDatabaseManager::getRandomWord() const {
+    if (isStreamingSet(currentSetIndex)) {
+        if (streamingSources[currentSetIndex]->drawWord(randomGenerator, drawnWord)) {
+            return drawnWord;
+        }
+    }
+    const std::vector<std::string>& currentWords = getCurrentWordDatabase();
+    if (currentWords.empty()) {
+        return noWordDrawn;
     }
-    std::uniform_int_distribution<size_t> dist(0, currentWordDatabase.size() - 1);
-    return currentWordDatabase[dist(randomGenerator)];
+    std::uniform_int_distribution<size_t> dist(0, currentWords.size() - 1);
+    return currentWords[dist(randomGenerator)];
 }
 
 const std::vector<std::string>& WordDatabaseManager::getCurrentWordDatabase() const {
-    return currentWordDatabase;
-}
\ No newline at end of file
+    static const std::vector<std::string> noWords;
+    return currentSetIndex < wordSets.size() ? wordSets[currentSetIndex] : noWords;
+}
+
+bool WordDatabaseManager::isStreamingSet(size_t setIndex) const {
+    return setIndex < streamingSources.size() && streamingSources[setIndex] != nullptr;
+}
+
+const StreamingWordSource* WordDatabaseManager::getStreamingSource(size_t setIndex) const {
+    return isStreamingSet(setIndex) ? streamingSources[setIndex].get() : nullptr;
+}
+
+const WordSetStats* WordDatabaseManager::getWordSetStats(size_t setIndex) const {
+    if (setIndex >= wordSetStats.size() || isStreamingSet(setIndex)) return nullptr;
+    return &wordSetStats[setIndex];
+}
+
+const std::string& WordDatabaseManager::getGeneratedWordFromSet(size_t setIndex, GameConstants::PseudoWordMode mode) const {
+    static const std::string noWord;
+    if (mode == GameConstants::PseudoWordMode::OFF || !hasGenerator(setIndex)) return noWord;
+    const auto& lengths = GameConstants::PSEUDO_WORD_LENGTHS[static_cast<size_t>(mode)];
+    char buffer[32];
+    size_t length = generators[setIndex]->generate(randomGenerator, lengths[0], std::min(lengths[1], sizeof(buffer)), buffer, sizeof(buffer));
+    drawnWord.assign(buffer, length);
+    return drawnWord;
+}
+
+bool WordDatabaseManager::hasGenerator(size_t setIndex) const {
+    return setIndex < generators.size() && generators[setIndex] != nullptr;
+}
+
+size_t WordDatabaseManager::getCurrentWordSetIndex() const {
+    return currentSetIndex;
+}
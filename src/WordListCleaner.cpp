@@ -0,0 +1,101 @@
+#include "../include/WordListCleaner.h"
+#include <unordered_set>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    constexpr uint64_t ONES = 0x0101010101010101ull;
+    constexpr uint64_t HIGH_BITS = 0x8080808080808080ull;
+
+    // High bit of each byte set where lo <= byte <= hi. Bytes must be ASCII (< 0x80), which
+    // keeps every per-byte sum below 0x100 so no carry crosses into the neighbouring byte.
+    inline uint64_t bytesInRange(uint64_t chunk, unsigned char lo, unsigned char hi) {
+        uint64_t atLeastLo = chunk + (0x80 - lo) * ONES;
+        uint64_t aboveHi = chunk + (0x7F - hi) * ONES;
+        return atLeastLo & ~aboveHi & HIGH_BITS;
+    }
+
+    inline bool isWordChar(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '\'' || c == '-';
+    }
+
+    inline bool isAlnum(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+    }
+}
+
+namespace WordListCleaner {
+
+bool normalizeToken(std::string& token) {
+    size_t begin = 0;
+    size_t end = token.size();
+    while (begin < end && !isAlnum(static_cast<unsigned char>(token[begin])) && static_cast<unsigned char>(token[begin]) < 0x80) ++begin;
+    while (end > begin && !isAlnum(static_cast<unsigned char>(token[end - 1])) && static_cast<unsigned char>(token[end - 1]) < 0x80) --end;
+    if (begin == end) return false;
+    if (begin > 0 || end < token.size()) {
+        token = token.substr(begin, end - begin);
+    }
+
+    char* data = token.data();
+    size_t size = token.size();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, data + i, 8);
+        if (chunk & HIGH_BITS) return false;
+        chunk |= bytesInRange(chunk, 'A', 'Z') >> 2; // 0x80 >> 2 == 0x20, the case bit
+        std::memcpy(data + i, &chunk, 8);
+        if (bytesInRange(chunk, 'a', 'z') != HIGH_BITS) {
+            // Rare: digits, apostrophes, hyphens or junk somewhere in this block.
+            for (size_t k = i; k < i + 8; ++k) {
+                if (!isWordChar(static_cast<unsigned char>(data[k]))) return false;
+            }
+        }
+    }
+    for (; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c >= 'A' && c <= 'Z') c = static_cast<unsigned char>(c | 0x20);
+        if (!isWordChar(c)) return false;
+        data[i] = static_cast<char>(c);
+    }
+    return true;
+}
+
+void cleanWords(std::vector<std::string>& words, WordSetStats& stats) {
+    std::vector<bool> keep(words.size(), false);
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (!normalizeToken(words[i])) {
+            stats.invalidRemoved++;
+        } else if (words[i].size() > GameConstants::MAX_WORD_LENGTH) {
+            stats.tooLongRemoved++;
+        } else {
+            keep[i] = true;
+        }
+    }
+
+    // Views point into 'words', so all duplicates are marked before anything is moved.
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (keep[i] && !seen.insert(words[i]).second) {
+            keep[i] = false;
+            stats.duplicatesRemoved++;
+        }
+    }
+    seen.clear();
+
+    size_t writeIndex = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (!keep[i]) continue;
+        if (writeIndex != i) words[writeIndex] = std::move(words[i]);
+        size_t bucket = std::min(words[writeIndex].size(), stats.lengthHistogram.size()) - 1;
+        stats.lengthHistogram[bucket]++;
+        ++writeIndex;
+    }
+    words.resize(writeIndex);
+    stats.uniqueWords = writeIndex;
+}
+
+}
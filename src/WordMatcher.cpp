@@ -0,0 +1,164 @@
+#include "../include/WordMatcher.h"
+#include "../include/Constants.h"
+#include <deque>
+#include <algorithm>
+
+namespace {
+    constexpr int32_t ROOT = 0;
+}
+
+WordMatcher::WordMatcher() : liveNodes(0), longestText(0), streamStale(false) {
+    nodes.emplace_back();
+}
+
+int32_t WordMatcher::child(int32_t node, char c) const {
+    for (const auto& [edge, target] : nodes[node].children) {
+        if (edge == c) return target;
+    }
+    return -1;
+}
+
+void WordMatcher::addText(const std::string& text) {
+    if (text.empty()) return;
+    int32_t node = ROOT;
+    for (char c : text) {
+        if (nodes[node].liveBelow++ == 0) liveNodes++;
+        int32_t next = child(node, c);
+        if (next < 0) {
+            next = static_cast<int32_t>(nodes.size());
+            nodes.emplace_back();
+            nodes[node].children.emplace_back(c, next);
+        }
+        node = next;
+    }
+    if (nodes[node].liveBelow++ == 0) liveNodes++;
+    if (nodes[node].liveCount++ == 0) {
+        nodes[node].text = text;
+    }
+    longestText = std::max(longestText, text.size());
+    streamStale = true; // A suffix of the stream may now spell a prefix of this text
+}
+
+void WordMatcher::removeText(const std::string& text) {
+    if (text.empty()) return;
+    std::vector<int32_t> path;
+    int32_t node = ROOT;
+    for (char c : text) {
+        path.push_back(node);
+        node = child(node, c);
+        if (node < 0) return;
+    }
+    if (nodes[node].liveCount == 0) return;
+    path.push_back(node);
+    for (int32_t onPath : path) {
+        if (--nodes[onPath].liveBelow == 0) liveNodes--;
+    }
+    // Stream nodes left in a dead branch simply stop advancing.
+    nodes[node].liveCount--;
+}
+
+void WordMatcher::clear() {
+    nodes.clear();
+    nodes.emplace_back();
+    liveNodes = 0;
+    longestText = 0;
+    resetStream();
+}
+
+void WordMatcher::refresh() {
+    if (nodes.size() > 2 * liveNodes + GameConstants::FREE_TYPING_COMPACT_SLACK) {
+        compact();
+    }
+    if (streamStale) rewalkStream();
+}
+
+void WordMatcher::compact() {
+    // Rebuild the trie from live subtrees only. Node ids change, so the stream is rewalked.
+    std::vector<Node> old;
+    old.swap(nodes);
+    nodes.emplace_back();
+    nodes[ROOT].liveBelow = old[ROOT].liveBelow;
+    longestText = 0;
+
+    struct Pending { int32_t oldId; int32_t newId; size_t depth; };
+    std::deque<Pending> queue{{ROOT, ROOT, 0}};
+    while (!queue.empty()) {
+        Pending at = queue.front();
+        queue.pop_front();
+        for (const auto& [edge, oldChild] : old[at.oldId].children) {
+            if (old[oldChild].liveBelow == 0) continue;
+            int32_t newChild = static_cast<int32_t>(nodes.size());
+            nodes.emplace_back();
+            nodes[newChild].liveCount = old[oldChild].liveCount;
+            nodes[newChild].liveBelow = old[oldChild].liveBelow;
+            if (old[oldChild].liveCount > 0) {
+                nodes[newChild].text = std::move(old[oldChild].text);
+                longestText = std::max(longestText, at.depth + 1);
+            }
+            nodes[at.newId].children.emplace_back(edge, newChild);
+            queue.push_back({oldChild, newChild, at.depth + 1});
+        }
+    }
+    liveNodes = nodes[ROOT].liveBelow > 0 ? nodes.size() : 0;
+    streamStale = true;
+}
+
+void WordMatcher::rewalkStream() {
+    // Walk every suffix that could still be inside a text, longest first.
+    active.clear();
+    size_t length = recentInput.size();
+    for (size_t start = length > longestText ? length - longestText : 0; start < length; ++start) {
+        int32_t node = ROOT;
+        for (size_t i = start; i < length && node >= 0; ++i) {
+            node = child(node, recentInput[i]);
+            if (node >= 0 && nodes[node].liveBelow == 0) node = -1;
+        }
+        if (node >= 0) active.push_back(node);
+    }
+    streamStale = false;
+}
+
+const std::vector<const std::string*>& WordMatcher::feed(char c) {
+    refresh(); // Normally already done by the owner after its last change
+    matches.clear();
+
+    // Every suffix grows by 'c', and 'c' alone starts a new one (the shortest, so it goes last).
+    nextActive.clear();
+    for (int32_t node : active) {
+        int32_t next = child(node, c);
+        if (next >= 0 && nodes[next].liveBelow > 0) nextActive.push_back(next);
+    }
+    int32_t start = child(ROOT, c);
+    if (start >= 0 && nodes[start].liveBelow > 0) nextActive.push_back(start);
+    active.swap(nextActive);
+
+    recentInput += c;
+    if (recentInput.size() > GameConstants::FREE_TYPING_HISTORY) {
+        recentInput.erase(0, recentInput.size() - GameConstants::FREE_TYPING_HISTORY / 2);
+    }
+
+    for (int32_t node : active) {
+        if (nodes[node].liveCount > 0) matches.push_back(&nodes[node].text);
+    }
+    return matches;
+}
+
+void WordMatcher::unfeed() {
+    if (recentInput.empty()) return;
+    recentInput.pop_back();
+    rewalkStream();
+}
+
+void WordMatcher::resetStream() {
+    recentInput.clear();
+    active.clear();
+    streamStale = false;
+}
+
+bool WordMatcher::isStreamInText() const {
+    return std::any_of(active.begin(), active.end(), [this](int32_t node) { return nodes[node].liveBelow > 0; });
+}
+
+const std::string& WordMatcher::getRecentInput() const {
+    return recentInput;
+}
@@ -0,0 +1,59 @@
+#include "../include/WordPool.h"
+#include <algorithm>
+#include <iterator>
+
+void WordRecycler::operator()(Word* word) const noexcept {
+    if (pool) {
+        pool->release(word);
+    } else {
+        delete word;
+    }
+}
+
+PooledWord WordPool::acquireWord(const std::string& text, const sf::Font& font, float speed,
+                                 const sf::Vector2f& position, unsigned int fontSize) {
+    if (idleWords.empty()) {
+        idleWords.reserve(createdWords + 1); // Room for this word to come back
+        PooledWord word(new Word(text, font, speed, position, fontSize), WordRecycler{this});
+        createdWords++;
+        return word;
+    }
+    Word* word = idleWords.back().release();
+    idleWords.pop_back();
+    word->reset(text, font, speed, position, fontSize);
+    reusedCount++;
+    return PooledWord(word, WordRecycler{this});
+}
+
+PooledWord WordPool::acquireLinkedWord(const std::vector<std::string>& parts, const sf::Font& font, float speed,
+                                       const sf::Vector2f& position, unsigned int fontSize,
+                                       const std::vector<float>& yPositions) {
+    // Most recently released first; idle linked words number a handful.
+    auto idle = std::find_if(idleLinkedWords.rbegin(), idleLinkedWords.rend(), [&parts](const std::unique_ptr<LinkedWord>& candidate) {
+        return candidate->getPartCount() == parts.size();
+    });
+    if (idle == idleLinkedWords.rend()) {
+        idleLinkedWords.reserve(createdLinkedWords + 1);
+        PooledWord word(new LinkedWord(parts, font, speed, position, fontSize, yPositions), WordRecycler{this});
+        createdLinkedWords++;
+        return word;
+    }
+    LinkedWord* word = idle->release();
+    idleLinkedWords.erase(std::next(idle).base());
+    word->reset(parts, font, speed, position, fontSize, yPositions);
+    reusedCount++;
+    return PooledWord(word, WordRecycler{this});
+}
+
+void WordPool::release(Word* word) noexcept {
+    if (!word) return;
+    if (word->isLinked()) {
+        idleLinkedWords.emplace_back(static_cast<LinkedWord*>(word));
+    } else {
+        idleWords.emplace_back(word);
+    }
+}
+
+size_t WordPool::getCreatedCount() const { return createdWords + createdLinkedWords; }
+size_t WordPool::getReusedCount() const { return reusedCount; }
+size_t WordPool::getIdleCount() const { return idleWords.size() + idleLinkedWords.size(); }
@@ -1,7 +1,102 @@
 #include "../include/MonkeyTyperGame.h"
+#include "../include/RunExporter.h"
+#include "../include/HeadlessGame.h"
+#include "../include/HighScoreManager.h"
+#include "../include/PersistenceWorker.h"
+#include "../include/WordDatabaseManager.h"
+#include "../include/AllocationCounter.h"
+#include <fmt/core.h>
+#include <filesystem>
+#include <random>
+#include <string>
 
-int main() {
-    MonkeyTyperGame game;
+// Plays 'games' bot games headlessly and records them in a separate archive under util/soak/,
+// ranking qualifying runs under the bot's name. Targeting strategies take turns.
+static int runSoak(unsigned long games) {
+    WordDatabaseManager wordDb;
+    wordDb.loadWordSets("../dictionary");
+    std::vector<std::string> setNames = wordDb.getWordSetNames();
+    size_t setIndex = wordDb.getCurrentWordSetIndex();
+    std::string setName = setIndex < setNames.size() ? setNames[setIndex] : "Default";
+    HeadlessGame::WordSupply supply;
+    if (!HeadlessGame::WordSupply::forWordSet(wordDb, setIndex, supply)) return 1;
+
+    std::error_code ec;
+    std::filesystem::create_directories("../util/soak", ec);
+    PersistenceWorker persistence;
+    HighScoreManager scores(persistence);
+    scores.loadHighScores("../util/soak/runs.log", "../util/soak/runs.idx", "");
+
+    const char* strategyNames[] = {"NearestEscape", "Oldest", "Shortest", "Random"};
+    HeadlessGame game(supply, setName, std::random_device{}());
+    GameSession::Settings settings;
+    double scoreSum = 0;
+    double timeSum = 0;
+    double wpmSum = 0;
+    size_t ranked = 0;
+    uint64_t steadyStateAllocations = 0;
+    for (unsigned long i = 0; i < games; ++i) {
+        TypistBot::Profile profile;
+        profile.targeting = static_cast<TypistBot::Targeting>(i % 4);
+        RunRecord run = game.play(settings, profile, GameConstants::SOAK_MAX_GAME_SECONDS);
+        uint64_t runId = scores.recordRun(run);
+        if (run.score > 0 && scores.qualifies(run.config, run.score) &&
+            scores.addHighScore(runId, fmt::format("Bot {}", strategyNames[i % 4]), run.score, run.config) != Leaderboard::NOT_RANKED) {
+            ranked++;
+        }
+        scoreSum += run.score;
+        timeSum += run.gameTime;
+        wpmSum += run.stats.wordsPerMinute;
+        steadyStateAllocations += game.getSession().getSteadyStateSpawnAllocations();
+    }
+    persistence.flush();
+
+    const HeadlessGame::StepTimings& timings = game.getStepTimings();
+    double n = games > 0 ? static_cast<double>(games) : 1.0;
+    fmt::print("Soak: {} games on '{}': mean score {:.1f}, mean survival {:.1f}s, mean WPM {:.1f}; {} ranked.\n",
+               games, setName, scoreSum / n, timeSum / n, wpmSum / n, ranked);
+    fmt::print("Soak: {} steps, {:.2f} us mean, {:.2f} us max.\n", timings.steps,
+               timings.steps ? timings.totalNanos / 1000.0 / timings.steps : 0.0, timings.maxNanos / 1000.0);
+    if (AllocationCounter::isEnabled() && steadyStateAllocations > 0) {
+        fmt::print(stderr, "Soak: FAILED: {} heap allocations in spawns served from the word pool (expected 0).\n",
+                   steadyStateAllocations);
+        return 1;
+    }
+    return 0;
+}
+
+static bool isCount(const std::string& arg) {
+    return !arg.empty() && arg.size() <= 9 && arg.find_first_not_of("0123456789") == std::string::npos;
+}
+
+int main(int argc, char* argv[]) {
+    std::string profile;
+    std::string exportPath;
+    unsigned long soakGames = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile" && i + 1 < argc && std::string(argv[i + 1]).find_first_of("/\\.") == std::string::npos) {
+            profile = argv[++i];
+        } else if (arg == "--export" && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (arg == "--soak" && i + 1 < argc && isCount(argv[i + 1])) {
+            soakGames = std::stoul(argv[++i]);
+        } else {
+            fmt::print(stderr, "Usage: {} [--profile NAME] [--export FILE.csv|FILE.jsonl] [--soak GAMES]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!exportPath.empty()) {
+        // Runs without opening a window, so it also works on headless machines.
+        RunExporter exporter("../util/runs.log", "../util/runs.idx", "../util/keystrokes.bin");
+        return exporter.exportTo(exportPath, RunExporter::formatForPath(exportPath)) ? 0 : 1;
+    }
+    if (soakGames > 0) {
+        return runSoak(soakGames); // Headless as well
+    }
+
+    MonkeyTyperGame game(profile);
     game.run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,197 @@
+#include "../include/BatchSimulator.h"
+#include "../include/WordDatabaseManager.h"
+#include "../include/AllocationCounter.h"
+#include <fmt/core.h>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// monkey_typer_sim: sweeps word speed x spawn rate x linked words with bot games on every core
+// and prints (or writes as CSV) the score, survival time and WPM distribution of each configuration.
+
+namespace {
+    bool parseValue(std::string_view text, float& out) {
+        std::string buffer(text);
+        char* end = nullptr;
+        float value = std::strtof(buffer.c_str(), &end);
+        if (buffer.empty() || *end != '\0') return false;
+        out = value;
+        return true;
+    }
+
+    template <typename T>
+    bool parseValue(std::string_view text, T& out) {
+        T value;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) return false;
+        out = value;
+        return true;
+    }
+
+    // Comma-separated positive values, e.g. "0.5,1,1.5".
+    bool parseList(std::string_view text, std::vector<float>& out) {
+        out.clear();
+        while (!text.empty()) {
+            size_t comma = text.find(',');
+            float value;
+            if (!parseValue(text.substr(0, comma), value) || value <= 0.f) return false;
+            out.push_back(value);
+            text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+        }
+        return !out.empty();
+    }
+
+    bool parseTargeting(std::string_view text, TypistBot::Targeting& out) {
+        if (text == "nearest") out = TypistBot::Targeting::NEAREST_ESCAPE;
+        else if (text == "oldest") out = TypistBot::Targeting::OLDEST;
+        else if (text == "shortest") out = TypistBot::Targeting::SHORTEST;
+        else if (text == "random") out = TypistBot::Targeting::RANDOM;
+        else return false;
+        return true;
+    }
+
+    void printUsage(const char* program) {
+        fmt::print(stderr,
+                   "Usage: {} [--games N] [--threads N] [--seed N] [--speeds LIST] [--spawn-rates LIST]\n"
+                   "       [--linked off|on|both] [--free-typing] [--max-seconds S] [--bot-wpm W] [--bot-errors RATE]\n"
+                   "       [--bot-reaction S] [--bot-targeting nearest|oldest|shortest|random] [--csv FILE]\n"
+                   "LIST is comma-separated multipliers, e.g. 0.5,1,1.5.\n",
+                   program);
+    }
+
+    bool writeCsv(const std::string& path, const std::vector<BatchSimulator::ConfigResult>& results) {
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            fmt::print(stderr, "Error: Could not open '{}' for writing.\n", path);
+            return false;
+        }
+        fmt::print(out, "word_speed,spawn_rate,linked_words,free_typing,games,capped");
+        for (const char* measure : {"score", "survival_s", "wpm"}) {
+            for (const char* stat : {"mean", "stddev", "min", "p10", "p50", "p90", "max"}) {
+                fmt::print(out, ",{}_{}", measure, stat);
+            }
+        }
+        fmt::print(out, "\n");
+        for (const auto& result : results) {
+            fmt::print(out, "{},{},{},{},{},{}", result.settings.wordSpeedMultiplier, result.settings.spawnRateMultiplier,
+                      result.settings.linkedWords ? 1 : 0, result.settings.freeTyping ? 1 : 0, result.games, result.capped);
+            for (const auto* distribution : {&result.score, &result.survivalSeconds, &result.wordsPerMinute}) {
+                fmt::print(out, ",{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}", distribution->mean, distribution->stddev,
+                          distribution->min, distribution->p10, distribution->p50, distribution->p90, distribution->max);
+            }
+            fmt::print(out, "\n");
+        }
+        bool written = std::ferror(out) == 0;
+        written = std::fclose(out) == 0 && written;
+        if (!written) {
+            fmt::print(stderr, "Error: Could not write '{}'.\n", path);
+        }
+        return written;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t gamesPerConfig = GameConstants::SIM_GAMES_PER_CONFIG;
+    size_t threadCount = 0;
+    uint32_t seed = std::random_device{}();
+    std::vector<float> speeds = {0.5f, 0.75f, 1.0f, 1.25f, 1.5f, 2.0f};
+    std::vector<float> spawnRates = {0.5f, 1.0f, 1.5f, 2.0f};
+    std::vector<bool> linkedOptions = {false, true};
+    bool freeTyping = false;
+    float maxSeconds = GameConstants::SOAK_MAX_GAME_SECONDS;
+    TypistBot::Profile profile;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        std::string_view value = hasValue ? std::string_view(argv[i + 1]) : std::string_view();
+        bool ok = hasValue;
+        if (arg == "--games") ok = ok && parseValue(value, gamesPerConfig) && gamesPerConfig > 0;
+        else if (arg == "--threads") ok = ok && parseValue(value, threadCount);
+        else if (arg == "--seed") ok = ok && parseValue(value, seed);
+        else if (arg == "--speeds") ok = ok && parseList(value, speeds);
+        else if (arg == "--spawn-rates") ok = ok && parseList(value, spawnRates);
+        else if (arg == "--linked") {
+            if (value == "off") linkedOptions = {false};
+            else if (value == "on") linkedOptions = {true};
+            else if (value == "both") linkedOptions = {false, true};
+            else ok = false;
+        }
+        else if (arg == "--max-seconds") ok = ok && parseValue(value, maxSeconds) && maxSeconds > 0.f;
+        else if (arg == "--bot-wpm") ok = ok && parseValue(value, profile.wordsPerMinute) && profile.wordsPerMinute > 0.f;
+        else if (arg == "--bot-errors") ok = ok && parseValue(value, profile.errorRate);
+        else if (arg == "--bot-reaction") ok = ok && parseValue(value, profile.reactionTime);
+        else if (arg == "--bot-targeting") ok = ok && parseTargeting(value, profile.targeting);
+        else if (arg == "--csv") csvPath = value;
+        else if (arg == "--free-typing") {
+            freeTyping = true;
+            continue; // Takes no value
+        }
+        else ok = false;
+        if (!ok) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        ++i;
+    }
+
+    WordDatabaseManager wordDb;
+    wordDb.loadWordSets("../dictionary");
+    std::vector<std::string> setNames = wordDb.getWordSetNames();
+    size_t setIndex = wordDb.getCurrentWordSetIndex();
+    std::string setName = setIndex < setNames.size() ? setNames[setIndex] : "Default";
+    HeadlessGame::WordSupply supply;
+    if (!HeadlessGame::WordSupply::forWordSet(wordDb, setIndex, supply)) return 1;
+
+    std::vector<GameSession::Settings> configs;
+    for (float speed : speeds) {
+        for (float spawnRate : spawnRates) {
+            for (bool linked : linkedOptions) {
+                GameSession::Settings settings;
+                settings.wordSpeedMultiplier = speed;
+                settings.spawnRateMultiplier = spawnRate;
+                settings.linkedWords = linked;
+                settings.freeTyping = freeTyping;
+                configs.push_back(settings);
+            }
+        }
+    }
+
+    WorkStealingPool pool(threadCount);
+    BatchSimulator simulator(supply, setName, pool);
+    fmt::print("Simulating {} games on {} threads: {} configurations x {} games, word set '{}', seed {}.\n",
+               configs.size() * gamesPerConfig, pool.getThreadCount(), configs.size(), gamesPerConfig, setName, seed);
+    auto started = std::chrono::steady_clock::now();
+    std::vector<BatchSimulator::ConfigResult> results = simulator.run(configs, profile, gamesPerConfig, seed, maxSeconds);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    fmt::print("{:>6} {:>6} {:>6} | {:>8} {:>8} {:>8} {:>8} | {:>8} {:>8} {:>8} | {:>6} {:>6} | {:>6}\n",
+               "speed", "spawn", "linked", "score", "p10", "p50", "p90", "surv s", "p50", "p90", "wpm", "p50", "capped");
+    for (const auto& result : results) {
+        fmt::print("{:>6.2f} {:>6.2f} {:>6} | {:>8.1f} {:>8.0f} {:>8.0f} {:>8.0f} | {:>8.1f} {:>8.1f} {:>8.1f} | {:>6.1f} {:>6.1f} | {:>6}\n",
+                   result.settings.wordSpeedMultiplier, result.settings.spawnRateMultiplier, result.settings.linkedWords ? "on" : "off",
+                   result.score.mean, result.score.p10, result.score.p50, result.score.p90,
+                   result.survivalSeconds.mean, result.survivalSeconds.p50, result.survivalSeconds.p90,
+                   result.wordsPerMinute.mean, result.wordsPerMinute.p50, result.capped);
+    }
+    uint64_t steps = simulator.getSimulatedSteps();
+    fmt::print("{:.1f}s: {:.0f} games/s, {:.0f} simulated frames/s; {} games stolen between threads.\n",
+               seconds, configs.size() * gamesPerConfig / seconds, steps / seconds, pool.getStolenCount());
+
+    if (!csvPath.empty()) {
+        if (!writeCsv(csvPath, results)) return 1;
+        fmt::print("Wrote {}.\n", csvPath);
+    }
+    if (AllocationCounter::isEnabled() && simulator.getSteadyStateSpawnAllocations() > 0) {
+        fmt::print(stderr, "FAILED: {} heap allocations in spawns served from the word pool (expected 0).\n",
+                   simulator.getSteadyStateSpawnAllocations());
+        return 1;
+    }
+    return 0;
+}